@@ -0,0 +1,404 @@
+#include "HighlightItem.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Ordre des points d'une courbe dont les instants ne sont pas tries
+    struct EarlierThan
+    {
+        explicit EarlierThan(const QVector<float>& times) :
+            times(times)
+        {
+        }
+
+        bool operator()(int a, int b) const
+        {
+            return this->times.at(a) < this->times.at(b);
+        }
+
+        const QVector<float>& times;
+    };
+}
+
+HighlightItem::HighlightItem(QGraphicsItem* parent) :
+    QGraphicsItem(parent), _markCount(0), _cursorVisible(false)
+{
+    this->setZValue(2); // au-dessus des traces et des courbes
+}
+
+void HighlightItem::addCurve(const QVariant& id, const QVector<float>& times,
+                             const QVector<QPointF>& positions,
+                             const QColor& color)
+{
+    Curve curve;
+    curve.id = id;
+    curve.times = times;
+    curve.positions = positions;
+    curve.color = color;
+
+    int size = qMin(times.size(), positions.size());
+    curve.times.resize(size);
+    curve.positions.resize(size);
+
+    bool sorted(true);
+    for (int i(1); sorted && i < size; ++i)
+        sorted = times.at(i - 1) <= times.at(i);
+
+    // Recherche par dichotomie : les points sont ranges par instant
+    if (!sorted)
+    {
+        QVector<int> order(size);
+        for (int i(0); i < size; ++i)
+            order[i] = i;
+
+        std::stable_sort(order.begin(), order.end(), EarlierThan(times));
+
+        for (int i(0); i < size; ++i)
+        {
+            curve.times[i] = times.at(order.at(i));
+            curve.positions[i] = positions.at(order.at(i));
+        }
+    }
+
+    curve.bounds = QPolygonF(curve.positions).boundingRect();
+    curve.cursor = size > 0 ? curve.positions.first() : QPointF();
+    this->_curves << curve;
+    this->updateBounds();
+}
+
+bool HighlightItem::removeCurve(const QVariant& id)
+{
+    int c = this->curveOf(id);
+    if (c < 0)
+        return false;
+
+    // Les marques de la courbe disparaissent, les autres sont renumerotees
+    int kept(0);
+    for (int m(0); m < this->_markCount; ++m)
+    {
+        Mark mark = this->_marks.at(m);
+        if (mark.curve == c)
+            continue;
+
+        if (mark.curve > c)
+            mark.curve--;
+
+        this->_marks[kept++] = mark;
+    }
+
+    this->_markCount = kept;
+    this->_curves.removeAt(c);
+    this->updateBounds();
+
+    return true;
+}
+
+void HighlightItem::clearCurves(void)
+{
+    this->_markCount = 0;
+    this->_cursorVisible = false;
+    this->_curves.clear();
+    this->updateBounds();
+}
+
+int HighlightItem::curveCount(void) const
+{
+    return this->_curves.count();
+}
+
+bool HighlightItem::highlightPoint(const QVariant& id, float time)
+{
+    int c = this->curveOf(id);
+    if (c < 0)
+        return false;
+
+    const QVector<float>& times = this->_curves.at(c).times;
+    int i = qLowerBound(times.constBegin(), times.constEnd(), time)
+            - times.constBegin();
+
+    if (i == times.size())
+        return false;
+
+    this->addMark(c, i, i);
+    return true;
+}
+
+bool HighlightItem::highlightRange(const QVariant& id, float t1, float t2)
+{
+    int c = this->curveOf(id);
+    if (c < 0)
+        return false;
+
+    const QVector<float>& times = this->_curves.at(c).times;
+    if (times.isEmpty())
+        return false;
+
+    float lower = qMin(t1, t2);
+    float upper = qMax(t1, t2);
+
+    int first = qLowerBound(times.constBegin(), times.constEnd(), lower)
+                - times.constBegin();
+    int last  = qUpperBound(times.constBegin(), times.constEnd(), upper)
+                - times.constBegin() - 1;
+
+    // Intervalle plus court que l'echantillonnage : points qui l'encadrent
+    if (first > last)
+    {
+        if (lower < times.first() || lower > times.last())
+            return false;
+
+        last = first;
+        first = qMax(0, first - 1);
+    }
+
+    this->addMark(c, first, last);
+    return true;
+}
+
+void HighlightItem::clearHighlights(void)
+{
+    if (this->_markCount == 0)
+        return;
+
+    // La capacite est gardee pour les prochaines marques
+    this->_markCount = 0;
+    this->updateMargin();
+    this->update();
+}
+
+int HighlightItem::highlightCount(void) const
+{
+    return this->_markCount;
+}
+
+void HighlightItem::setCursorTime(float time)
+{
+    this->updateMargin();
+    QSizeF radius = this->_margin;
+
+    for (int c(0); c < this->_curves.count(); ++c)
+    {
+        Curve& curve = this->_curves[c];
+        if (curve.times.isEmpty())
+            continue;
+
+        QPointF position = this->positionAt(curve, curve.times.first() + time);
+        if (this->_cursorVisible && position == curve.cursor)
+            continue;
+
+        // Seules l'ancienne et la nouvelle zone du curseur sont redessinees
+        if (this->_cursorVisible)
+            this->updateCursor(curve.cursor, radius);
+
+        curve.cursor = position;
+        this->updateCursor(curve.cursor, radius);
+    }
+
+    this->_cursorVisible = true;
+}
+
+void HighlightItem::hideCursors(void)
+{
+    if (!this->_cursorVisible)
+        return;
+
+    this->updateMargin();
+    QSizeF radius = this->_margin;
+
+    foreach (const Curve& curve, this->_curves)
+        if (!curve.times.isEmpty())
+            this->updateCursor(curve.cursor, radius);
+
+    this->_cursorVisible = false;
+}
+
+bool HighlightItem::cursorsVisible(void) const
+{
+    return this->_cursorVisible;
+}
+
+float HighlightItem::duration(void) const
+{
+    float duration(0);
+
+    foreach (const Curve& curve, this->_curves)
+        if (!curve.times.isEmpty())
+            duration = qMax(duration, curve.times.last() - curve.times.first());
+
+    return duration;
+}
+
+QRectF HighlightItem::boundingRect(void) const
+{
+    if (this->_bounds.isNull())
+        return QRectF();
+
+    return this->_bounds.adjusted(-this->_margin.width(), -this->_margin.height(),
+                                  this->_margin.width(), this->_margin.height());
+}
+
+void HighlightItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*,
+                          QWidget*)
+{
+    QPen pen;
+    pen.setCosmetic(true);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+
+    for (int m(0); m < this->_markCount; ++m)
+    {
+        const Mark& mark = this->_marks.at(m);
+        const Curve& curve = this->_curves.at(mark.curve);
+        const QPointF* positions = curve.positions.constData();
+
+        if (mark.first == mark.last)
+        {
+            // Point rond : trait d'un seul point a bouts arrondis
+            pen.setWidth(HIGHLIGHT_POINT_SIZE);
+            pen.setColor(curve.color);
+            painter->setPen(pen);
+            painter->drawPoint(positions[mark.first]);
+        }
+        else
+        {
+            QColor color(curve.color);
+            color.setAlpha(160);
+
+            pen.setWidth(HIGHLIGHT_RANGE_WIDTH);
+            pen.setColor(color);
+            painter->setPen(pen);
+            painter->drawPolyline(positions + mark.first,
+                                  mark.last - mark.first + 1);
+        }
+    }
+
+    if (!this->_cursorVisible)
+        return;
+
+    // Curseur : disque de la couleur de la courbe cerne de blanc
+    foreach (const Curve& curve, this->_curves)
+    {
+        if (curve.times.isEmpty())
+            continue;
+
+        pen.setWidth(HIGHLIGHT_CURSOR_SIZE);
+        pen.setColor(Qt::white);
+        painter->setPen(pen);
+        painter->drawPoint(curve.cursor);
+
+        pen.setWidth(HIGHLIGHT_CURSOR_SIZE - 4);
+        pen.setColor(curve.color);
+        painter->setPen(pen);
+        painter->drawPoint(curve.cursor);
+    }
+}
+
+int HighlightItem::curveOf(const QVariant& id) const
+{
+    for (int c(0); c < this->_curves.count(); ++c)
+        if (this->_curves.at(c).id == id)
+            return c;
+
+    return -1;
+}
+
+void HighlightItem::addMark(int curve, int first, int last)
+{
+    Mark mark;
+    mark.curve = curve;
+    mark.first = first;
+    mark.last = last;
+
+    if (this->_markCount < this->_marks.size())
+        this->_marks[this->_markCount] = mark;
+    else
+        this->_marks.append(mark);
+
+    this->_markCount++;
+    this->updateMargin();
+    this->update();
+}
+
+void HighlightItem::updateBounds(void)
+{
+    QRectF bounds;
+
+    foreach (const Curve& curve, this->_curves)
+        bounds = bounds.isNull() ? curve.bounds : bounds.united(curve.bounds);
+
+    this->prepareGeometryChange();
+    this->_bounds = bounds;
+    this->_margin = this->cursorRadius();
+}
+
+void HighlightItem::updateMargin(void)
+{
+    /* Appele avant chaque mise a jour : apres un zoom, la marge suit
+     * l'echelle des vues avant que la zone a redessiner soit calculee */
+    QSizeF margin = this->cursorRadius();
+
+    if (margin == this->_margin)
+        return;
+
+    this->prepareGeometryChange();
+    this->_margin = margin;
+}
+
+QPointF HighlightItem::positionAt(const Curve& curve, float time) const
+{
+    const QVector<float>& times = curve.times;
+    const QVector<QPointF>& positions = curve.positions;
+
+    // Avant le depart ou apres l'arrivee, le curseur attend au bout du trace
+    if (time <= times.first())
+        return positions.first();
+    if (time >= times.last())
+        return positions.last();
+
+    int i = qLowerBound(times.constBegin(), times.constEnd(), time)
+            - times.constBegin();
+
+    float before = times.at(i - 1);
+    float after = times.at(i);
+    qreal ratio = after > before ? (time - before) / (after - before) : 1;
+
+    return positions.at(i - 1) + (positions.at(i) - positions.at(i - 1)) * ratio;
+}
+
+QSizeF HighlightItem::cursorRadius(void) const
+{
+    if (this->scene() == NULL)
+        return QSizeF();
+
+    /* Taille du curseur dans la scene pour chaque vue : les echelles
+     * horizontale et verticale des graphiques sont differentes */
+    qreal pixels = HIGHLIGHT_CURSOR_SIZE / 2 + 2;
+    QSizeF radius;
+
+    foreach (QGraphicsView* view, this->scene()->views())
+    {
+        QTransform transform = view->viewportTransform();
+
+        if (qFuzzyIsNull(transform.m11()) || qFuzzyIsNull(transform.m22()))
+            return QSizeF();
+
+        radius = radius.expandedTo(QSizeF(pixels / qAbs(transform.m11()),
+                                          pixels / qAbs(transform.m22())));
+    }
+
+    return radius;
+}
+
+void HighlightItem::updateCursor(const QPointF& position, const QSizeF& radius)
+{
+    // Sans echelle connue (aucune vue), tout l'item est redessine
+    if (radius.isEmpty())
+    {
+        this->update();
+        return;
+    }
+
+    this->update(QRectF(position.x() - radius.width(),
+                        position.y() - radius.height(),
+                        2 * radius.width(), 2 * radius.height()));
+}
@@ -0,0 +1,105 @@
+#ifndef __HIGHLIGHTITEM_HPP__
+#define __HIGHLIGHTITEM_HPP__
+
+#include <QtGui>
+
+// Epaisseur du trait d'un intervalle mis en evidence (pixels)
+#define HIGHLIGHT_RANGE_WIDTH 6
+// Diametre d'un point mis en evidence (pixels)
+#define HIGHLIGHT_POINT_SIZE 9
+// Diametre du curseur de relecture (pixels)
+#define HIGHLIGHT_CURSOR_SIZE 13
+
+/* Mises en evidence d'une vue (carte ou graphique) dans un seul item.
+ *
+ * Chaque courbe de la vue y est enregistree une fois avec ses instants
+ * (tries) et ses positions dans la scene ; les tableaux sont partages avec
+ * l'appelant. Mettre en evidence un instant ou un intervalle revient a
+ * chercher ses indices par dichotomie et a les ajouter a la liste des
+ * marques : aucun item n'est cree, seule la zone de l'item est redessinee.
+ * La liste des marques garde sa capacite quand elle est videe.
+ *
+ * Le curseur de relecture (LapReplay) place un point sur chaque courbe,
+ * interpole entre les deux points qui encadrent l'instant. Les courbes sont
+ * relues depuis leur premier point. Deplacer les curseurs ne redessine que
+ * leur ancienne et leur nouvelle zone, calculees avec l'echelle des vues.
+ *
+ * Les marques ont une taille en pixels : la zone de l'item deborde des
+ * courbes du rayon du curseur (la plus grande marque) a l'echelle courante
+ * des vues, pour que leurs bords soient effaces avec elles.
+ *
+ *     highlight->addCurve(trackId, times, positions, Qt::red);
+ *     highlight->highlightRange(trackId, t1, t2);
+ *     highlight->clearHighlights();
+ *     highlight->setCursorTime(12.5);
+ */
+class HighlightItem : public QGraphicsItem
+{
+    public:
+
+        explicit HighlightItem(QGraphicsItem* parent = 0);
+
+        void addCurve(const QVariant& id, const QVector<float>& times,
+                      const QVector<QPointF>& positions, const QColor& color);
+        bool removeCurve(const QVariant& id);
+        void clearCurves(void);
+        int curveCount(void) const;
+
+        // Premier point a partir de time
+        bool highlightPoint(const QVariant& id, float time);
+        // Points entre t1 et t2, ou les deux qui encadrent un intervalle court
+        bool highlightRange(const QVariant& id, float t1, float t2);
+        void clearHighlights(void);
+        int highlightCount(void) const;
+
+        // Curseurs a time secondes du premier point de chaque courbe
+        void setCursorTime(float time);
+        void hideCursors(void);
+        bool cursorsVisible(void) const;
+        float duration(void) const; // duree de la courbe la plus longue
+
+        virtual QRectF boundingRect(void) const;
+        virtual void paint(QPainter* painter,
+                           const QStyleOptionGraphicsItem* option,
+                           QWidget* widget);
+
+        enum { Type = UserType + 6 };
+        int type() const { return Type; }
+
+    protected:
+
+        struct Curve
+        {
+            QVariant id;
+            QVector<float> times;
+            QVector<QPointF> positions;
+            QColor color;
+            QRectF bounds;
+            QPointF cursor;
+        };
+
+        // Indices du premier et du dernier point d'une courbe
+        struct Mark
+        {
+            int curve;
+            int first;
+            int last;
+        };
+
+        int curveOf(const QVariant& id) const;
+        void addMark(int curve, int first, int last);
+        void updateBounds(void);
+        void updateMargin(void);
+        QPointF positionAt(const Curve& curve, float time) const;
+        QSizeF cursorRadius(void) const;
+        void updateCursor(const QPointF& position, const QSizeF& radius);
+
+        QList<Curve> _curves;
+        QVector<Mark> _marks;
+        int _markCount;
+        bool _cursorVisible;
+        QRectF _bounds; // etendue des courbes
+        QSizeF _margin; // rayon des marques dans la scene
+};
+
+#endif /* __HIGHLIGHTITEM_HPP__ */
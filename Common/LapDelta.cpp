@@ -0,0 +1,62 @@
+#include "LapDelta.hpp"
+
+LapDelta::LapDelta(void)
+{
+}
+
+void LapDelta::setReference(const TelemetrySeries& reference)
+{
+    // Colonnes partagees avec la serie de reference
+    this->_distances = reference.xs();
+    this->_times = reference.times();
+}
+
+bool LapDelta::hasReference(void) const
+{
+    return !this->_distances.isEmpty();
+}
+
+void LapDelta::clear(void)
+{
+    this->_distances.clear();
+    this->_times.clear();
+}
+
+TelemetrySeries LapDelta::delta(const TelemetrySeries& lap) const
+{
+    TelemetrySeriesBuilder builder;
+
+    if (!this->hasReference() || lap.isEmpty())
+        return builder.take();
+
+    // Seule la partie du tour couverte par la reference est comparable
+    qreal first = this->_distances.first();
+    qreal last  = this->_distances.last();
+
+    const qreal* xs = lap.xData();
+    const qreal* times = lap.timeData();
+    QVector<qreal> distances;
+    QVector<qreal> lapTimes;
+    distances.reserve(lap.size());
+    lapTimes.reserve(lap.size());
+
+    for (int i(0); i < lap.size(); ++i)
+    {
+        if (xs[i] < first || xs[i] > last)
+            continue;
+
+        distances << xs[i];
+        lapTimes << times[i];
+    }
+
+    QVector<qreal> referenceTimes = LapResampler::interpolate(
+                this->_distances, this->_times, distances);
+
+    builder.reserve(distances.size());
+
+    for (int i(0); i < distances.size(); ++i)
+        builder.append(lapTimes.at(i), distances.at(i),
+                       lapTimes.at(i) - referenceTimes.at(i), lapTimes.at(i));
+
+    return builder.take();
+}
@@ -0,0 +1,40 @@
+#ifndef __LAPDELTA_HPP__
+#define __LAPDELTA_HPP__
+
+#include "LapResampler.hpp"
+#include "TelemetrySeries.hpp"
+#include <QtCore>
+
+/* Ecart de temps cumule d'un tour par rapport a un tour de reference, en
+ * fonction de la distance parcourue.
+ *
+ * Les series sont celles de la vitesse en fonction de la distance
+ * (x = distance, time = instant de la mesure). Pour chaque echantillon du
+ * tour, le temps mis par la reference pour atteindre la meme distance est
+ * interpole puis soustrait : delta() est lineaire en la taille des deux
+ * tours, le tour de reference n'est lu qu'une fois par setReference().
+ *
+ *     time  : instant de la mesure dans le tour (s)
+ *     x     : distance (m)
+ *     y     : ecart avec la reference (s), positif si le tour est en retard
+ *     index : instant de la mesure dans le tour (s)
+ */
+class LapDelta
+{
+    public:
+
+        LapDelta(void);
+
+        void setReference(const TelemetrySeries& reference);
+        bool hasReference(void) const;
+        void clear(void);
+
+        TelemetrySeries delta(const TelemetrySeries& lap) const;
+
+    protected:
+
+        QVector<qreal> _distances;
+        QVector<qreal> _times;
+};
+
+#endif /* __LAPDELTA_HPP__ */
@@ -0,0 +1,130 @@
+#include "LapReplay.hpp"
+
+LapReplay::LapReplay(QObject* parent) :
+    QObject(parent), _duration(0), _speed(1), _time(0)
+{
+    // Temps de la relecture proportionnel au temps reel
+    this->_timeLine.setEasingCurve(QEasingCurve::Linear);
+    this->_timeLine.setUpdateInterval(LAP_REPLAY_FRAME_INTERVAL);
+
+    connect(&this->_timeLine, SIGNAL(valueChanged(qreal)),
+            this, SLOT(updateTime()));
+    connect(&this->_timeLine, SIGNAL(stateChanged(QTimeLine::State)),
+            this, SLOT(updateState(QTimeLine::State)));
+}
+
+float LapReplay::duration(void) const
+{
+    return this->_duration;
+}
+
+void LapReplay::setDuration(float duration)
+{
+    this->_duration = qMax(0.0f, duration);
+    this->_time = qMin(this->_time, this->_duration);
+    this->updateTimeLine();
+}
+
+qreal LapReplay::speed(void) const
+{
+    return this->_speed;
+}
+
+float LapReplay::time(void) const
+{
+    return this->_time;
+}
+
+bool LapReplay::isRunning(void) const
+{
+    return this->_timeLine.state() == QTimeLine::Running;
+}
+
+void LapReplay::start(void)
+{
+    if (this->_duration <= 0 || this->isRunning())
+        return;
+
+    // Relecture terminee : on repart du depart
+    if (this->_time >= this->_duration)
+    {
+        this->_time = 0;
+        this->updateTimeLine();
+    }
+
+    this->_timeLine.resume();
+}
+
+void LapReplay::pause(void)
+{
+    // L'instant courant est garde par la QTimeLine
+    if (this->isRunning())
+        this->_timeLine.stop();
+}
+
+void LapReplay::stop(void)
+{
+    this->_timeLine.stop();
+    this->_time = 0;
+    this->updateTimeLine();
+
+    emit stopped();
+}
+
+void LapReplay::setRunning(bool running)
+{
+    if (running)
+        this->start();
+    else
+        this->pause();
+}
+
+void LapReplay::setSpeed(qreal speed)
+{
+    if (speed <= 0 || speed == this->_speed)
+        return;
+
+    this->_speed = speed;
+    this->updateTimeLine();
+}
+
+void LapReplay::seek(float time)
+{
+    this->_time = qBound(0.0f, time, this->_duration);
+    this->updateTimeLine();
+
+    emit timeChanged(this->_time);
+}
+
+void LapReplay::updateTime(void)
+{
+    this->_time = qMin(this->_duration,
+                       float(this->_timeLine.currentTime() * this->_speed / 1000));
+
+    emit timeChanged(this->_time);
+}
+
+void LapReplay::updateState(QTimeLine::State state)
+{
+    emit stateChanged(state == QTimeLine::Running);
+}
+
+void LapReplay::updateTimeLine(void)
+{
+    /* La QTimeLine compte en temps reel : sa duree et sa position dependent
+     * de la vitesse. Elle est arretee le temps du changement pour que
+     * resume() reparte de la nouvelle position */
+    bool running = this->isRunning();
+    bool blocked = this->_timeLine.blockSignals(true);
+
+    if (running)
+        this->_timeLine.stop();
+
+    this->_timeLine.setDuration(qMax(1, qRound(this->_duration * 1000 / this->_speed)));
+    this->_timeLine.setCurrentTime(qRound(this->_time * 1000 / this->_speed));
+
+    if (running)
+        this->_timeLine.resume();
+
+    this->_timeLine.blockSignals(blocked);
+}
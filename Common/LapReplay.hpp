@@ -0,0 +1,68 @@
+#ifndef __LAPREPLAY_HPP__
+#define __LAPREPLAY_HPP__
+
+#include <QtCore>
+
+// Intervalle entre deux images de la relecture (ms, environ 60 images/s)
+#define LAP_REPLAY_FRAME_INTERVAL 16
+
+/* Horloge de relecture des tours affiches.
+ *
+ * Une seule QTimeLine cadence toutes les vues : a chaque image, l'instant
+ * de relecture (s depuis le depart des tours) est emis par timeChanged()
+ * et chaque scene deplace ses curseurs (HighlightItem::setCursorTime) sans
+ * requete ni reconstruction. La vitesse est un facteur du temps reel ; la
+ * changer ou se deplacer dans la relecture (seek) garde l'instant courant.
+ *
+ *     LapReplay replay;
+ *     replay.setDuration(mapScene->replayDuration());
+ *     connect(&replay, SIGNAL(timeChanged(float)),
+ *             mapScene, SLOT(setReplayTime(float)));
+ *     replay.setSpeed(4);
+ *     replay.start();
+ */
+class LapReplay : public QObject
+{
+    Q_OBJECT
+
+    public:
+
+        explicit LapReplay(QObject* parent = 0);
+
+        float duration(void) const;
+        void setDuration(float duration); // s, duree du tour le plus long
+        qreal speed(void) const;
+        float time(void) const;
+        bool isRunning(void) const;
+
+    signals:
+
+        void timeChanged(float time);
+        void stateChanged(bool running);
+        void stopped(void); // retour au depart, les curseurs sont retires
+
+    public slots:
+
+        void start(void);
+        void pause(void);
+        void stop(void);
+        void setRunning(bool running);
+        void setSpeed(qreal speed);
+        void seek(float time);
+
+    protected slots:
+
+        void updateTime(void);
+        void updateState(QTimeLine::State state);
+
+    protected:
+
+        void updateTimeLine(void);
+
+        QTimeLine _timeLine;
+        float _duration;
+        qreal _speed;
+        float _time;
+};
+
+#endif /* __LAPREPLAY_HPP__ */
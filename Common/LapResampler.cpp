@@ -0,0 +1,224 @@
+#include "LapResampler.hpp"
+#include <qmath.h>
+
+LapResampler::LapResampler(void) :
+    _channelCount(-1)
+{
+}
+
+void LapResampler::clear(void)
+{
+    this->_laps.clear();
+    this->_grid.clear();
+    this->_channelCount = -1;
+}
+
+int LapResampler::addLap(const QVector<qreal>& abscissa,
+                         const QList< QVector<qreal> >& channels)
+{
+    if (abscissa.isEmpty())
+        return -1;
+
+    if (this->_channelCount >= 0 && channels.size() != this->_channelCount)
+        return -1;
+
+    foreach (const QVector<qreal>& channel, channels)
+        if (channel.size() != abscissa.size())
+            return -1;
+
+    Lap lap;
+    lap.abscissa = abscissa;
+    lap.channels = channels;
+
+    this->_channelCount = channels.size();
+    this->_laps.append(lap);
+
+    return this->_laps.size() - 1;
+}
+
+int LapResampler::addLap(const TelemetrySeries& series)
+{
+    // Colonnes partagees avec la serie : aucune recopie
+    QList< QVector<qreal> > channels;
+    channels << series.ys() << series.times(); // ValueChannel, TimeChannel
+
+    return this->addLap(series.xs(), channels);
+}
+
+int LapResampler::lapCount(void) const
+{
+    return this->_laps.size();
+}
+
+int LapResampler::channelCount(void) const
+{
+    return qMax(0, this->_channelCount);
+}
+
+bool LapResampler::resample(qreal step)
+{
+    if (this->_laps.isEmpty() || step <= 0)
+        return false;
+
+    // Intervalle couvert par tous les tours : pas d'extrapolation
+    qreal first = this->_laps.first().abscissa.first();
+    qreal last  = this->_laps.first().abscissa.last();
+
+    foreach (const Lap& lap, this->_laps)
+    {
+        first = qMax(first, lap.abscissa.first());
+        last  = qMin(last, lap.abscissa.last());
+    }
+
+    if (first > last)
+    {
+        this->resample(QVector<qreal>());
+        return false;
+    }
+
+    int size = qFloor((last - first) / step) + 1;
+    QVector<qreal> grid(size);
+
+    for (int i(0); i < size; ++i)
+        grid[i] = first + i * step;
+
+    this->resample(grid);
+    return true;
+}
+
+void LapResampler::resample(const QVector<qreal>& grid)
+{
+    this->_grid = grid;
+
+    int gridSize = grid.size();
+    QVector<int> indexes(gridSize);
+    QVector<qreal> weights(gridSize);
+
+    for (int l(0); l < this->_laps.size(); ++l)
+    {
+        Lap& lap = this->_laps[l];
+        lap.resampled.clear();
+
+        locate(lap.abscissa.constData(), lap.abscissa.size(),
+               grid.constData(), gridSize,
+               indexes.data(), weights.data());
+
+        const int* idx = indexes.constData();
+        const qreal* w = weights.constData();
+        int last = lap.abscissa.size() - 1;
+
+        foreach (const QVector<qreal>& channel, lap.channels)
+        {
+            QVector<qreal> out(gridSize);
+            const qreal* ys = channel.constData();
+            qreal* o = out.data();
+
+            for (int i(0); i < gridSize; ++i)
+            {
+                int j = idx[i];
+                o[i] = (j < last) ? ys[j] + w[i] * (ys[j + 1] - ys[j]) : ys[j];
+            }
+
+            lap.resampled << out;
+        }
+    }
+}
+
+const QVector<qreal>& LapResampler::grid(void) const
+{
+    return this->_grid;
+}
+
+int LapResampler::gridIndex(qreal abscissa) const
+{
+    if (this->_grid.isEmpty())
+        return -1;
+
+    QVector<qreal>::const_iterator it = qLowerBound(
+                this->_grid.constBegin(), this->_grid.constEnd(), abscissa);
+    int i = it - this->_grid.constBegin();
+
+    if (i >= this->_grid.size())
+        return this->_grid.size() - 1;
+
+    if (i > 0 && abscissa - this->_grid.at(i - 1) < this->_grid.at(i) - abscissa)
+        return i - 1;
+
+    return i;
+}
+
+const QVector<qreal>& LapResampler::values(int lap, int channel) const
+{
+    return this->_laps.at(lap).resampled.at(channel);
+}
+
+QVector<qreal> LapResampler::difference(int lap, int reference,
+                                        int channel) const
+{
+    const QVector<qreal>& values = this->values(lap, channel);
+    const QVector<qreal>& refValues = this->values(reference, channel);
+    QVector<qreal> delta(values.size());
+
+    for (int i(0); i < values.size(); ++i)
+        delta[i] = values.at(i) - refValues.at(i);
+
+    return delta;
+}
+
+QVector<qreal> LapResampler::interpolate(const QVector<qreal>& abscissa,
+                                         const QVector<qreal>& values,
+                                         const QVector<qreal>& grid)
+{
+    QVector<qreal> out(grid.size());
+
+    if (abscissa.isEmpty() || abscissa.size() != values.size())
+        return out;
+
+    QVector<int> indexes(grid.size());
+    QVector<qreal> weights(grid.size());
+
+    locate(abscissa.constData(), abscissa.size(),
+           grid.constData(), grid.size(), indexes.data(), weights.data());
+
+    int last = abscissa.size() - 1;
+
+    for (int i(0); i < grid.size(); ++i)
+    {
+        int j = indexes.at(i);
+        out[i] = (j < last) ? values.at(j) + weights.at(i) * (values.at(j + 1) - values.at(j))
+                            : values.at(j);
+    }
+
+    return out;
+}
+
+void LapResampler::locate(const qreal* abscissa, int size,
+                          const qreal* grid, int gridSize,
+                          int* indexes, qreal* weights)
+{
+    /* La grille et l'abscisse sont croissantes : le segment courant ne fait
+     * qu'avancer. Les abscisses repetees (roue arretee) sont franchies sans
+     * division par zero */
+    int j(0);
+
+    for (int i(0); i < gridSize; ++i)
+    {
+        qreal x = grid[i];
+
+        while (j + 1 < size && abscissa[j + 1] < x)
+            ++j;
+
+        if (j + 1 >= size || x <= abscissa[j])
+        {
+            // Avant le premier point ou apres le dernier : valeur du bord
+            indexes[i] = (x <= abscissa[j]) ? j : size - 1;
+            weights[i] = 0;
+        }
+        else
+        {
+            qreal width = abscissa[j + 1] - abscissa[j];
+            indexes[i] = j;
+            weights[i] = (width > 0) ? (x - abscissa[j]) / width : 1;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef __LAPRESAMPLER_HPP__
+#define __LAPRESAMPLER_HPP__
+
+#include "TelemetrySeries.hpp"
+#include <QtCore>
+
+/* Alignement de plusieurs tours sur une grille commune.
+ *
+ * Chaque tour est decrit par une abscisse croissante (temps ou distance) et
+ * un ou plusieurs canaux mesures aux memes abscisses. resample() construit
+ * une grille reguliere sur l'intervalle couvert par tous les tours puis
+ * interpole lineairement tous les canaux : pour un tour, la position de
+ * chaque point de la grille (segment et poids) est calculee une seule fois
+ * en un parcours, puis appliquee a chaque canal.
+ *
+ *     LapResampler resampler;
+ *     resampler.addLap(distanceSeries1);   // canaux : y (vitesse), temps
+ *     resampler.addLap(distanceSeries2);
+ *     resampler.resample(1.0);             // un point par metre
+ *     QVector<qreal> delta = resampler.difference(1, 0, LapResampler::TimeChannel);
+ */
+class LapResampler
+{
+    public:
+
+        // Canaux d'un tour ajoute a partir d'une TelemetrySeries
+        enum SeriesChannel
+        {
+            ValueChannel = 0, // y
+            TimeChannel  = 1  // time
+        };
+
+        LapResampler(void);
+
+        void clear(void);
+
+        /* Renvoie l'indice du tour, -1 si le nombre de canaux ne correspond
+         * pas a celui des tours deja ajoutes ou si le tour est vide */
+        int addLap(const QVector<qreal>& abscissa,
+                   const QList< QVector<qreal> >& channels);
+        int addLap(const TelemetrySeries& series); // abscisse = x
+
+        int lapCount(void) const;
+        int channelCount(void) const;
+
+        // Grille de pas step sur [plus grand debut, plus petite fin]
+        bool resample(qreal step);
+        void resample(const QVector<qreal>& grid);
+
+        const QVector<qreal>& grid(void) const;
+        int gridIndex(qreal abscissa) const; // point de grille le plus proche
+        const QVector<qreal>& values(int lap, int channel) const;
+        QVector<qreal> difference(int lap, int reference, int channel) const;
+
+        // Interpolation lineaire d'une seule courbe sur une grille croissante
+        static QVector<qreal> interpolate(const QVector<qreal>& abscissa,
+                                          const QVector<qreal>& values,
+                                          const QVector<qreal>& grid);
+
+    protected:
+
+        /* Segment [index, index + 1] et poids de chaque point de la grille
+         * pour une abscisse donnee, calcules en un parcours */
+        static void locate(const qreal* abscissa, int size,
+                           const qreal* grid, int gridSize,
+                           int* indexes, qreal* weights);
+
+        struct Lap
+        {
+            QVector<qreal> abscissa;
+            QList< QVector<qreal> > channels;
+            QList< QVector<qreal> > resampled;
+        };
+
+        QVector<Lap> _laps;
+        QVector<qreal> _grid;
+        int _channelCount;
+};
+
+#endif /* __LAPRESAMPLER_HPP__ */
@@ -0,0 +1,161 @@
+#include "TelemetrySeries.hpp"
+
+TelemetrySeries::TelemetrySeries(void) :
+    d(new TelemetrySeriesData)
+{
+}
+
+TelemetrySeries::TelemetrySeries(TelemetrySeriesData* data) :
+    d(data)
+{
+}
+
+IndexedPosition TelemetrySeries::position(int i) const
+{
+    return IndexedPosition(this->d->x.at(i), this->d->y.at(i),
+                           this->d->index.at(i));
+}
+
+const qreal* TelemetrySeries::timeData(void) const
+{
+    return this->d->time.constData();
+}
+
+const qreal* TelemetrySeries::xData(void) const
+{
+    return this->d->x.constData();
+}
+
+const qreal* TelemetrySeries::yData(void) const
+{
+    return this->d->y.constData();
+}
+
+const float* TelemetrySeries::indexData(void) const
+{
+    return this->d->index.constData();
+}
+
+const float* TelemetrySeries::speedData(void) const
+{
+    return this->d->speed.constData();
+}
+
+const QVector<qreal>& TelemetrySeries::times(void) const
+{
+    return this->d->time;
+}
+
+const QVector<qreal>& TelemetrySeries::xs(void) const
+{
+    return this->d->x;
+}
+
+const QVector<qreal>& TelemetrySeries::ys(void) const
+{
+    return this->d->y;
+}
+
+const QVector<float>& TelemetrySeries::indexes(void) const
+{
+    return this->d->index;
+}
+
+const QVector<float>& TelemetrySeries::speeds(void) const
+{
+    return this->d->speed;
+}
+
+QRectF TelemetrySeries::boundingRect(void) const
+{
+    if (this->isEmpty())
+        return QRectF();
+
+    const qreal* xs = this->xData();
+    const qreal* ys = this->yData();
+    qreal minX(xs[0]), maxX(xs[0]), minY(ys[0]), maxY(ys[0]);
+
+    for (int i(1); i < this->size(); ++i)
+    {
+        minX = qMin(minX, xs[i]);
+        maxX = qMax(maxX, xs[i]);
+        minY = qMin(minY, ys[i]);
+        maxY = qMax(maxY, ys[i]);
+    }
+
+    return QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+TelemetrySeriesBuilder::TelemetrySeriesBuilder(int reserve) :
+    _data(NULL)
+{
+    if (reserve > 0)
+        this->reserve(reserve);
+}
+
+TelemetrySeriesBuilder::~TelemetrySeriesBuilder(void)
+{
+    delete this->_data;
+}
+
+void TelemetrySeriesBuilder::reserve(int size)
+{
+    TelemetrySeriesData* data = this->data();
+
+    data->time.reserve(size);
+    data->x.reserve(size);
+    data->y.reserve(size);
+    data->index.reserve(size);
+}
+
+int TelemetrySeriesBuilder::size(void) const
+{
+    return this->_data == NULL ? 0 : this->_data->x.size();
+}
+
+void TelemetrySeriesBuilder::append(qreal time, qreal x, qreal y)
+{
+    this->append(time, x, y, time);
+}
+
+void TelemetrySeriesBuilder::append(qreal time, qreal x, qreal y, float index)
+{
+    TelemetrySeriesData* data = this->data();
+
+    data->time.append(time);
+    data->x.append(x);
+    data->y.append(y);
+    data->index.append(index);
+}
+
+void TelemetrySeriesBuilder::append(qreal time, const QPointF& point,
+                                    float index)
+{
+    this->append(time, point.x(), point.y(), index);
+}
+
+void TelemetrySeriesBuilder::setSpeeds(const QVector<float>& speeds)
+{
+    this->data()->speed = speeds;
+}
+
+TelemetrySeries TelemetrySeriesBuilder::take(void)
+{
+    TelemetrySeriesData* data = this->data();
+
+    // Colonne des vitesses incomplete : ignoree plutot que desalignee
+    Q_ASSERT(data->speed.isEmpty() || data->speed.size() == data->x.size());
+    if (data->speed.size() != data->x.size())
+        data->speed.clear();
+    this->_data = NULL;
+
+    return TelemetrySeries(data);
+}
+
+TelemetrySeriesData* TelemetrySeriesBuilder::data(void)
+{
+    if (this->_data == NULL)
+        this->_data = new TelemetrySeriesData;
+
+    return this->_data;
+}
@@ -0,0 +1,153 @@
+#ifndef __TELEMETRYSERIES_HPP__
+#define __TELEMETRYSERIES_HPP__
+
+#include "IndexedPosition.hpp"
+#include <QtCore>
+
+/* Serie de mesures d'un tour stockee par colonnes (structure of arrays).
+ *
+ * time  : instant de la mesure (s)
+ * x, y  : coordonnees du point (trace ou projection geographique)
+ * index : meta-donnee associee au point (temps par defaut, id de POSITION
+ *         pour les secteurs, ...)
+ * speed : vitesse au point (km/h, NaN si inconnue) ; colonne facultative,
+ *         vide si la serie a ete construite sans vitesses
+ *
+ * Les donnees sont partagees implicitement : une copie ne coute qu'un
+ * compteur de references. Une serie se construit avec un
+ * TelemetrySeriesBuilder puis n'est plus modifiee.
+ */
+class TelemetrySeriesData : public QSharedData
+{
+    public:
+
+        QVector<qreal> time;
+        QVector<qreal> x;
+        QVector<qreal> y;
+        QVector<float> index;
+        QVector<float> speed;
+};
+
+class TelemetrySeries
+{
+    public:
+
+        TelemetrySeries(void);
+
+        int size(void) const;
+        bool isEmpty(void) const;
+
+        qreal time(int i) const;
+        qreal x(int i) const;
+        qreal y(int i) const;
+        float index(int i) const;
+        bool hasSpeeds(void) const;
+        float speed(int i) const;
+        QPointF point(int i) const;
+        IndexedPosition position(int i) const;
+
+        // Acces direct aux colonnes contigues
+        const qreal* timeData(void) const;
+        const qreal* xData(void) const;
+        const qreal* yData(void) const;
+        const float* indexData(void) const;
+        const float* speedData(void) const;
+
+        // Colonnes completes, partagees implicitement (sans recopie)
+        const QVector<qreal>& times(void) const;
+        const QVector<qreal>& xs(void) const;
+        const QVector<qreal>& ys(void) const;
+        const QVector<float>& indexes(void) const;
+        const QVector<float>& speeds(void) const;
+
+        QRectF boundingRect(void) const;
+
+    private:
+
+        friend class TelemetrySeriesBuilder;
+
+        explicit TelemetrySeries(TelemetrySeriesData* data);
+
+        QSharedDataPointer<TelemetrySeriesData> d;
+};
+
+/* Construction d'une serie par ajouts successifs. Le builder n'est pas
+ * copiable : take() transfere les colonnes a la serie sans recopie et
+ * laisse le builder vide. La colonne des vitesses, facultative, se donne
+ * en une fois avec setSpeeds() (une vitesse par point). */
+class TelemetrySeriesBuilder
+{
+    public:
+
+        explicit TelemetrySeriesBuilder(int reserve = 0);
+        ~TelemetrySeriesBuilder(void);
+
+        void reserve(int size);
+        int size(void) const;
+
+        void append(qreal time, qreal x, qreal y);
+        void append(qreal time, qreal x, qreal y, float index);
+        void append(qreal time, const QPointF& point, float index);
+        void setSpeeds(const QVector<float>& speeds);
+
+        TelemetrySeries take(void);
+
+    private:
+
+        Q_DISABLE_COPY(TelemetrySeriesBuilder)
+
+        TelemetrySeriesData* data(void);
+
+        TelemetrySeriesData* _data;
+};
+
+/* -------------------------------------------------------------------------- *
+ *             Accesseurs en ligne : utilises dans les boucles de rendu       *
+ * -------------------------------------------------------------------------- */
+
+inline int TelemetrySeries::size(void) const
+{
+    return this->d->x.size();
+}
+
+inline bool TelemetrySeries::isEmpty(void) const
+{
+    return this->d->x.isEmpty();
+}
+
+inline qreal TelemetrySeries::time(int i) const
+{
+    return this->d->time.at(i);
+}
+
+inline qreal TelemetrySeries::x(int i) const
+{
+    return this->d->x.at(i);
+}
+
+inline qreal TelemetrySeries::y(int i) const
+{
+    return this->d->y.at(i);
+}
+
+inline float TelemetrySeries::index(int i) const
+{
+    return this->d->index.at(i);
+}
+
+inline bool TelemetrySeries::hasSpeeds(void) const
+{
+    return !this->d->speed.isEmpty();
+}
+
+inline float TelemetrySeries::speed(int i) const
+{
+    return this->d->speed.at(i);
+}
+
+inline QPointF TelemetrySeries::point(int i) const
+{
+    return QPointF(this->d->x.at(i), this->d->y.at(i));
+}
+
+#endif /* __TELEMETRYSERIES_HPP__ */
@@ -0,0 +1,132 @@
+#include "ChannelRegistry.hpp"
+
+ChannelInfo::ChannelInfo(const QString& name, const QString& unit,
+                         qreal rate, const QString& encoding) :
+    _name(name), _unit(unit), _rate(rate), _encoding(encoding)
+{
+}
+
+bool ChannelInfo::isValid(void) const
+{
+    return !this->_name.isEmpty();
+}
+
+QString ChannelInfo::name(void) const
+{
+    return this->_name;
+}
+
+QString ChannelInfo::unit(void) const
+{
+    return this->_unit;
+}
+
+qreal ChannelInfo::rate(void) const
+{
+    return this->_rate;
+}
+
+QString ChannelInfo::encoding(void) const
+{
+    return this->_encoding;
+}
+
+void ChannelInfo::setUnit(const QString& unit)
+{
+    this->_unit = unit;
+}
+
+void ChannelInfo::setRate(qreal rate)
+{
+    this->_rate = rate;
+}
+
+bool ChannelRegistry::registerChannels(const QList<ChannelInfo>& channels)
+{
+    if (channels.isEmpty())
+        return true;
+
+    QVariantList names;
+    QVariantList units;
+    QVariantList rates;
+    QVariantList encodings;
+
+    foreach (const ChannelInfo& channel, channels)
+    {
+        names << channel.name();
+        units << channel.unit();
+        rates << channel.rate();
+        encodings << channel.encoding();
+    }
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.driver()->beginTransaction();
+
+    QSqlQuery query;
+    query.prepare("insert or replace into CHANNEL (name, unit, rate, encoding) values (?, ?, ?, ?)");
+    query.addBindValue(names);
+    query.addBindValue(units);
+    query.addBindValue(rates);
+    query.addBindValue(encodings);
+
+    if (!query.execBatch(QSqlQuery::ValuesAsColumns))
+    {
+        qWarning() << query.lastError().text();
+        db.driver()->rollbackTransaction();
+        return false;
+    }
+
+    return db.driver()->commitTransaction();
+}
+
+QList<ChannelInfo> ChannelRegistry::channels(void)
+{
+    QList<ChannelInfo> channels;
+    QSqlQuery query("select name, unit, rate, encoding from CHANNEL order by name");
+
+    while (query.next())
+        channels << ChannelInfo(query.value(0).toString(),
+                                query.value(1).toString(),
+                                query.value(2).toDouble(),
+                                query.value(3).toString());
+
+    return channels;
+}
+
+QStringList ChannelRegistry::channelNames(void)
+{
+    QStringList names;
+    QSqlQuery query("select name from CHANNEL order by name");
+
+    while (query.next())
+        names << query.value(0).toString();
+
+    return names;
+}
+
+ChannelInfo ChannelRegistry::channel(const QString& name)
+{
+    QSqlQuery query;
+    query.prepare("select unit, rate, encoding from CHANNEL where name = ?");
+    query.addBindValue(name);
+
+    if (!query.exec() || !query.next())
+        return ChannelInfo();
+
+    return ChannelInfo(name, query.value(0).toString(),
+                       query.value(1).toDouble(), query.value(2).toString());
+}
+
+QStringList ChannelRegistry::tableChannels(void)
+{
+    QSettings settings;
+
+    return settings.value("channels/table",
+                          QStringList() << "RPM" << "PW").toStringList();
+}
+
+void ChannelRegistry::setTableChannels(const QStringList& names)
+{
+    QSettings settings;
+    settings.setValue("channels/table", names);
+}
@@ -0,0 +1,62 @@
+#ifndef __CHANNELREGISTRY_HPP__
+#define __CHANNELREGISTRY_HPP__
+
+#include <QtCore>
+#include <QtSql>
+
+// Seul encodage des valeurs de LAP_CHANNEL pour l'instant : float32 little-endian
+#define CHANNEL_ENCODING_F32LE "f32le"
+
+/* Description d'un canal de mesure enregistre dans la table CHANNEL */
+class ChannelInfo
+{
+    public:
+
+        explicit ChannelInfo(const QString& name = QString(),
+                             const QString& unit = QString(),
+                             qreal rate = 0,
+                             const QString& encoding = CHANNEL_ENCODING_F32LE);
+
+        bool isValid(void) const;
+
+        // Getters
+        QString name(void) const;
+        QString unit(void) const;
+        qreal rate(void) const;      // frequence moyenne mesuree (Hz)
+        QString encoding(void) const;
+
+        // Setters
+        void setUnit(const QString& unit);
+        void setRate(qreal rate);
+
+    protected:
+
+        QString _name;
+        QString _unit;
+        qreal   _rate;
+        QString _encoding;
+};
+
+/* Registre des canaux connus de la base.
+ *
+ * Tous les canaux (log MegaSquirt, accelerometre, ...) partagent la meme
+ * table d'echantillons LAP_CHANNEL (voir ChannelStore) : ajouter un capteur
+ * revient a enregistrer ses canaux, sans nouvelle table ni nouvelle requete
+ * dans les vues.
+ */
+class ChannelRegistry
+{
+    public:
+
+        static bool registerChannels(const QList<ChannelInfo>& channels);
+
+        static QList<ChannelInfo> channels(void);
+        static QStringList channelNames(void);
+        static ChannelInfo channel(const QString& name);
+
+        // Canaux affiches dans le tableau des donnees des tours
+        static QStringList tableChannels(void);
+        static void setTableChannels(const QStringList& names);
+};
+
+#endif /* __CHANNELREGISTRY_HPP__ */
@@ -0,0 +1,242 @@
+#include "ChannelStore.hpp"
+
+ChannelStore::ChannelStore(int raceId, const QList<ChannelInfo>& channels) :
+    _raceId(raceId), _lap(-1), _infos(channels),
+    _channels(channels.size()), _samples(channels.size(), 0),
+    _intervals(channels.size(), 0),
+    _spans(channels.size(), 0)
+{
+    for (int i(0); i < channels.size(); ++i)
+        this->_channels[i] = LapChannel(channels.at(i).name(),
+                                        channels.at(i).unit());
+}
+
+int ChannelStore::channelCount(void) const
+{
+    return this->_channels.size();
+}
+
+LapChannel& ChannelStore::channel(int i)
+{
+    return this->_channels[i];
+}
+
+ChannelInfo ChannelStore::info(int i) const
+{
+    return this->_infos.at(i);
+}
+
+void ChannelStore::setUnit(int i, const QString& unit)
+{
+    this->_infos[i].setUnit(unit);
+    this->_channels[i].setUnit(unit);
+}
+
+int ChannelStore::lap(void) const
+{
+    return this->_lap;
+}
+
+bool ChannelStore::setLap(int lap)
+{
+    if (lap == this->_lap)
+        return true;
+
+    if (!this->storeCurrentLap())
+        return false;
+
+    this->_lap = lap;
+    return true;
+}
+
+bool ChannelStore::finish(void)
+{
+    if (!this->storeCurrentLap())
+        return false;
+
+    this->_lap = -1;
+
+    // Frequence moyenne observee sur l'ensemble des tours
+    QList<ChannelInfo> registered;
+    for (int i(0); i < this->_infos.size(); ++i)
+    {
+        if (this->_samples.at(i) == 0)
+            continue;
+
+        ChannelInfo info = this->_infos.at(i);
+
+        if (this->_spans.at(i) > 0)
+            info.setRate(this->_intervals.at(i) * 1000.0 / this->_spans.at(i));
+
+        registered << info;
+    }
+
+    if (!ChannelRegistry::registerChannels(registered))
+    {
+        this->_errorString = "Enregistrement des canaux impossible";
+        return false;
+    }
+
+    return true;
+}
+
+QString ChannelStore::errorString(void) const
+{
+    return this->_errorString;
+}
+
+bool ChannelStore::storeCurrentLap(void)
+{
+    if (this->_lap < 0)
+        return true;
+
+    for (int i(0); i < this->_channels.size(); ++i)
+    {
+        const LapChannel& channel = this->_channels.at(i);
+        this->_samples[i] += channel.size();
+
+        if (channel.size() > 1)
+        {
+            this->_intervals[i] += channel.size() - 1;
+            this->_spans[i] += channel.timestamps().last()
+                               - channel.timestamps().first();
+        }
+    }
+
+    bool stored = ChannelStore::store(this->_raceId, this->_lap,
+                                      this->_channels, &this->_errorString);
+
+    // Garde la capacite : les memes tampons servent pour tous les tours
+    for (int i(0); i < this->_channels.size(); ++i)
+        this->_channels[i].clear();
+
+    return stored;
+}
+
+bool ChannelStore::store(int race, int lap,
+                         const QVector<LapChannel>& channels,
+                         QString* errorString)
+{
+    TRACE_SCOPE("sql", "ChannelStore::store");
+
+    QVariantList names;
+    QVariantList units;
+    QVariantList counts;
+    QVariantList timestamps;
+    QVariantList samples;
+    QVariantList refRaces;
+    QVariantList refNums;
+
+    foreach (const LapChannel& channel, channels)
+    {
+        if (channel.isEmpty())
+            continue;
+
+        names << channel.name();
+        units << channel.unit();
+        counts << channel.size();
+        timestamps << channel.encodedTimestamps();
+        samples << channel.encodedValues();
+        refRaces << race;
+        refNums << lap;
+    }
+
+    if (names.isEmpty())
+        return true;
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.driver()->beginTransaction();
+
+    // Un import repete remplace les canaux du tour
+    QSqlQuery query;
+    query.prepare("insert or replace into LAP_CHANNEL (name, unit, sample_count, timestamps, samples, ref_lap_race, ref_lap_num) values (?, ?, ?, ?, ?, ?, ?)");
+    query.addBindValue(names);
+    query.addBindValue(units);
+    query.addBindValue(counts);
+    query.addBindValue(timestamps);
+    query.addBindValue(samples);
+    query.addBindValue(refRaces);
+    query.addBindValue(refNums);
+
+    if (!query.execBatch(QSqlQuery::ValuesAsColumns))
+    {
+        if (errorString != NULL)
+            *errorString = "Query failed " + query.lastQuery()
+                           + query.lastError().text();
+
+        db.driver()->rollbackTransaction();
+        return false;
+    }
+
+    if (!db.driver()->commitTransaction())
+    {
+        if (errorString != NULL)
+            *errorString = "Transaction failed";
+
+        return false;
+    }
+
+    return true;
+}
+
+QList<LapChannel> ChannelStore::load(int race, int lap,
+                                     const QStringList& names)
+{
+    TRACE_SCOPE("sql", "ChannelStore::load");
+
+    // Un canal par nom demande, dans le meme ordre, vide s'il est absent
+    QList<LapChannel> channels;
+    QHash<QString, int> positions;
+
+    for (int i(0); i < names.size(); ++i)
+    {
+        channels << LapChannel(names.at(i));
+        positions.insert(names.at(i), i);
+    }
+
+    if (names.isEmpty())
+        return channels;
+
+    QStringList placeholders;
+    for (int i(0); i < names.size(); ++i)
+        placeholders << "?";
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select LAP_CHANNEL.name, LAP_CHANNEL.unit, CHANNEL.encoding, timestamps, samples "
+                  "from LAP_CHANNEL left join CHANNEL on CHANNEL.name = LAP_CHANNEL.name "
+                  "where ref_lap_race = ? and ref_lap_num = ? "
+                  "and LAP_CHANNEL.name in (" + placeholders.join(", ") + ")");
+    query.addBindValue(race);
+    query.addBindValue(lap);
+
+    foreach (const QString& name, names)
+        query.addBindValue(name);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastError().text();
+        return channels;
+    }
+
+    while (query.next())
+    {
+        QString name = query.value(0).toString();
+        QString encoding = query.value(2).toString();
+
+        if (!encoding.isEmpty() && encoding != CHANNEL_ENCODING_F32LE)
+        {
+            qWarning() << "Encodage inconnu pour le canal" << name << encoding;
+            continue;
+        }
+
+        LapChannel& channel = channels[positions.value(name)];
+        channel.setUnit(query.value(1).toString());
+
+        if (!channel.decode(query.value(3).toByteArray(),
+                            query.value(4).toByteArray()))
+            qWarning() << "Donnees corrompues pour le canal" << name;
+    }
+
+    return channels;
+}
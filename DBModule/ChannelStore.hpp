@@ -0,0 +1,63 @@
+#ifndef __CHANNELSTORE_HPP__
+#define __CHANNELSTORE_HPP__
+
+#include "ChannelRegistry.hpp"
+#include "LapChannel.hpp"
+#include "../Utils/Trace.hpp"
+#include <QtCore>
+#include <QtSql>
+
+/* Chemin unique de stockage des echantillons (table LAP_CHANNEL).
+ *
+ * Ecriture : un importeur remplit les canaux du tour courant puis passe au
+ * tour suivant avec setLap(). Le tour termine est ecrit en une transaction,
+ * une ligne par canal. finish() ecrit le dernier tour et enregistre les
+ * canaux qui ont recu des echantillons, avec leur frequence mesuree.
+ *
+ *     ChannelStore store(race.id(), infos);
+ *     store.setLap(0);
+ *     store.channel(k).append(msecs, value);
+ *     ...
+ *     store.finish();
+ *
+ * Lecture : load() ramene tous les canaux demandes d'un tour en une seule
+ * requete ; les valeurs sont ensuite lues en memoire, jamais ligne a ligne
+ * dans la base.
+ */
+class ChannelStore
+{
+    public:
+
+        ChannelStore(int raceId, const QList<ChannelInfo>& channels);
+
+        int channelCount(void) const;
+        LapChannel& channel(int i);
+        ChannelInfo info(int i) const;
+        void setUnit(int i, const QString& unit);
+
+        int lap(void) const;
+        bool setLap(int lap);
+        bool finish(void);
+        QString errorString(void) const;
+
+        static QList<LapChannel> load(int race, int lap,
+                                      const QStringList& names);
+        static bool store(int race, int lap,
+                          const QVector<LapChannel>& channels,
+                          QString* errorString = NULL);
+
+    protected:
+
+        bool storeCurrentLap(void);
+
+        int _raceId;
+        int _lap;
+        QList<ChannelInfo> _infos;
+        QVector<LapChannel> _channels;
+        QVector<qint64> _samples;   // echantillons ecrits, par canal
+        QVector<qint64> _intervals; // ecarts entre echantillons, par canal
+        QVector<qint64> _spans;     // duree couverte (ms), par canal
+        QString _errorString;
+};
+
+#endif /* __CHANNELSTORE_HPP__ */
@@ -44,3 +44,112 @@ bool ExportModule::buildSectorOutput(const QString& competition,
 
     return false;
 }
+
+QCSVRow ExportModule::lapDataHeader(void)
+{
+    QCSVRow header;
+    header << "Temps (ms)" << "Temps (s)" << "Distance (m)" << "V (km\\h)"
+           << "Accélération (m\\s²)";
+
+    // Un champ par canal du tableau, avec son unite si elle est connue
+    foreach (const QString& name, ChannelRegistry::tableChannels())
+    {
+        QString unit = ChannelRegistry::channel(name).unit();
+        header << (unit.isEmpty() ? name : name + " (" + unit + ")");
+    }
+
+    return header;
+}
+
+bool ExportModule::buildLapDataOutput(QCSVWriter& writer, int race, int lap,
+                                      qreal wheelPerimeter,
+                                      float lowerTimeValue,
+                                      float upperTimeValue,
+                                      const QCSVRow& prefix)
+{
+    TRACE_SCOPE("export", "ExportModule::buildLapDataOutput");
+
+    // Memes lignes que le tableau de donnees (MainWindow::getAllDataFromSpeed)
+    LapDataRows rows(race, lap, wheelPerimeter, lowerTimeValue, upperTimeValue);
+    if (!rows.exec())
+        return false;
+
+    while (rows.next())
+    {
+        foreach (const QString& field, prefix)
+            writer.writeField(field);
+
+        writer.writeField(rows.time() * 1000)  // Tps (ms)
+              .writeField(rows.time())         // Tps (s)
+              .writeField(rows.distance())     // Dist (m)
+              .writeField(rows.speed());       // V (km\h)
+
+        if (rows.isAccelerationSignificant())
+            writer.writeField(rows.acceleration()); // Acc (m\s²)
+        else
+            writer.writeField("NS");
+
+        for (int c(0); c < rows.channelCount(); ++c)
+        {
+            QVariant value = rows.channelValue(c);
+
+            if (value.isValid())
+                writer.writeField(value.toDouble());
+            else
+                writer.writeField(QString());
+        }
+
+        writer.endRow();
+    }
+
+    return !writer.hasError();
+}
+
+bool ExportModule::buildCompetitionDataOutput(const QString& competition,
+                                              QIODevice* device)
+{
+    TRACE_SCOPE("export", "ExportModule::buildCompetitionDataOutput");
+
+    QSqlQuery wheelQuery;
+    wheelQuery.prepare("select wheel_radius from COMPETITION where name = ?");
+    wheelQuery.addBindValue(competition);
+
+    if (!wheelQuery.exec() || !wheelQuery.next())
+    {
+        qWarning() << wheelQuery.lastError().text();
+        return false;
+    }
+
+    qreal wheelPerimeter = wheelQuery.value(0).toDouble();
+
+    QSqlQuery lapQuery;
+    lapQuery.setForwardOnly(true);
+    lapQuery.prepare("select RACE.id, RACE.num, LAP.num from RACE, LAP "
+                     "where RACE.ref_compet = ? and LAP.ref_race = RACE.id "
+                     "order by RACE.date, RACE.num, LAP.num");
+    lapQuery.addBindValue(competition);
+
+    if (!lapQuery.exec())
+    {
+        qWarning() << lapQuery.lastError().text();
+        return false;
+    }
+
+    QCSVWriter writer(device);
+    writer.writeRow(QCSVRow() << "Course" << "Tour" << lapDataHeader());
+
+    while (lapQuery.next())
+    {
+        QCSVRow prefix;
+        prefix << lapQuery.value(1).toString() << lapQuery.value(2).toString();
+
+        if (!ExportModule::buildLapDataOutput(writer,
+                                              lapQuery.value(0).toInt(),
+                                              lapQuery.value(2).toInt(),
+                                              wheelPerimeter, 0, FLT_MAX,
+                                              prefix))
+            return false;
+    }
+
+    return writer.flush();
+}
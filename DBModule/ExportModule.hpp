@@ -1,8 +1,12 @@
 #ifndef __EXPORTMODULE_HPP__
 #define __EXPORTMODULE_HPP__
 
+#include "LapDataRows.hpp"
+#include "../Utils/QCSVWriter.hpp"
+#include "../Utils/Trace.hpp"
 #include <QtSql>
 #include <QtGui>
+#include <float.h>
 
 class ExportModule
 {
@@ -12,6 +16,17 @@ class ExportModule
 
         static bool buildSectorOutput(const QString& competition,
                                       const QDir& dirPath = QDir());
+
+        /* Export des donnees vitesse en un seul passage : chaque ligne est
+         * calculee a partir du curseur SQL et ecrite aussitot */
+        static QCSVRow lapDataHeader(void);
+        static bool buildLapDataOutput(QCSVWriter& writer, int race, int lap,
+                                       qreal wheelPerimeter,
+                                       float lowerTimeValue = 0,
+                                       float upperTimeValue = FLT_MAX,
+                                       const QCSVRow& prefix = QCSVRow());
+        static bool buildCompetitionDataOutput(const QString& competition,
+                                               QIODevice* device);
 };
 
 #endif /* __EXPORTMODULE_HPP__ */
@@ -62,7 +62,7 @@ void GeoCoordinate::processGGAFrame(QString gga) {
     QString time = gga.section(",", 1, 1);
     QTime timestamp = QTime::fromString(time, "hhmmss.zzz");
     if (!timestamp.isValid()) {
-        qDebug() << "time not valid";
+        LOG_DEBUG(logGps) << "time not valid";
         mvalid = false;
         return;
     }
@@ -84,7 +84,7 @@ void GeoCoordinate::processRMCFrame(QString rmc) {
         return;
     }
 
-    qDebug() << "rmc status : "<< status;
+    LOG_DEBUG(logGps) << "rmc status : "<< status;
     QString latString = rmc.section(",", 3, 4);
     QString longString = rmc.section(",", 5, 6);
     this->convertToDegree(longString);
@@ -104,7 +104,7 @@ void GeoCoordinate::processVTGFrame(QString vtg) {
 void GeoCoordinate::convertToDegree(QString dmm) {
     QRegExp rx("\\d{4,5}\\.\\d{4},[EWNS]");
     if (!mvalid || !rx.exactMatch(dmm)) {
-        qDebug() << dmm << "don't match to degree format";
+        LOG_DEBUG(logGps) << dmm << "don't match to degree format";
         mvalid = false;
         return;
     }
@@ -2,6 +2,7 @@
 #define __GEOCOORDINATE_HPP__
 
 #include <QtGui>
+#include "../Utils/Log.hpp"
 
 class GeoCoordinate
 {
@@ -1,6 +1,7 @@
 #include "ImportModule.hpp"
 
-ImportModule::ImportModule()
+ImportModule::ImportModule() :
+    succeeded(false), interactive(true)
 {
     this->configValid = loadConfig();
 }
@@ -11,6 +12,8 @@ ImportModule::~ImportModule()
 
 void ImportModule::addRace(Race& race, QDir dirPath)
 {
+    TRACE_SCOPE("import", "ImportModule::addRace");
+
     QDir dir(dirPath);
 
     if (!checkFolder(&dir))
@@ -29,26 +32,49 @@ void ImportModule::addRace(Race& race, QDir dirPath)
 
     if (!loadGPSData(dir.filePath(gpsFilename), race))
     {
-        qDebug() << "loading gps data failed";
+        LOG_WARNING(logImport) << "loading gps data failed";
         succeeded = false;
         return;
     }
 
-    qDebug() << "loading gps data suceeded";
+    LOG_DEBUG(logImport) << "loading gps data suceeded";
 
     if (!loadSpeedData(dir.filePath(speedFilename), race))
     {
-        qDebug() << "loading speed data failed";
+        LOG_WARNING(logImport) << "loading speed data failed";
         succeeded = false;
         return;
     }
 
-    qDebug() << "loading speed data suceeded";
+    LOG_DEBUG(logImport) << "loading speed data suceeded";
 
-//    if (!loadAccData(dir.filePath(accFilename), race)) {
-//        succeeded = false;
-//        return;
-//    }
+    // Le fichier d'accelerations est optionnel
+    QString accPath = dir.filePath(accFilename);
+    if (QFile::exists(accPath))
+    {
+        if (!loadAccData(accPath, race))
+        {
+            LOG_WARNING(logImport) << "loading acceleration data failed";
+            succeeded = false;
+            return;
+        }
+
+        LOG_DEBUG(logImport) << "loading acceleration data suceeded";
+    }
+
+    // Le log MegaSquirt (.msl) est optionnel lui aussi
+    QString mslPath = this->megaSquirtPath(dir);
+    if (!mslPath.isEmpty())
+    {
+        if (!loadMegaSquirtData(mslPath, race))
+        {
+            LOG_WARNING(logImport) << "loading megasquirt data failed";
+            succeeded = false;
+            return;
+        }
+
+        LOG_DEBUG(logImport) << "loading megasquirt data suceeded";
+    }
 
     succeeded = true;
 }
@@ -61,7 +87,7 @@ int ImportModule::createRace(Race& race)
 
     if (! wheelQuery.exec() || ! wheelQuery.next())
     {
-        qDebug() << wheelQuery.lastError();
+        LOG_WARNING(logImport) << wheelQuery.lastError();
         return -1;
     }
 
@@ -74,7 +100,7 @@ int ImportModule::createRace(Race& race)
     if (numQuery.exec() && numQuery.next())
         numRace = numQuery.value(0).toInt() + 1;
     else
-        qDebug() << numQuery.lastError();
+        LOG_WARNING(logImport) << numQuery.lastError();
 
     QSqlQuery query;
     query.prepare("insert into RACE (num, date, ref_compet) values (?, ?, ?)");
@@ -104,12 +130,12 @@ bool ImportModule::deleteRace(const Race &race)
 
     if (query.exec())
     {
-        qDebug() << "delete empty race ok";
+        LOG_DEBUG(logImport) << "delete empty race ok";
         return true;
     }
     else
     {
-        qDebug() << "delete empty race ko";
+        LOG_WARNING(logImport) << "delete empty race ko";
         return false;
     }
 }
@@ -177,6 +203,16 @@ bool ImportModule::loadConfig()
         settings.setValue("acceleration/filename", accFilename);
     }
 
+    if (settings.contains("megasquirt/filename"))
+    {
+        megaSquirtFilename = settings.value("megasquirt/filename").toString();
+    }
+    else
+    {
+        megaSquirtFilename = "megasquirt.msl";
+        settings.setValue("megasquirt/filename", megaSquirtFilename);
+    }
+
     if (settings.contains("database"))
     {
         dbName = settings.value("database").toString();
@@ -220,6 +256,8 @@ bool ImportModule::checkFolder(const QDir *dir)
 
 bool ImportModule::launchQuery(QSqlQuery& query)
 {
+    TRACE_SCOPE("sql", "ImportModule::launchQuery");
+
     bool completed = false;
     QSqlDatabase db = QSqlDatabase::database();
     db.driver()->beginTransaction();
@@ -227,7 +265,7 @@ bool ImportModule::launchQuery(QSqlQuery& query)
     if (! query.execBatch(QSqlQuery::ValuesAsColumns))
     {
         errorString = "Query failed "+ query.lastQuery() + query.lastError().text();
-        qDebug() << "query failed";
+        LOG_WARNING(logImport) << "query failed";
     }
     else
     {
@@ -237,12 +275,14 @@ bool ImportModule::launchQuery(QSqlQuery& query)
             errorString = "Transaction failed";
     }
 
-    qDebug() << "query completed : " << completed;
+    LOG_DEBUG(logImport) << "query completed : " << completed;
     return completed;
 }
 
 bool ImportModule::loadGPSData(const QString &path, Race &race)
 {
+    TRACE_SCOPE("import", "ImportModule::loadGPSData");
+
     QFile gpsFile(path);
     if (!gpsFile.open(QIODevice::ReadOnly))
     {
@@ -280,14 +320,14 @@ bool ImportModule::loadGPSData(const QString &path, Race &race)
             if (! inInterval)
             {
                 nbInterval ++;
-                qDebug() << frameCount;
+                LOG_DEBUG(logImport) << frameCount;
                 inInterval = true;
             }
             frameCount++;
         }
         else
         {
-            qDebug() << "frame not valid : " << line;
+            LOG_DEBUG(logImport) << "frame not valid : " << line;
             if (coord.goodtype())
             {
                 frameCount++;
@@ -300,17 +340,17 @@ bool ImportModule::loadGPSData(const QString &path, Race &race)
         endCollectTime = coord.time();
     }
 
-    qDebug() << "----> " << nbInterval << " intervals";
-    qDebug() << "----> " << (coords.size() * 100.0) / frameCount;
+    LOG_DEBUG(logImport) << "----> " << nbInterval << " intervals";
+    LOG_DEBUG(logImport) << "----> " << (coords.size() * 100.0) / frameCount;
 
     QList< QPair<QTime, QTime> > laps;
 
     if (nbInterval > 6 || (coords.size() * 100.0 / frameCount) < 65)
     {
-        qDebug() << "[!] Detection skipped";
+        LOG_DEBUG(logImport) << "[!] Detection skipped";
         laps << QPair<QTime, QTime>(startCollectTime, endCollectTime);
     }
-    else
+    else if (this->interactive)
     {
         RaceViewer viewer(coords.toList());
 
@@ -322,15 +362,18 @@ bool ImportModule::loadGPSData(const QString &path, Race &race)
             deleteRace(race);
             return false;
         }
-//        LapDetector ld(&coords);
-//        laps = ld.laps();
-
-        if (laps.size() == 0)
-        {
-            qDebug() << "[!] no laps founds, creating global one.";
-            laps << QPair<QTime, QTime>(startCollectTime, endCollectTime);
-        }
+    }
+    else
+    {
+        TRACE_SCOPE("import", "LapDetector");
+        LapDetector ld(&coords);
+        laps = ld.laps();
+    }
 
+    if (laps.size() == 0)
+    {
+        LOG_DEBUG(logImport) << "[!] no laps founds, creating global one.";
+        laps << QPair<QTime, QTime>(startCollectTime, endCollectTime);
     }
 
     int nbcoord = coords.size();
@@ -339,7 +382,7 @@ bool ImportModule::loadGPSData(const QString &path, Race &race)
 
     for (int i = 0; i < laps.size(); i++)
     {
-        qDebug()  << laps[i].first.toString() << " " << laps[i].second.toString();
+        LOG_DEBUG(logImport) << laps[i].first.toString() << " " << laps[i].second.toString();
         QTime start = laps[i].first;
         QTime end = laps[i].second;
 
@@ -387,7 +430,9 @@ bool ImportModule::loadGPSData(const QString &path, Race &race)
 
 bool ImportModule::loadSpeedData(const QString &path, Race& race)
 {
-    qDebug() << "loading speed";
+    TRACE_SCOPE("import", "ImportModule::loadSpeedData");
+
+    LOG_DEBUG(logImport) << "loading speed";
     QFile speedFile(path);
 
     if (!speedFile.open(QIODevice::ReadOnly))
@@ -423,7 +468,7 @@ bool ImportModule::loadSpeedData(const QString &path, Race& race)
     prevAbsTime = origin;
     QTime lapTimeOrigin(0, 0);
 
-    qDebug() << "distance : " << race.wheelPerimeter();
+    LOG_DEBUG(logImport) << "distance : " << race.wheelPerimeter();
     while (!in.atEnd())
     {
 //        in >> absTime;
@@ -468,6 +513,8 @@ bool ImportModule::loadSpeedData(const QString &path, Race& race)
 
 bool ImportModule::loadAccData(const QString &path, Race& race)
 {
+    TRACE_SCOPE("import", "ImportModule::loadAccData");
+
     QFile accFile(path);
 
     if (!accFile.open(QIODevice::ReadOnly))
@@ -476,40 +523,353 @@ bool ImportModule::loadAccData(const QString &path, Race& race)
         return false;
     }
 
-    QSqlQuery query;
-    query.prepare("insert into ACCELERATION (timestamp, g_long, g_lat, ref_lap_race, ref_lap_num) values (?, ?, ?, ?, ?)");
-    QVariantList timestamps;
-    QVariantList glongs;
-    QVariantList glats;
-    QVariantList refRaces;
-    QVariantList refNums;
-    QTextStream in(&accFile);
-    int raceId = race.id();
-    int numLap;
-    QTime origin(0, 0);
+    // Bornes des tours en ms depuis minuit, dans l'ordre chronologique
+    QList< QPair<QTime, QTime> > laps = race.laps();
+    QVector<int> lapStarts, lapEnds;
+    QTime midnight(0, 0);
 
-    while (!in.atEnd())
+    for (int i(0); i < laps.size(); ++i)
     {
-        QString line = in.readLine();
-        QStringList params = line.split(';');
-        QTime t = QTime::fromString(params.at(0), "hh:mm:ss");
-        numLap = race.numLap(t);
+        lapStarts << midnight.msecsTo(laps.at(i).first);
+        lapEnds << midnight.msecsTo(laps.at(i).second);
+    }
+
+    /* Format : hh:mm:ss[.zzz];g_long;g_lat
+     * Le fichier est lu par blocs et les deux axes sont stockes comme des
+     * canaux : chaque tour est ecrit en une transaction des qu'il est fini */
+    QList<ChannelInfo> infos;
+    infos << ChannelInfo("g_long", "g") << ChannelInfo("g_lat", "g");
+
+    ChannelStore store(race.id(), infos);
+    QCSVReader reader(&accFile, ';', false);
+    QCSVTable batch(';');
+    int lap(0);
+    bool lastLapReached(false);
+
+    while (!lastLapReached && reader.readNext(batch))
+    {
+        if (batch.columnCount() < 3)
+            continue;
 
-        timestamps << origin.msecsTo(t);
-        glongs << params.at(1);
-        glats << params.at(2);
-        refRaces << raceId;
-        refNums << numLap;
+        QVector<double> glongValues = batch.toDoubleColumn(1);
+        QVector<double> glatValues = batch.toDoubleColumn(2);
+
+        for (int row(0); row < batch.rowCount(); ++row)
+        {
+            QByteArray field = batch.field(row, 0);
+            int t = parseTimeOfDay(field.constData(),
+                                   field.constData() + field.size());
+
+            if (t < 0)
+            {
+                LOG_DEBUG(logImport) << "acceleration frame not valid : " << field;
+                continue;
+            }
+
+            /* Les mesures sont chronologiques : le tour courant ne fait
+             * qu'avancer (plus de recherche dans la liste des tours) */
+            while (lap < lapEnds.size() && t > lapEnds.at(lap))
+                lap++;
+
+            if (lap >= lapEnds.size())
+            {
+                lastLapReached = true;
+                break;
+            }
+
+            if (t < lapStarts.at(lap))
+                continue;
+
+            if (!store.setLap(lap))
+            {
+                errorString = store.errorString();
+                return false;
+            }
+
+            store.channel(0).append(t - lapStarts.at(lap), glongValues.at(row));
+            store.channel(1).append(t - lapStarts.at(lap), glatValues.at(row));
+        }
     }
 
-    query.addBindValue(timestamps);
-    query.addBindValue(glongs);
-    query.addBindValue(glats);
-    query.addBindValue(refRaces);
+    if (!store.finish())
+    {
+        errorString = store.errorString();
+        return false;
+    }
 
-    return launchQuery(query);
+    return true;
 }
 
+/* Convertit "hh:mm:ss" ou "hh:mm:ss.zzz" en millisecondes depuis minuit.
+ * Renvoie -1 si le champ n'est pas une heure valide */
+int ImportModule::parseTimeOfDay(const char* begin, const char* end)
+{
+    const char* p = begin;
+    int parts[3];
+
+    for (int i(0); i < 3; ++i)
+    {
+        if (end - p < 2 || p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9')
+            return -1;
+
+        parts[i] = (p[0] - '0') * 10 + (p[1] - '0');
+        p += 2;
+
+        if (i < 2)
+        {
+            if (p >= end || *p != ':')
+                return -1;
+            ++p;
+        }
+    }
+
+    if (parts[0] > 23 || parts[1] > 59 || parts[2] > 59)
+        return -1;
+
+    int msecs = ((parts[0] * 60 + parts[1]) * 60 + parts[2]) * 1000;
+
+    // Fraction de seconde optionnelle, tronquee a la milliseconde
+    if (p < end && (*p == '.' || *p == ','))
+    {
+        int scale(100);
+
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+        {
+            msecs += (*p - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    // Retour chariot ou espaces residuels
+    while (p < end && (*p == ' ' || *p == '\r'))
+        ++p;
+
+    return p == end ? msecs : -1;
+}
+
+
+QString ImportModule::megaSquirtPath(const QDir& dir) const
+{
+    if (dir.exists(megaSquirtFilename))
+        return dir.filePath(megaSquirtFilename);
+
+    // Sinon, le premier log MegaLogViewer du dossier
+    QStringList logs = dir.entryList(QStringList() << "*.msl", QDir::Files,
+                                     QDir::Name);
+
+    return logs.isEmpty() ? QString() : dir.filePath(logs.first());
+}
+
+/* Ajoute aux canaux les lignes retenues d'un bloc, colonne par colonne */
+static void appendRows(ChannelStore& store,
+                       const QVector< QVector<double> >& values,
+                       QVector<int>& rows, QVector<qint32>& times)
+{
+    for (int k(0); k < store.channelCount(); ++k)
+    {
+        const double* columnValues = values.at(k).constData();
+        LapChannel& channel = store.channel(k);
+
+        for (int i(0); i < rows.size(); ++i)
+            channel.append(times.at(i), columnValues[rows.at(i)]);
+    }
+
+    rows.resize(0);
+    times.resize(0);
+}
+
+bool ImportModule::loadMegaSquirtData(const QString& path, Race& race)
+{
+    TRACE_SCOPE("import", "ImportModule::loadMegaSquirtData");
+
+    QFile mslFile(path);
+
+    if (!mslFile.open(QIODevice::ReadOnly))
+    {
+        errorString = "Impossible d'ouvrir le fichier = " + mslFile.fileName();
+        return false;
+    }
+
+    // Bornes des tours en ms depuis minuit, dans l'ordre chronologique
+    QList< QPair<QTime, QTime> > laps = race.laps();
+    QVector<int> lapStarts, lapEnds;
+    QTime midnight(0, 0);
+
+    for (int i(0); i < laps.size(); ++i)
+    {
+        lapStarts << midnight.msecsTo(laps.at(i).first);
+        lapEnds << midnight.msecsTo(laps.at(i).second);
+    }
+
+    if (lapStarts.isEmpty())
+        return true;
+
+    /* Format MegaLogViewer (separateur tabulation) :
+     *   "MS2Extra comms342h2: ..."                    <- preambule
+     *   "Capture Date: Sat Jul 13 14:22:41 CEST 2013"
+     *   Time    SecL    RPM    MAP    ...             <- en-tete
+     *   s       s       RPM    kPa    ...             <- unites
+     *   0.000   0       850    98.2   ...
+     *   MARK 000 - Manual - ...                       <- marqueurs ignores
+     *
+     * Le temps est en secondes depuis le debut de la capture */
+    int logStart(-1);
+
+    forever
+    {
+        qint64 lineStart = mslFile.pos();
+        QByteArray line = mslFile.readLine();
+
+        if (line.isEmpty())
+        {
+            errorString = "En-tete absent du log MegaSquirt " + path;
+            return false;
+        }
+
+        if (line.startsWith('"'))
+        {
+            int captureTime = parseCaptureTime(line);
+
+            if (captureTime >= 0)
+                logStart = captureTime;
+        }
+        else if (line.contains('\t'))
+        {
+            // L'en-tete est relu par le QCSVReader
+            mslFile.seek(lineStart);
+            break;
+        }
+    }
+
+    // Sans date de capture, le log est suppose demarrer avec le premier tour
+    if (logStart < 0)
+    {
+        LOG_WARNING(logImport) << "no capture date in " << path;
+        logStart = lapStarts.first();
+    }
+
+    QCSVReader reader(&mslFile, '\t', true, MEGASQUIRT_BATCH_ROWS);
+    QList<QByteArray> header = reader.header();
+    int timeColumn(-1);
+
+    // Un canal par colonne, sauf le temps
+    QVector<int> columns;
+    QList<ChannelInfo> infos;
+
+    for (int c(0); c < header.size(); ++c)
+    {
+        QByteArray name = header.at(c).trimmed();
+
+        if (name == "Time")
+            timeColumn = c;
+        else if (!name.isEmpty())
+        {
+            columns << c;
+            infos << ChannelInfo(QString::fromLatin1(name));
+        }
+    }
+
+    if (timeColumn < 0)
+    {
+        errorString = "Colonne Time absente du log MegaSquirt " + path;
+        return false;
+    }
+
+    /* Les echantillons d'un tour sont accumules canal par canal puis ecrits
+     * en une transaction des que le tour suivant commence : la memoire est
+     * bornee par un tour et un bloc de lecture */
+    ChannelStore store(race.id(), infos);
+    QCSVTable batch('\t');
+    QVector< QVector<double> > values(columns.size());
+    QVector<int> rows;       // lignes du bloc appartenant au tour courant
+    QVector<qint32> times;   // ms depuis le debut du tour
+    int lap(0);
+    bool unitsRead(false);
+    bool lastLapReached(false);
+
+    while (!lastLapReached && reader.readNext(batch))
+    {
+        for (int k(0); k < columns.size(); ++k)
+            values[k] = batch.toDoubleColumn(columns.at(k));
+
+        for (int row(0); row < batch.rowCount(); ++row)
+        {
+            bool ok;
+            double seconds = batch.toDouble(row, timeColumn, &ok);
+
+            if (!ok)
+            {
+                // La ligne des unites suit l'en-tete, le reste est ignore
+                if (!unitsRead)
+                {
+                    for (int k(0); k < columns.size(); ++k)
+                        store.setUnit(k, QString::fromLatin1(
+                            batch.field(row, columns.at(k)).trimmed()));
+                }
+
+                unitsRead = true;
+                continue;
+            }
+
+            unitsRead = true;
+            int t = logStart + qRound(seconds * 1000);
+
+            // Les mesures sont chronologiques : le tour ne fait qu'avancer
+            while (lap < lapEnds.size() && t > lapEnds.at(lap))
+                lap++;
+
+            if (lap >= lapEnds.size())
+            {
+                lastLapReached = true;
+                break;
+            }
+
+            if (t < lapStarts.at(lap))
+                continue;
+
+            if (lap != store.lap())
+            {
+                appendRows(store, values, rows, times);
+
+                if (!store.setLap(lap))
+                {
+                    errorString = store.errorString();
+                    return false;
+                }
+            }
+
+            rows << row;
+            times << t - lapStarts.at(lap);
+        }
+
+        appendRows(store, values, rows, times);
+    }
+
+    if (!store.finish())
+    {
+        errorString = store.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/* Extrait l'heure de la ligne "Capture Date: Sat Jul 13 14:22:41 CEST 2013"
+ * en millisecondes depuis minuit. Renvoie -1 pour les autres lignes */
+int ImportModule::parseCaptureTime(const QByteArray& line)
+{
+    if (!line.contains("Capture Date"))
+        return -1;
+
+    QRegExp clock("(\\d{1,2}):(\\d{2}):(\\d{2})");
+
+    if (clock.indexIn(QString::fromLatin1(line)) < 0)
+        return -1;
+
+    QTime time(clock.cap(1).toInt(), clock.cap(2).toInt(), clock.cap(3).toInt());
+
+    return time.isValid() ? QTime(0, 0).msecsTo(time) : -1;
+}
 
 QString ImportModule::getErrorString(void) const
 {
@@ -536,3 +896,13 @@ bool ImportModule::isConfigValid(void) const
 {
     return this->configValid;
 }
+
+bool ImportModule::isInteractive(void) const
+{
+    return this->interactive;
+}
+
+void ImportModule::setInteractive(bool interactive)
+{
+    this->interactive = interactive;
+}
@@ -4,10 +4,17 @@
 #include "Race.hpp"
 #include "GeoCoordinate.hpp"
 #include "LapDetector.hpp"
+#include "ChannelStore.hpp"
 #include "../RaceViewer.hpp"
+#include "../Utils/Trace.hpp"
+#include "../Utils/QCSVReader.hpp"
+#include "../Utils/Log.hpp"
 #include <QtGui>
 #include <QtSql>
 
+// Lignes du log MegaSquirt lues a la fois (une centaine de colonnes)
+#define MEGASQUIRT_BATCH_ROWS 4096
+
 class ImportModule
 {
     public:
@@ -19,6 +26,11 @@ class ImportModule
         bool isConfigValid(void) const;
         QString getErrorString(void) const;
 
+        /* En mode non interactif, les tours sont delimites par le
+         * LapDetector au lieu du RaceViewer (import en lot, benchmarks) */
+        bool isInteractive(void) const;
+        void setInteractive(bool interactive);
+
         bool createCompetition(const QString& name, float wheel_radius = 0,
                                const QString& place = QString());
         void addRace(Race& race, QDir dir);
@@ -32,14 +44,21 @@ class ImportModule
         bool loadGPSData(const QString& path, Race& race);
         bool loadSpeedData(const QString& path, Race& race);
         bool loadAccData(const QString& path, Race& race);
+        bool loadMegaSquirtData(const QString& path, Race& race);
+        QString megaSquirtPath(const QDir& dir) const;
         bool checkFolder(const QDir* dir);
         bool launchQuery(QSqlQuery& q);
 
+        static int parseTimeOfDay(const char* begin, const char* end);
+        static int parseCaptureTime(const QByteArray& line);
+
         bool configValid;
         bool succeeded;
+        bool interactive;
         QString gpsFilename;
         QString speedFilename;
         QString accFilename;
+        QString megaSquirtFilename;
         QString dbName;
         QString errorString;
 };
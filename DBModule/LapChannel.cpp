@@ -0,0 +1,170 @@
+#include "LapChannel.hpp"
+#include <string.h>
+
+namespace
+{
+    /* Les BLOB sont toujours little-endian : une base creee sur une machine
+     * reste lisible sur une autre. Sur x86 la conversion est une copie */
+    QByteArray encode32(const void* data, int count)
+    {
+        QByteArray blob;
+        blob.resize(count * 4);
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        memcpy(blob.data(), data, count * 4);
+#else
+        const quint32* in = static_cast<const quint32*>(data);
+        uchar* out = reinterpret_cast<uchar*>(blob.data());
+
+        for (int i(0); i < count; ++i)
+            qToLittleEndian<quint32>(in[i], out + 4 * i);
+#endif
+
+        return blob;
+    }
+
+    void decode32(const QByteArray& blob, void* data, int count)
+    {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        memcpy(data, blob.constData(), count * 4);
+#else
+        const uchar* in = reinterpret_cast<const uchar*>(blob.constData());
+        quint32* out = static_cast<quint32*>(data);
+
+        for (int i(0); i < count; ++i)
+            out[i] = qFromLittleEndian<quint32>(in + 4 * i);
+#endif
+    }
+}
+
+LapChannel::LapChannel(const QString& name, const QString& unit) :
+    _name(name), _unit(unit)
+{
+}
+
+QString LapChannel::name(void) const
+{
+    return this->_name;
+}
+
+QString LapChannel::unit(void) const
+{
+    return this->_unit;
+}
+
+int LapChannel::size(void) const
+{
+    return this->_values.size();
+}
+
+bool LapChannel::isEmpty(void) const
+{
+    return this->_values.isEmpty();
+}
+
+qint32 LapChannel::timestamp(int i) const
+{
+    return this->_timestamps.at(i);
+}
+
+float LapChannel::value(int i) const
+{
+    return this->_values.at(i);
+}
+
+const QVector<qint32>& LapChannel::timestamps(void) const
+{
+    return this->_timestamps;
+}
+
+const QVector<float>& LapChannel::values(void) const
+{
+    return this->_values;
+}
+
+void LapChannel::setName(const QString& name)
+{
+    this->_name = name;
+}
+
+void LapChannel::setUnit(const QString& unit)
+{
+    this->_unit = unit;
+}
+
+void LapChannel::reserve(int size)
+{
+    this->_timestamps.reserve(size);
+    this->_values.reserve(size);
+}
+
+void LapChannel::clear(void)
+{
+    // Garde la capacite : le meme canal sert pour tous les tours
+    this->_timestamps.resize(0);
+    this->_values.resize(0);
+}
+
+void LapChannel::append(qint32 msecs, float value)
+{
+    this->_timestamps.append(msecs);
+    this->_values.append(value);
+}
+
+int LapChannel::indexOf(qint32 msecs) const
+{
+    QVector<qint32>::const_iterator it = qUpperBound(
+                this->_timestamps.constBegin(), this->_timestamps.constEnd(),
+                msecs);
+
+    return int(it - this->_timestamps.constBegin()) - 1;
+}
+
+QVariant LapChannel::valueAt(qint32 msecs) const
+{
+    int i = this->indexOf(msecs);
+
+    if (i < 0)
+        return QVariant();
+
+    return this->_values.at(i);
+}
+
+TelemetrySeries LapChannel::toSeries(void) const
+{
+    TelemetrySeriesBuilder builder;
+    builder.reserve(this->size());
+
+    for (int i(0); i < this->size(); ++i)
+    {
+        qreal time = this->_timestamps.at(i) / 1000.0;
+        builder.append(time, time, this->_values.at(i));
+    }
+
+    return builder.take();
+}
+
+QByteArray LapChannel::encodedTimestamps(void) const
+{
+    return encode32(this->_timestamps.constData(), this->_timestamps.size());
+}
+
+QByteArray LapChannel::encodedValues(void) const
+{
+    return encode32(this->_values.constData(), this->_values.size());
+}
+
+bool LapChannel::decode(const QByteArray& timestamps, const QByteArray& values)
+{
+    if (timestamps.size() != values.size() || timestamps.size() % 4 != 0)
+        return false;
+
+    int count = values.size() / 4;
+    this->_timestamps.resize(count);
+    this->_values.resize(count);
+
+    decode32(timestamps, this->_timestamps.data(), count);
+    decode32(values, this->_values.data(), count);
+
+    return true;
+}
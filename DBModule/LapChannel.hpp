@@ -0,0 +1,59 @@
+#ifndef __LAPCHANNEL_HPP__
+#define __LAPCHANNEL_HPP__
+
+#include "../Common/TelemetrySeries.hpp"
+#include <QtCore>
+
+/* Mesures d'un canal (RPM, PW, Batt V, ...) pendant un tour.
+ *
+ * Les timestamps sont en millisecondes depuis le debut du tour, comme dans
+ * SPEED. Dans la table LAP_CHANNEL, un canal occupe une seule ligne par
+ * tour : timestamps (int32) et valeurs (float32) y sont stockes en deux
+ * BLOB little-endian. La lecture et l'ecriture passent par ChannelStore.
+ */
+class LapChannel
+{
+    public:
+
+        explicit LapChannel(const QString& name = QString(),
+                            const QString& unit = QString());
+
+        // Getters
+        QString name(void) const;
+        QString unit(void) const;
+        int size(void) const;
+        bool isEmpty(void) const;
+        qint32 timestamp(int i) const;
+        float value(int i) const;
+        const QVector<qint32>& timestamps(void) const;
+        const QVector<float>& values(void) const;
+
+        // Setters
+        void setName(const QString& name);
+        void setUnit(const QString& unit);
+
+        void reserve(int size);
+        void clear(void);
+        void append(qint32 msecs, float value);
+
+        /* Indice du dernier echantillon pris au plus tard a msecs, -1 s'il
+         * n'y en a pas (recherche dichotomique) */
+        int indexOf(qint32 msecs) const;
+        QVariant valueAt(qint32 msecs) const;
+
+        // x = temps (s), y = valeur, index = temps (s)
+        TelemetrySeries toSeries(void) const;
+
+        QByteArray encodedTimestamps(void) const;
+        QByteArray encodedValues(void) const;
+        bool decode(const QByteArray& timestamps, const QByteArray& values);
+
+    protected:
+
+        QString _name;
+        QString _unit;
+        QVector<qint32> _timestamps;
+        QVector<float> _values;
+};
+
+#endif /* __LAPCHANNEL_HPP__ */
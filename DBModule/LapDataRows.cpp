@@ -0,0 +1,105 @@
+#include "LapDataRows.hpp"
+#include <qmath.h>
+
+LapDataRows::LapDataRows(int race, int lap, qreal wheelPerimeter,
+                         float lowerTimeValue, float upperTimeValue) :
+    _race(race), _lap(lap), _wheelPerimeter(wheelPerimeter),
+    _lowerTimeValue(lowerTimeValue), _upperTimeValue(upperTimeValue),
+    _time(0), _lastTime(0), _speed(0), _lastSpeed(0),
+    _distance(wheelPerimeter)
+{
+}
+
+bool LapDataRows::exec(void)
+{
+    TRACE_SCOPE("sql", "LapDataRows::exec");
+
+    this->_time = this->_lastTime = 0;
+    this->_speed = this->_lastSpeed = 0;
+    this->_distance = this->_wheelPerimeter;
+
+    this->_query.setForwardOnly(true);
+    this->_query.prepare("select timestamp, value from SPEED "
+                         "where ref_lap_race = ? and ref_lap_num = ? "
+                         "order by timestamp");
+    this->_query.addBindValue(this->_race);
+    this->_query.addBindValue(this->_lap);
+
+    if (!this->_query.exec())
+    {
+        qWarning() << this->_query.lastError().text();
+        return false;
+    }
+
+    // Canaux du tableau, vides s'ils n'ont pas ete importes
+    this->_channels = ChannelStore::load(this->_race, this->_lap,
+                                         ChannelRegistry::tableChannels());
+    return true;
+}
+
+bool LapDataRows::next(void)
+{
+    while (this->_query.next())
+    {
+        this->_lastTime  = this->_time;
+        this->_lastSpeed = this->_speed;
+
+        this->_time  = this->_query.value(0).toFloat() / 1000; // ms -> s
+        this->_speed = this->_query.value(1).toDouble();
+
+        if (this->_time > this->_upperTimeValue)
+            return false;
+
+        // La distance avance aussi avant la borne inferieure
+        int multipleWheelPerimeter =
+                qCeil(((this->_speed + this->_lastSpeed) / (2 * 3.6))
+                      * (this->_time - this->_lastTime)) / this->_wheelPerimeter;
+        this->_distance += multipleWheelPerimeter * this->_wheelPerimeter;
+
+        if (this->_time >= this->_lowerTimeValue)
+            return true;
+    }
+
+    return false;
+}
+
+QString LapDataRows::lastError(void) const
+{
+    return this->_query.lastError().text();
+}
+
+qreal LapDataRows::time(void) const
+{
+    return this->_time;
+}
+
+qreal LapDataRows::distance(void) const
+{
+    return this->_distance;
+}
+
+qreal LapDataRows::speed(void) const
+{
+    return this->_speed;
+}
+
+qreal LapDataRows::acceleration(void) const
+{
+    return ((this->_speed - this->_lastSpeed) / 3.6)
+            / (this->_time - this->_lastTime);
+}
+
+bool LapDataRows::isAccelerationSignificant(void) const
+{
+    return qAbs(this->acceleration()) <= LAP_DATA_MAX_ACCELERATION;
+}
+
+int LapDataRows::channelCount(void) const
+{
+    return this->_channels.size();
+}
+
+QVariant LapDataRows::channelValue(int channel) const
+{
+    return this->_channels.at(channel).valueAt(qRound(this->_time * 1000));
+}
@@ -0,0 +1,63 @@
+#ifndef __LAPDATAROWS_HPP__
+#define __LAPDATAROWS_HPP__
+
+#include "ChannelStore.hpp"
+#include "../Utils/Trace.hpp"
+#include <QtCore>
+#include <QtSql>
+#include <float.h>
+
+// Acceleration au-dela de laquelle la mesure est jugee non significative (m/s2)
+#define LAP_DATA_MAX_ACCELERATION 2
+
+/* Lignes du tableau de donnees d'un tour, calculees a partir des vitesses.
+ *
+ * Une seule implementation pour le tableau (MainWindow) et l'export csv
+ * (ExportModule) : la distance avance par multiples du perimetre de la
+ * roue et l'acceleration est celle entre deux mesures. Chaque ligne est
+ * calculee a partir du curseur SQL, sans tout garder en memoire. Les
+ * canaux du tableau (RPM, PW, ...) sont lus en une requete pour le tour.
+ *
+ *     LapDataRows rows(race, lap, wheelPerimeter, lower, upper);
+ *     if (rows.exec())
+ *         while (rows.next())
+ *             out << rows.time() << rows.distance() << rows.speed();
+ */
+class LapDataRows
+{
+    public:
+
+        LapDataRows(int race, int lap, qreal wheelPerimeter,
+                    float lowerTimeValue = 0, float upperTimeValue = FLT_MAX);
+
+        bool exec(void);
+        bool next(void);
+        QString lastError(void) const;
+
+        // Ligne courante
+        qreal time(void) const;         // s
+        qreal distance(void) const;     // m
+        qreal speed(void) const;        // km/h
+        qreal acceleration(void) const; // m/s2
+        bool isAccelerationSignificant(void) const;
+
+        int channelCount(void) const;
+        QVariant channelValue(int channel) const; // invalide sans mesure
+
+    protected:
+
+        int _race;
+        int _lap;
+        qreal _wheelPerimeter;
+        float _lowerTimeValue;
+        float _upperTimeValue;
+
+        QSqlQuery _query;
+        QList<LapChannel> _channels;
+
+        double _time, _lastTime;
+        double _speed, _lastSpeed;
+        double _distance;
+};
+
+#endif /* __LAPDATAROWS_HPP__ */
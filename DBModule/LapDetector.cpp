@@ -6,7 +6,7 @@ LapDetector::LapDetector(const QVector<GeoCoordinate> *coords) :
     if (this->seed(coords))
         this->process();
      else
-        qDebug() << "seed failed.";
+        LOG_WARNING(logLapDetector) << "seed failed.";
 }
 
 LapDetector::~LapDetector(void)
@@ -69,9 +69,9 @@ bool LapDetector::seed(const QVector<GeoCoordinate>* coords)
     // FIXME
 //    qreal zsize = GeoCoordinate::getDegreeEquivalence(15) * ratio;
     qreal zsize = 0.0002 * ratio;
-    qDebug() << "delta : " << delta << 100/delta;
-    qDebug() << "dx, dy : " << dx << dy;
-    qDebug() << "zsize : "<< zsize;
+    LOG_DEBUG(logLapDetector) << "delta : " << delta << 100/delta;
+    LOG_DEBUG(logLapDetector) << "dx, dy : " << dx << dy;
+    LOG_DEBUG(logLapDetector) << "zsize : "<< zsize;
     this->zones = new QVector< QVector<Zone*>* >;
     int nbVert = qCeil((maxy - miny) * ratio / zsize);
     int nbHor = qCeil((maxx - minx) * ratio / zsize);
@@ -144,7 +144,7 @@ void LapDetector::process(void)
                 int cl = qRound(disp);
                 if (classes.contains(cl))
                 {
-                    qDebug() << "cl : "<< cl << classes[cl];
+                    LOG_DEBUG(logLapDetector) << "cl : "<< cl << classes[cl];
                     int& val = classes[cl];
                     val++;
                 }
@@ -162,7 +162,7 @@ void LapDetector::process(void)
     int maxValue(values.last());
     QList<int> keys(classes.keys(maxValue));
     qSort(keys);
-    qDebug() << "max : " << maxValue << "keys : " << keys;
+    LOG_DEBUG(logLapDetector) << "max : " << maxValue << "keys : " << keys;
 
     int diff(average);
     int i(0);
@@ -188,7 +188,7 @@ void LapDetector::process(void)
     else
         realAvg = average;
 
-    qDebug() << "realAvg : " << realAvg;
+    LOG_DEBUG(logLapDetector) << "realAvg : " << realAvg;
     this->delimLaps();
 
 }
@@ -215,7 +215,7 @@ void LapDetector::delimLaps(void)
                 QTime start, end;
                 z->timeGap(num, start, end);
                 gaps.append(QPair<QTime, QTime>(start, end));
-                qDebug() << num << z << start << end;
+                LOG_DEBUG(logLapDetector) << num << z << start << end;
 
                 index += qFloor(disp);
                 lastins = index;
@@ -241,5 +241,5 @@ void LapDetector::delimLaps(void)
         num++;
     }
 
-    qDebug() << num << " laps found.";
+    LOG_DEBUG(logLapDetector) << num << " laps found.";
 }
@@ -3,6 +3,7 @@
 
 #include "Zone.hpp"
 #include "GeoCoordinate.hpp"
+#include "../Utils/Log.hpp"
 #include <QtGui>
 
 class LapDetector
@@ -0,0 +1,223 @@
+#include "LapSeries.hpp"
+#include "../Common/LapResampler.hpp"
+#include <qmath.h>
+
+TelemetrySeries LapSeries::distanceSpeed(int race, int lap,
+                                         double wheelPerimeter)
+{
+    TRACE_SCOPE("sql", "LapSeries::distanceSpeed");
+
+    TelemetrySeriesBuilder builder;
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select timestamp, value from SPEED where ref_lap_race = ? and ref_lap_num = ? order by timestamp");
+    query.addBindValue(race);
+    query.addBindValue(lap);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastError().text();
+        return builder.take();
+    }
+
+    double time(0),  lastTime(0);
+    double speed(0), lastSpeed(0);
+    double pos(wheelPerimeter);
+
+    while (query.next())
+    {
+        lastTime  = time;
+        lastSpeed = speed;
+
+        time  = query.value(0).toFloat() / 1000; // ms en base, s en memoire
+        speed = query.value(1).toDouble();
+
+        int multipleWheelPerimeter = ceil(((speed + lastSpeed) / (2 * 3.6)) * (time - lastTime)) / wheelPerimeter;
+        pos += multipleWheelPerimeter * wheelPerimeter;
+
+        builder.append(time, pos, speed, time);
+    }
+
+    return builder.take();
+}
+
+TelemetrySeries LapSeries::timeSpeed(const TelemetrySeries& distanceSpeed)
+{
+    TelemetrySeriesBuilder builder(distanceSpeed.size());
+
+    for (int i(0); i < distanceSpeed.size(); ++i)
+    {
+        qreal time = distanceSpeed.time(i);
+        builder.append(time, time, distanceSpeed.y(i), time);
+    }
+
+    return builder.take();
+}
+
+TelemetrySeries LapSeries::positions(int race, int lap)
+{
+    TRACE_SCOPE("sql", "LapSeries::positions");
+
+    TelemetrySeriesBuilder builder;
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select longitude, latitude, timestamp from POSITION where ref_lap_race = ? and ref_lap_num = ? order by timestamp");
+    query.addBindValue(race);
+    query.addBindValue(lap);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastError().text();
+        return builder.take();
+    }
+
+    while (query.next())
+    {
+        GeoCoordinate coord;
+        coord.setLongitude(query.value(0).toFloat());
+        coord.setLatitude(query.value(1).toFloat());
+
+        float time = query.value(2).toFloat() / 1000;
+        builder.append(time, coord.projection(), time);
+    }
+
+    return builder.take();
+}
+
+TelemetrySeries LapSeries::referenceTrack(const QString& competition,
+                                          QVector<int>* positionIds)
+{
+    TRACE_SCOPE("sql", "LapSeries::referenceTrack");
+
+    TelemetrySeriesBuilder builder;
+
+    if (positionIds != NULL)
+        positionIds->clear();
+
+    // Les secteurs couvrent, bout a bout, les positions du tour de reference
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select longitude, latitude, timestamp, id from POSITION "
+                  "where id >= (select min(start_pos) from SECTOR where ref_compet = ?) "
+                  "and id <= (select max(end_pos) from SECTOR where ref_compet = ?) "
+                  "order by id");
+    query.addBindValue(competition);
+    query.addBindValue(competition);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastError().text();
+        return builder.take();
+    }
+
+    while (query.next())
+    {
+        GeoCoordinate coord;
+        coord.setLongitude(query.value(0).toFloat());
+        coord.setLatitude(query.value(1).toFloat());
+
+        qreal time = query.value(2).toFloat() / 1000;
+        builder.append(time, coord.projection(), time);
+
+        if (positionIds != NULL)
+            positionIds->append(query.value(3).toInt());
+    }
+
+    return builder.take();
+}
+
+QVector<TelemetrySeries> LapSeries::competitionLaps(const QString& competition)
+{
+    TRACE_SCOPE("sql", "LapSeries::competitionLaps");
+
+    typedef QPair<int, int> LapKey;
+    QVector<TelemetrySeries> laps;
+
+    // Vitesses de tous les tours, rangees par tour
+    QSqlQuery speedQuery;
+    speedQuery.setForwardOnly(true);
+    speedQuery.prepare("select SPEED.ref_lap_race, SPEED.ref_lap_num, SPEED.timestamp, SPEED.value from SPEED "
+                       "join RACE on RACE.id = SPEED.ref_lap_race where RACE.ref_compet = ? "
+                       "order by SPEED.ref_lap_race, SPEED.ref_lap_num, SPEED.timestamp");
+    speedQuery.addBindValue(competition);
+
+    if (!speedQuery.exec())
+    {
+        qWarning() << speedQuery.lastQuery() << speedQuery.lastError().text();
+        return laps;
+    }
+
+    QHash<LapKey, QPair<QVector<qreal>, QVector<qreal> > > speeds;
+
+    while (speedQuery.next())
+    {
+        QPair<QVector<qreal>, QVector<qreal> >& lapSpeeds = speeds[
+                LapKey(speedQuery.value(0).toInt(), speedQuery.value(1).toInt())];
+
+        lapSpeeds.first  << speedQuery.value(2).toFloat() / 1000;
+        lapSpeeds.second << speedQuery.value(3).toFloat();
+    }
+
+    QSqlQuery posQuery;
+    posQuery.setForwardOnly(true);
+    posQuery.prepare("select POSITION.ref_lap_race, POSITION.ref_lap_num, POSITION.longitude, POSITION.latitude, POSITION.timestamp from POSITION "
+                     "join RACE on RACE.id = POSITION.ref_lap_race where RACE.ref_compet = ? "
+                     "order by POSITION.ref_lap_race, POSITION.ref_lap_num, POSITION.timestamp");
+    posQuery.addBindValue(competition);
+
+    if (!posQuery.exec())
+    {
+        qWarning() << posQuery.lastQuery() << posQuery.lastError().text();
+        return laps;
+    }
+
+    LapKey current(-1, -1);
+    QVector<qreal> times;
+    QVector<QPointF> points;
+
+    for (bool more = posQuery.next(); ; more = posQuery.next())
+    {
+        LapKey key = more ? LapKey(posQuery.value(0).toInt(), posQuery.value(1).toInt())
+                          : LapKey(-1, -1);
+
+        // Tour termine : vitesse interpolee a l'instant de chaque point
+        if (key != current && !times.isEmpty())
+        {
+            const QPair<QVector<qreal>, QVector<qreal> > lapSpeeds = speeds.value(current);
+            QVector<qreal> pointSpeeds = lapSpeeds.first.isEmpty() ?
+                        QVector<qreal>(times.size(), qQNaN()) :
+                        LapResampler::interpolate(lapSpeeds.first, lapSpeeds.second, times);
+
+            TelemetrySeriesBuilder builder(times.size());
+            QVector<float> speedColumn(times.size());
+
+            for (int i(0); i < times.size(); ++i)
+            {
+                builder.append(times.at(i), points.at(i), times.at(i));
+                speedColumn[i] = pointSpeeds.at(i);
+            }
+
+            builder.setSpeeds(speedColumn);
+
+            laps << builder.take();
+            times.clear();
+            points.clear();
+        }
+
+        if (!more)
+            break;
+
+        current = key;
+
+        GeoCoordinate coord;
+        coord.setLongitude(posQuery.value(2).toFloat());
+        coord.setLatitude(posQuery.value(3).toFloat());
+
+        times  << posQuery.value(4).toFloat() / 1000;
+        points << coord.projection();
+    }
+
+    return laps;
+}
@@ -0,0 +1,46 @@
+#ifndef __LAPSERIES_HPP__
+#define __LAPSERIES_HPP__
+
+#include "GeoCoordinate.hpp"
+#include "../Common/TelemetrySeries.hpp"
+#include "../Utils/Trace.hpp"
+#include <QtCore>
+#include <QtSql>
+
+/* Lecture des series d'un tour depuis la base.
+ *
+ * distanceSpeed() renvoie la vitesse (km/h) en fonction de la distance
+ * parcourue (m), calculee comme pour le tableau et l'export : la distance
+ * avance par multiples du perimetre de la roue.
+ *
+ *     time  : instant de la mesure (s)
+ *     x     : distance (m)
+ *     y     : vitesse (km/h)
+ *     index : instant de la mesure (s)
+ *
+ * timeSpeed() reprend cette serie en fonction du temps (x : instant en s),
+ * sans relire la base.
+ * positions() renvoie le trace GPS du tour tel qu'il est affiche sur la
+ * carte (x, y : GeoCoordinate::projection(), index : instant en s).
+ * referenceTrack() renvoie le trace du tour de reference des secteurs d'une
+ * competition (index : instant en s), vide si aucun n'est defini. Les id de
+ * POSITION des points sont ranges dans positionIds : un float ne represente
+ * exactement les entiers que jusqu'a 2^24.
+ * competitionLaps() renvoie le trace de chaque tour d'une competition, lu en
+ * deux requetes (index : instant en s, speed : vitesse en km/h interpolee a
+ * l'instant du point, NaN si le tour n'a pas de vitesse).
+ */
+class LapSeries
+{
+    public:
+
+        static TelemetrySeries distanceSpeed(int race, int lap,
+                                             double wheelPerimeter);
+        static TelemetrySeries timeSpeed(const TelemetrySeries& distanceSpeed);
+        static TelemetrySeries positions(int race, int lap);
+        static TelemetrySeries referenceTrack(const QString& competition,
+                                              QVector<int>* positionIds = NULL);
+        static QVector<TelemetrySeries> competitionLaps(const QString& competition);
+};
+
+#endif /* __LAPSERIES_HPP__ */
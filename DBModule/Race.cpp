@@ -109,6 +109,17 @@ QPair<QTime, QTime> Race::lap(int ind)
         return QPair<QTime, QTime>();
 }
 
+QList< QPair<QTime, QTime> > Race::laps(void) const
+{
+    QList< QPair<QTime, QTime> > result;
+    QLinkedListIterator< QPair<QTime, QTime> > it(this->_laps);
+
+    while (it.hasNext())
+        result << it.next();
+
+    return result;
+}
+
 void Race::display(void) const
 {
     QLinkedListIterator< QPair<QTime, QTime> > it(this->_laps);
@@ -23,6 +23,7 @@ class Race
         void addLap(const QTime& start, const QTime& end);
         int numLap(const QTime& t);
         QPair<QTime, QTime> lap(int ind);
+        QList< QPair<QTime, QTime> > laps(void) const;
 
         void display(void) const;
 
@@ -0,0 +1,88 @@
+#include "SectorEditModel.hpp"
+
+SectorEditModel::SectorEditModel(SectorEditSession* session, QObject* parent) :
+    QAbstractTableModel(parent), _session(session)
+{
+}
+
+int SectorEditModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : this->_session->count();
+}
+
+int SectorEditModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SectorEditModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= this->_session->count())
+        return QVariant();
+
+    if (role != Qt::DisplayRole && role != Qt::EditRole)
+        return QVariant();
+
+    const EditedSector& sector = this->_session->sectors().at(index.row());
+
+    return index.column() == MinSpeed ? sector.minSpeed : sector.maxSpeed;
+}
+
+QVariant SectorEditModel::headerData(int section, Qt::Orientation orientation,
+                                     int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Vertical)
+        return section + 1;
+
+    switch (section)
+    {
+        case MinSpeed:
+            return tr("Vmin (km/h)");
+        case MaxSpeed:
+            return tr("Vmax (km/h)");
+        default:
+            return QVariant();
+    }
+}
+
+Qt::ItemFlags SectorEditModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
+}
+
+bool SectorEditModel::setData(const QModelIndex& index, const QVariant& value,
+                              int role)
+{
+    if (!index.isValid() || role != Qt::EditRole)
+        return false;
+
+    bool ok(false);
+    qreal speed = value.toDouble(&ok);
+    if (!ok)
+        return false;
+
+    const EditedSector& sector = this->_session->sectors().at(index.row());
+    qreal minSpeed = index.column() == MinSpeed ? speed : sector.minSpeed;
+    qreal maxSpeed = index.column() == MaxSpeed ? speed : sector.maxSpeed;
+
+    // Refuse par la session si la vitesse minimale depasse la maximale
+    if (!this->_session->setSpeeds(index.row(), minSpeed, maxSpeed))
+        return false;
+
+    emit dataChanged(index, index);
+    emit sectorsEdited();
+
+    return true;
+}
+
+void SectorEditModel::refresh(void)
+{
+    this->beginResetModel();
+    this->endResetModel();
+}
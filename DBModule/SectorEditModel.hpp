@@ -0,0 +1,60 @@
+#ifndef __SECTOREDITMODEL_HPP__
+#define __SECTOREDITMODEL_HPP__
+
+#include "SectorEditSession.hpp"
+#include <QtGui>
+
+/* Vue des secteurs en cours d'edition.
+ *
+ * Une ligne par secteur de la session, dans l'ordre de la carte : la vue et
+ * la carte montrent toujours les memes secteurs, enregistres ou non. Les
+ * vitesses minimale et maximale sont editables et passent par la session
+ * (SectorEditSession::setSpeeds), elles sont donc annulables et ecrites
+ * avec les coupes et fusions par SectorEditSession::commit().
+ *
+ * refresh() est appele apres chaque modification de la session faite hors
+ * du modele (etape sur la carte, undo, redo, load, commit).
+ *
+ *     SectorEditModel* model = new SectorEditModel(&session, this);
+ *     sectorView->setModel(model);
+ *     session.endStep();
+ *     model->refresh();
+ */
+class SectorEditModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+    public:
+
+        enum Column
+        {
+            MinSpeed = 0,
+            MaxSpeed,
+            ColumnCount
+        };
+
+        explicit SectorEditModel(SectorEditSession* session, QObject* parent = 0);
+
+        int rowCount(const QModelIndex& parent = QModelIndex()) const;
+        int columnCount(const QModelIndex& parent = QModelIndex()) const;
+        QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+        QVariant headerData(int section, Qt::Orientation orientation,
+                            int role = Qt::DisplayRole) const;
+        Qt::ItemFlags flags(const QModelIndex& index) const;
+        bool setData(const QModelIndex& index, const QVariant& value,
+                     int role = Qt::EditRole);
+
+    signals:
+
+        void sectorsEdited(void); // vitesse modifiee depuis la vue
+
+    public slots:
+
+        void refresh(void);
+
+    protected:
+
+        SectorEditSession* _session;
+};
+
+#endif /* __SECTOREDITMODEL_HPP__ */
@@ -0,0 +1,318 @@
+#include "SectorEditSession.hpp"
+#include "SectorTiming.hpp"
+
+EditedSector::EditedSector(int startPos, int endPos) :
+    id(-1), startPos(startPos), endPos(endPos), minSpeed(0), maxSpeed(0)
+{
+}
+
+bool EditedSector::operator==(const EditedSector& other) const
+{
+    return this->id == other.id && this->startPos == other.startPos
+            && this->endPos == other.endPos && this->minSpeed == other.minSpeed
+            && this->maxSpeed == other.maxSpeed;
+}
+
+bool EditedSector::operator!=(const EditedSector& other) const
+{
+    return !(*this == other);
+}
+
+SectorEditSession::SectorEditSession(const QString& competition) :
+    _competition(competition), _stepOpen(false)
+{
+}
+
+QString SectorEditSession::competition(void) const
+{
+    return this->_competition;
+}
+
+const QList<EditedSector>& SectorEditSession::sectors(void) const
+{
+    return this->_sectors;
+}
+
+int SectorEditSession::count(void) const
+{
+    return this->_sectors.count();
+}
+
+bool SectorEditSession::load(void)
+{
+    TRACE_SCOPE("sql", "SectorEditSession::load");
+
+    this->_sectors.clear();
+    this->_saved.clear();
+    this->_undoSteps.clear();
+    this->_redoSteps.clear();
+    this->_stepOpen = false;
+
+    QSqlQuery query;
+    query.prepare("select id, start_pos, end_pos, min_speed, max_speed from SECTOR "
+                  "where ref_compet = ? order by num");
+    query.addBindValue(this->_competition);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastQuery() << query.lastError().text();
+        return false;
+    }
+
+    while (query.next())
+    {
+        EditedSector sector(query.value(1).toInt(), query.value(2).toInt());
+        sector.id = query.value(0).toInt();
+        sector.minSpeed = query.value(3).toDouble();
+        sector.maxSpeed = query.value(4).toDouble();
+        this->_sectors << sector;
+    }
+
+    this->_saved = this->_sectors;
+    return true;
+}
+
+void SectorEditSession::insertSector(int num, int startPos, int endPos)
+{
+    this->beginChange();
+    this->_sectors.insert(qBound(0, num, this->_sectors.count()),
+                          EditedSector(startPos, endPos));
+}
+
+void SectorEditSession::removeSector(int num)
+{
+    if (num < 0 || num >= this->_sectors.count())
+        return;
+
+    this->beginChange();
+    this->_sectors.removeAt(num);
+}
+
+void SectorEditSession::updateSector(int num, int startPos, int endPos)
+{
+    if (num < 0 || num >= this->_sectors.count())
+        return;
+
+    this->beginChange();
+    this->_sectors[num].startPos = startPos;
+    this->_sectors[num].endPos = endPos;
+}
+
+bool SectorEditSession::setSpeeds(int num, qreal minSpeed, qreal maxSpeed)
+{
+    // Meme contrainte que la table SECTOR (min_speed <= max_speed)
+    if (num < 0 || num >= this->_sectors.count() || minSpeed > maxSpeed)
+        return false;
+
+    this->endStep();
+    this->beginChange();
+    this->_sectors[num].minSpeed = minSpeed;
+    this->_sectors[num].maxSpeed = maxSpeed;
+    this->endStep();
+
+    return true;
+}
+
+void SectorEditSession::endStep(void)
+{
+    this->_stepOpen = false;
+}
+
+bool SectorEditSession::canUndo(void) const
+{
+    return !this->_undoSteps.isEmpty();
+}
+
+bool SectorEditSession::canRedo(void) const
+{
+    return !this->_redoSteps.isEmpty();
+}
+
+bool SectorEditSession::undo(void)
+{
+    if (this->_undoSteps.isEmpty())
+        return false;
+
+    this->_redoSteps << this->_sectors;
+    this->_sectors = this->_undoSteps.takeLast();
+    this->_stepOpen = false;
+
+    return true;
+}
+
+bool SectorEditSession::redo(void)
+{
+    if (this->_redoSteps.isEmpty())
+        return false;
+
+    this->_undoSteps << this->_sectors;
+    this->_sectors = this->_redoSteps.takeLast();
+    this->_stepOpen = false;
+
+    return true;
+}
+
+bool SectorEditSession::isModified(void) const
+{
+    return this->_sectors != this->_saved;
+}
+
+bool SectorEditSession::commit(void)
+{
+    if (!this->isModified())
+        return true;
+
+    TRACE_SCOPE("sql", "SectorEditSession::commit");
+
+    QSqlDriver* driver = QSqlDatabase::database().driver();
+    driver->beginTransaction();
+
+    // Secteurs de la competition presents dans la base
+    QSqlQuery existingQuery;
+    existingQuery.prepare("select id from SECTOR where ref_compet = ?");
+    existingQuery.addBindValue(this->_competition);
+
+    if (!existingQuery.exec())
+    {
+        qWarning() << existingQuery.lastQuery() << existingQuery.lastError().text();
+        driver->rollbackTransaction();
+        return false;
+    }
+
+    QSet<int> existing;
+    while (existingQuery.next())
+        existing.insert(existingQuery.value(0).toInt());
+
+    QSqlQuery updateQuery;
+    updateQuery.prepare("update SECTOR set num = ?, min_speed = ?, max_speed = ?, "
+                        "start_pos = ?, end_pos = ? where id = ?");
+
+    QSqlQuery insertQuery;
+    insertQuery.prepare("insert into SECTOR (num, ref_compet, min_speed, max_speed, start_pos, end_pos) "
+                        "values (?, ?, ?, ?, ?, ?)");
+
+    QList<EditedSector> sectors = this->_sectors;
+    QSet<int> kept;
+
+    for (int num(0); num < sectors.count(); ++num)
+    {
+        EditedSector& sector = sectors[num];
+        bool stored = existing.contains(sector.id);
+        QSqlQuery& query = stored ? updateQuery : insertQuery;
+
+        if (stored)
+        {
+            updateQuery.addBindValue(num);
+            updateQuery.addBindValue(sector.minSpeed);
+            updateQuery.addBindValue(sector.maxSpeed);
+            updateQuery.addBindValue(sector.startPos);
+            updateQuery.addBindValue(sector.endPos);
+            updateQuery.addBindValue(sector.id);
+        }
+        else
+        {
+            insertQuery.addBindValue(num);
+            insertQuery.addBindValue(this->_competition);
+            insertQuery.addBindValue(sector.minSpeed);
+            insertQuery.addBindValue(sector.maxSpeed);
+            insertQuery.addBindValue(sector.startPos);
+            insertQuery.addBindValue(sector.endPos);
+        }
+
+        if (!query.exec())
+        {
+            qWarning() << query.lastQuery() << query.lastError().text();
+            driver->rollbackTransaction();
+            return false;
+        }
+
+        if (!stored)
+            sector.id = insertQuery.lastInsertId().toInt();
+
+        kept.insert(sector.id);
+    }
+
+    // Secteurs retires pendant la session
+    QSqlQuery deleteQuery;
+    deleteQuery.prepare("delete from SECTOR where id = ?");
+
+    foreach (int id, existing - kept)
+    {
+        deleteQuery.addBindValue(id);
+
+        if (!deleteQuery.exec())
+        {
+            qWarning() << deleteQuery.lastQuery() << deleteQuery.lastError().text();
+            driver->rollbackTransaction();
+            return false;
+        }
+    }
+
+    if (!driver->commitTransaction())
+    {
+        qWarning() << "SectorEditSession::commit" << driver->lastError().text();
+        driver->rollbackTransaction();
+        return false;
+    }
+
+    this->adoptInsertedIds(sectors);
+    this->_sectors = sectors;
+    this->_saved = sectors;
+
+    // Les portes de chronometrage ont change
+    SectorTiming::resetCompetition(this->_competition);
+
+    return true;
+}
+
+void SectorEditSession::beginChange(void)
+{
+    // Premiere modification d'une etape : l'etat precedent est garde
+    if (!this->_stepOpen)
+    {
+        this->_undoSteps << this->_sectors;
+        if (this->_undoSteps.count() > SECTOR_EDIT_HISTORY)
+            this->_undoSteps.removeFirst();
+
+        this->_redoSteps.clear();
+        this->_stepOpen = true;
+    }
+}
+
+void SectorEditSession::adoptInsertedIds(const QList<EditedSector>& committed)
+{
+    /* Les secteurs inseres par le commit ont maintenant un id : les etapes
+     * d'annulation le reprennent, sinon un nouveau commit apres undo()
+     * supprimerait ces lignes pour en inserer d'autres (et perdrait les
+     * vitesses saisies entre-temps dans la base) */
+    QHash< QPair<int, int>, int > insertedIds;
+
+    for (int num(0); num < committed.count(); ++num)
+        if (this->_sectors.at(num).id < 0)
+            insertedIds.insert(qMakePair(committed.at(num).startPos,
+                                         committed.at(num).endPos),
+                               committed.at(num).id);
+
+    if (insertedIds.isEmpty())
+        return;
+
+    QList< QList<EditedSector> >* histories[] = { &this->_undoSteps,
+                                                  &this->_redoSteps };
+
+    for (int h(0); h < 2; ++h)
+    {
+        for (int step(0); step < histories[h]->count(); ++step)
+        {
+            QList<EditedSector>& sectors = (*histories[h])[step];
+
+            for (int num(0); num < sectors.count(); ++num)
+            {
+                EditedSector& sector = sectors[num];
+                QPair<int, int> bounds = qMakePair(sector.startPos, sector.endPos);
+
+                if (sector.id < 0 && insertedIds.contains(bounds))
+                    sector.id = insertedIds.value(bounds);
+            }
+        }
+    }
+}
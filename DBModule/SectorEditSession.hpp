@@ -0,0 +1,91 @@
+#ifndef __SECTOREDITSESSION_HPP__
+#define __SECTOREDITSESSION_HPP__
+
+#include "../Utils/Trace.hpp"
+#include <QtCore>
+#include <QtSql>
+
+// Nombre d'etapes gardees pour annuler
+#define SECTOR_EDIT_HISTORY 100
+
+/* Secteur tel qu'edite, avant son ecriture dans la table SECTOR */
+class EditedSector
+{
+    public:
+
+        EditedSector(int startPos = -1, int endPos = -1);
+
+        bool operator==(const EditedSector& other) const;
+        bool operator!=(const EditedSector& other) const;
+
+        int id;         // -1 tant que le secteur n'est pas dans la base
+        int startPos;   // id de la premiere position (POSITION)
+        int endPos;     // id de la derniere position
+        qreal minSpeed;
+        qreal maxSpeed;
+};
+
+/* Modifications des secteurs d'une competition, gardees en memoire.
+ *
+ * Les coupes, fusions et changements de limites faits sur la carte sont
+ * appliques a la liste des secteurs sans toucher a la base. Les
+ * modifications faites entre deux appels a endStep() forment une etape
+ * (une coupe retire un secteur et en ajoute deux) : undo() et redo()
+ * reviennent d'une etape en arriere ou en avant.
+ *
+ * Les vitesses saisies dans la vue des secteurs (setSpeeds, voir
+ * SectorEditModel) forment chacune une etape.
+ *
+ * commit() ecrit l'etat courant en une seule transaction. Les secteurs
+ * deja en base sont mis a jour sur place, les nouveaux sont inseres et les
+ * autres supprimes.
+ *
+ *     SectorEditSession session(competition);
+ *     session.load();
+ *     session.removeSector(2);
+ *     session.insertSector(2, start, cut);
+ *     session.insertSector(3, cut, end);
+ *     session.endStep();
+ *     session.commit();
+ */
+class SectorEditSession
+{
+    public:
+
+        explicit SectorEditSession(const QString& competition = QString());
+
+        QString competition(void) const;
+        const QList<EditedSector>& sectors(void) const;
+        int count(void) const;
+
+        // Relit les secteurs de la base et oublie l'historique
+        bool load(void);
+
+        void insertSector(int num, int startPos, int endPos);
+        void removeSector(int num);
+        void updateSector(int num, int startPos, int endPos);
+        bool setSpeeds(int num, qreal minSpeed, qreal maxSpeed);
+        void endStep(void);
+
+        bool canUndo(void) const;
+        bool canRedo(void) const;
+        bool undo(void);
+        bool redo(void);
+
+        bool isModified(void) const; // difference avec la base
+        bool commit(void);
+
+    protected:
+
+        void beginChange(void);
+        void adoptInsertedIds(const QList<EditedSector>& committed);
+
+        QString _competition;
+        QList<EditedSector> _sectors;
+        QList<EditedSector> _saved;
+        QList< QList<EditedSector> > _undoSteps;
+        QList< QList<EditedSector> > _redoSteps;
+        bool _stepOpen;
+};
+
+#endif /* __SECTOREDITSESSION_HPP__ */
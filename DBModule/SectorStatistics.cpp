@@ -0,0 +1,409 @@
+#include "SectorStatistics.hpp"
+#include <qmath.h>
+
+#if QT_VERSION >= 0x050000
+#include <QtConcurrent>
+#endif
+
+namespace
+{
+    typedef QPair<TelemetrySeries, QVector<qreal> > MetricsInput;
+
+    // Mesures d'un tour, appele en parallele par QtConcurrent
+    struct LapMetrics
+    {
+        typedef QVector<qreal> result_type;
+
+        QVector<qreal> operator()(const MetricsInput& input) const
+        {
+            return SectorStatistics::lapMetrics(input.first, input.second);
+        }
+    };
+}
+
+/* -------------------------------------------------------------------------- *
+ *                                Distribution                                *
+ * -------------------------------------------------------------------------- */
+
+Distribution::Distribution(void) :
+    count(0), mean(qQNaN()), stdDev(qQNaN()), minimum(qQNaN()), p10(qQNaN()),
+    median(qQNaN()), p90(qQNaN()), maximum(qQNaN())
+{
+}
+
+Distribution Distribution::of(QVector<qreal> values)
+{
+    Distribution d;
+
+    // Les valeurs absentes ne comptent pas
+    int n(0);
+    for (int i(0); i < values.size(); ++i)
+        if (!qIsNaN(values.at(i)))
+            values[n++] = values.at(i);
+    values.resize(n);
+
+    if (n == 0)
+        return d;
+
+    qSort(values);
+
+    qreal sum(0);
+    foreach (qreal value, values)
+        sum += value;
+
+    d.count = n;
+    d.mean  = sum / n;
+
+    qreal squares(0);
+    foreach (qreal value, values)
+        squares += (value - d.mean) * (value - d.mean);
+
+    d.stdDev  = (n > 1) ? qSqrt(squares / (n - 1)) : 0;
+    d.minimum = values.first();
+    d.maximum = values.last();
+    d.p10     = percentile(values, 0.1);
+    d.median  = percentile(values, 0.5);
+    d.p90     = percentile(values, 0.9);
+
+    return d;
+}
+
+qreal Distribution::percentile(const QVector<qreal>& sorted, qreal p)
+{
+    if (sorted.isEmpty())
+        return qQNaN();
+
+    // Interpolation lineaire entre les deux rangs encadrants
+    qreal rank = p * (sorted.size() - 1);
+    int lower = qFloor(rank);
+    int upper = qMin(lower + 1, sorted.size() - 1);
+
+    return sorted.at(lower) + (rank - lower) * (sorted.at(upper) - sorted.at(lower));
+}
+
+/* -------------------------------------------------------------------------- *
+ *                              SectorStatistics                              *
+ * -------------------------------------------------------------------------- */
+
+QHash<QString, SectorStatistics> SectorStatistics::_cache;
+
+SectorStatistics::SectorStatistics(const QString& competition) :
+    _competition(competition), _sectorCount(0),
+    _bestLap(qQNaN()), _theoreticalBestLap(qQNaN())
+{
+}
+
+QString SectorStatistics::competition(void) const
+{
+    return this->_competition;
+}
+
+SectorTiming& SectorStatistics::timing(void) const
+{
+    return SectorTiming::forCompetition(this->_competition);
+}
+
+int SectorStatistics::sectorCount(void) const
+{
+    return this->_sectorCount;
+}
+
+int SectorStatistics::lapCount(void) const
+{
+    return this->_laps.size();
+}
+
+qreal SectorStatistics::bestLap(void) const
+{
+    return this->_bestLap;
+}
+
+qreal SectorStatistics::theoreticalBestLap(void) const
+{
+    return this->_theoreticalBestLap;
+}
+
+Distribution SectorStatistics::distribution(int sector, Metric metric) const
+{
+    return this->_distributions.value(sector * MetricCount + metric);
+}
+
+void SectorStatistics::reset(void)
+{
+    this->_sectorCount = 0;
+    this->_laps.clear();
+    this->_distributions.clear();
+    this->_bestLap = qQNaN();
+    this->_theoreticalBestLap = qQNaN();
+}
+
+bool SectorStatistics::update(void)
+{
+    TRACE_SCOPE("sql", "SectorStatistics::update");
+
+    SectorTiming& timing = this->timing();
+
+    if (!timing.update())
+        return false;
+
+    bool changed = (timing.sectorCount() != this->_sectorCount);
+    this->_sectorCount = timing.sectorCount();
+
+    QSet<LapKey> present;
+    foreach (const LapSectorTimes& lap, timing.laps())
+        present.insert(LapKey(lap.race, lap.lap));
+
+    // Tours supprimes depuis le dernier calcul
+    QHash<LapKey, LapEntry>::iterator it = this->_laps.begin();
+    while (it != this->_laps.end())
+    {
+        if (present.contains(it.key()))
+        {
+            ++it;
+        }
+        else
+        {
+            it = this->_laps.erase(it);
+            changed = true;
+        }
+    }
+
+    // Tours importes depuis le dernier calcul : vitesses lues en une requete
+    QList<LapKey> missing;
+    foreach (const LapKey& key, present)
+        if (!this->_laps.contains(key))
+            missing << key;
+
+    if (!missing.isEmpty() && !this->loadSpeeds(missing))
+        return false;
+
+    // Mesures a calculer : tours nouveaux ou dont les passages ont change
+    QList<LapKey> pending;
+    QVector<MetricsInput> inputs;
+
+    foreach (const LapSectorTimes& lap, timing.laps())
+    {
+        LapKey key(lap.race, lap.lap);
+        LapEntry& entry = this->_laps[key];
+
+        if (!entry.metrics.isEmpty()
+                && sameCrossings(entry.crossings, lap.crossings))
+            continue;
+
+        entry.crossings = lap.crossings;
+        pending << key;
+        inputs << MetricsInput(entry.speed, lap.crossings);
+    }
+
+    if (!pending.isEmpty())
+    {
+        QVector< QVector<qreal> > metrics =
+                QtConcurrent::blockingMapped< QVector< QVector<qreal> > >(
+                    inputs, LapMetrics());
+
+        for (int i(0); i < pending.size(); ++i)
+            this->_laps[pending.at(i)].metrics = metrics.at(i);
+
+        changed = true;
+    }
+
+    if (changed)
+        this->aggregate();
+
+    return true;
+}
+
+bool SectorStatistics::loadSpeeds(const QList<LapKey>& laps)
+{
+    QSet<LapKey> wanted = laps.toSet();
+    QSet<int> races;
+
+    foreach (const LapKey& key, laps)
+    {
+        races.insert(key.first);
+        this->_laps.insert(key, LapEntry()); // tour sans vitesse : serie vide
+    }
+
+    QStringList placeholders;
+    for (int i(0); i < races.size(); ++i)
+        placeholders << "?";
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select ref_lap_race, ref_lap_num, timestamp, value from SPEED "
+                  "where ref_lap_race in (" + placeholders.join(", ") + ") "
+                  "order by ref_lap_race, ref_lap_num, timestamp");
+
+    foreach (int race, races)
+        query.addBindValue(race);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastQuery() << query.lastError().text();
+        return false;
+    }
+
+    TelemetrySeriesBuilder builder;
+    LapKey current(-1, -1);
+
+    while (query.next())
+    {
+        LapKey key(query.value(0).toInt(), query.value(1).toInt());
+
+        if (key != current)
+        {
+            if (wanted.contains(current))
+                this->_laps[current].speed = builder.take();
+
+            current = key;
+        }
+
+        if (!wanted.contains(key))
+            continue;
+
+        qreal time = query.value(2).toFloat() / 1000;
+        builder.append(time, time, query.value(3).toFloat());
+    }
+
+    if (wanted.contains(current))
+        this->_laps[current].speed = builder.take();
+
+    return true;
+}
+
+void SectorStatistics::aggregate(void)
+{
+    int size = (this->_sectorCount + 1) * MetricCount;
+    QVector< QVector<qreal> > values(size);
+
+    foreach (const LapEntry& entry, this->_laps)
+        for (int k(0); k < entry.metrics.size() && k < size; ++k)
+            values[k] << entry.metrics.at(k);
+
+    this->_distributions.resize(size);
+    for (int k(0); k < size; ++k)
+        this->_distributions[k] = Distribution::of(values.at(k));
+
+    this->_bestLap = this->distribution(this->_sectorCount, SectorTime).minimum;
+
+    // Tour theorique : meilleur temps de chaque secteur, tous tours confondus
+    this->_theoreticalBestLap = (this->_sectorCount > 0) ? 0 : qQNaN();
+    for (int s(0); s < this->_sectorCount; ++s)
+        this->_theoreticalBestLap += this->distribution(s, SectorTime).minimum;
+}
+
+QVector<qreal> SectorStatistics::lapMetrics(const TelemetrySeries& speed,
+                                            const QVector<qreal>& crossings)
+{
+    int sectorCount = qMax(0, crossings.size() - 1);
+    QVector<qreal> metrics((sectorCount + 1) * MetricCount, qQNaN());
+
+    if (sectorCount == 0)
+        return metrics;
+
+    qreal lapTime(0);
+
+    for (int s(0); s < sectorCount; ++s)
+    {
+        measure(speed, crossings.at(s), crossings.at(s + 1),
+                metrics.data() + s * MetricCount);
+        lapTime += metrics.at(s * MetricCount + SectorTime);
+    }
+
+    // Tour complet : de la premiere a la derniere porte
+    qreal* lap = metrics.data() + sectorCount * MetricCount;
+    measure(speed, crossings.first(), crossings.last(), lap);
+    lap[SectorTime] = lapTime; // NaN si un secteur manque, comme LapSectorTimes
+
+    return metrics;
+}
+
+void SectorStatistics::measure(const TelemetrySeries& speed,
+                               qreal from, qreal to, qreal* metrics)
+{
+    metrics[SectorTime] = to - from; // NaN si un passage manque
+
+    if (qIsNaN(from) || qIsNaN(to) || to < from || speed.isEmpty())
+        return;
+
+    const qreal* times  = speed.timeData();
+    const qreal* values = speed.yData();
+    int size = speed.size();
+
+    /* Vitesse interpolee aux deux portes, echantillons entre les deux.
+     * Energie cinetique par kg : v^2 / 2 avec v en m/s */
+    qreal last = speedAt(speed, from);
+    qreal minSpeed(last), maxSpeed(last), traction(0), braking(0);
+    int i = qUpperBound(times, times + size, from) - times;
+
+    for (;; ++i)
+    {
+        bool end = (i >= size || times[i] >= to);
+        qreal value = end ? speedAt(speed, to) : values[i];
+
+        minSpeed = qMin(minSpeed, value);
+        maxSpeed = qMax(maxSpeed, value);
+
+        qreal energy = (value * value - last * last) / (2 * 3.6 * 3.6);
+        if (energy > 0)
+            traction += energy;
+        else
+            braking -= energy;
+
+        last = value;
+
+        if (end)
+            break;
+    }
+
+    metrics[MinSpeed]       = minSpeed;
+    metrics[MaxSpeed]       = maxSpeed;
+    metrics[TractionEnergy] = traction;
+    metrics[BrakingEnergy]  = braking;
+}
+
+qreal SectorStatistics::speedAt(const TelemetrySeries& speed, qreal time)
+{
+    const qreal* times  = speed.timeData();
+    const qreal* values = speed.yData();
+    int size = speed.size();
+    int i = qUpperBound(times, times + size, time) - times;
+
+    if (i == 0)
+        return values[0];
+
+    if (i >= size)
+        return values[size - 1];
+
+    qreal width = times[i] - times[i - 1];
+    if (width <= 0)
+        return values[i];
+
+    return values[i - 1] + (time - times[i - 1]) / width * (values[i] - values[i - 1]);
+}
+
+bool SectorStatistics::sameCrossings(const QVector<qreal>& a,
+                                     const QVector<qreal>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    // NaN == NaN : une porte toujours manquee ne force pas de recalcul
+    for (int i(0); i < a.size(); ++i)
+        if (a.at(i) != b.at(i) && !(qIsNaN(a.at(i)) && qIsNaN(b.at(i))))
+            return false;
+
+    return true;
+}
+
+SectorStatistics& SectorStatistics::forCompetition(const QString& competition)
+{
+    // Meme cle que SectorTiming : une instance par base et par competition
+    QString key = QSqlDatabase::database().databaseName() + "/" + competition;
+
+    QHash<QString, SectorStatistics>::iterator it = _cache.find(key);
+    if (it == _cache.end())
+        it = _cache.insert(key, SectorStatistics(competition));
+
+    return it.value();
+}
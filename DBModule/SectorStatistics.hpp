@@ -0,0 +1,118 @@
+#ifndef __SECTORSTATISTICS_HPP__
+#define __SECTORSTATISTICS_HPP__
+
+#include "SectorTiming.hpp"
+#include "../Common/TelemetrySeries.hpp"
+#include "../Utils/Trace.hpp"
+#include <QtCore>
+#include <QtSql>
+
+/* Repartition d'une mesure sur tous les tours (les NaN sont ignores) */
+class Distribution
+{
+    public:
+
+        Distribution(void);
+
+        int count;
+        qreal mean;
+        qreal stdDev; // ecart type de l'echantillon
+        qreal minimum;
+        qreal p10;
+        qreal median;
+        qreal p90;
+        qreal maximum;
+
+        static Distribution of(QVector<qreal> values);
+        static qreal percentile(const QVector<qreal>& sorted, qreal p);
+};
+
+/* Statistiques de regularite des tours d'une competition.
+ *
+ * Pour chaque tour, chaque secteur (et le tour complet, de la premiere a la
+ * derniere porte) donne le temps, les vitesses min et max et deux mesures
+ * d'energie par kg tirees de la vitesse : energie cinetique gagnee
+ * (traction) et perdue (freinage). Les bornes viennent de SectorTiming, la
+ * vitesse est interpolee aux passages des portes.
+ *
+ * Les vitesses de chaque tour sont lues une fois en base puis gardees en
+ * memoire ; les mesures d'un tour ne sont recalculees que si ses passages
+ * aux portes changent (secteurs modifies). Les tours nouveaux sont traites
+ * en parallele (QtConcurrent), puis les repartitions sont recalculees sur
+ * l'ensemble des tours. update() ne relit la base que pour les tours
+ * importes depuis le dernier appel et oublie les tours supprimes.
+ *
+ *     SectorStatistics& stats = SectorStatistics::forCompetition(competition);
+ *     stats.update();
+ *     Distribution d = stats.distribution(0, SectorStatistics::MaxSpeed);
+ */
+class SectorStatistics
+{
+    public:
+
+        enum Metric
+        {
+            SectorTime     = 0, // s
+            MinSpeed       = 1, // km/h
+            MaxSpeed       = 2, // km/h
+            TractionEnergy = 3, // J/kg
+            BrakingEnergy  = 4, // J/kg
+            MetricCount    = 5
+        };
+
+        explicit SectorStatistics(const QString& competition = QString());
+
+        QString competition(void) const;
+        SectorTiming& timing(void) const;
+
+        int sectorCount(void) const;
+        int lapCount(void) const;
+
+        qreal bestLap(void) const;            // meilleur tour complet (s)
+        qreal theoreticalBestLap(void) const; // somme des meilleurs secteurs
+
+        /* Repartition d'une mesure dans un secteur ; sector == sectorCount()
+         * designe le tour complet */
+        Distribution distribution(int sector, Metric metric) const;
+
+        bool update(void);
+        void reset(void);
+
+        static SectorStatistics& forCompetition(const QString& competition);
+
+        /* Mesures d'un tour : MetricCount valeurs par secteur puis pour le
+         * tour complet, NaN quand un passage ou la vitesse manque */
+        static QVector<qreal> lapMetrics(const TelemetrySeries& speed,
+                                         const QVector<qreal>& crossings);
+
+    protected:
+
+        typedef QPair<int, int> LapKey;
+
+        struct LapEntry
+        {
+            TelemetrySeries speed;    // time : s, y : km/h
+            QVector<qreal> crossings; // passages utilises pour les mesures
+            QVector<qreal> metrics;
+        };
+
+        bool loadSpeeds(const QList<LapKey>& laps);
+        void aggregate(void);
+
+        static void measure(const TelemetrySeries& speed, qreal from, qreal to,
+                            qreal* metrics);
+        static qreal speedAt(const TelemetrySeries& speed, qreal time);
+        static bool sameCrossings(const QVector<qreal>& a,
+                                  const QVector<qreal>& b);
+
+        QString _competition;
+        int _sectorCount;
+        QHash<LapKey, LapEntry> _laps;
+        QVector<Distribution> _distributions; // [secteur * MetricCount + mesure]
+        qreal _bestLap;
+        qreal _theoreticalBestLap;
+
+        static QHash<QString, SectorStatistics> _cache;
+};
+
+#endif /* __SECTORSTATISTICS_HPP__ */
@@ -0,0 +1,442 @@
+#include "SectorTiming.hpp"
+#include <qmath.h>
+
+#if QT_VERSION >= 0x050000
+#include <QtConcurrent>
+#endif
+
+namespace
+{
+    // Passage des portes d'un tour, appele en parallele par QtConcurrent
+    struct GateCrossings
+    {
+        typedef QVector<qreal> result_type;
+
+        explicit GateCrossings(const QVector<SectorGate>* gates) :
+            gates(gates)
+        {
+        }
+
+        QVector<qreal> operator()(const TelemetrySeries& lap) const
+        {
+            return SectorTiming::crossings(lap, *this->gates);
+        }
+
+        const QVector<SectorGate>* gates;
+    };
+
+    qreal length(const QPointF& v)
+    {
+        return qSqrt(v.x() * v.x() + v.y() * v.y());
+    }
+}
+
+/* -------------------------------------------------------------------------- *
+ *                                 SectorGate                                 *
+ * -------------------------------------------------------------------------- */
+
+SectorGate::SectorGate(void) :
+    _halfWidth(0)
+{
+}
+
+SectorGate::SectorGate(const QPointF& point, const QPointF& tangent,
+                       qreal halfWidth) :
+    _halfWidth(halfWidth)
+{
+    qreal norm = length(tangent);
+    this->_direction = norm > 0 ? tangent / norm : QPointF(1, 0);
+
+    // Coordonnees de projection : la largeur est convertie en degres
+    QPointF normal(-this->_direction.y(), this->_direction.x());
+    normal *= halfWidth * GeoCoordinate::getDegreeEquivalence(1);
+
+    this->_line = QLineF(point - normal, point + normal);
+}
+
+qreal SectorGate::crossing(const QPointF& p0, qreal t0,
+                           const QPointF& p1, qreal t1) const
+{
+    QPointF move = p1 - p0;
+
+    if (move.x() * this->_direction.x() + move.y() * this->_direction.y() <= 0)
+        return qQNaN();
+
+    QPointF intersection;
+    if (QLineF(p0, p1).intersect(this->_line, &intersection)
+            != QLineF::BoundedIntersection)
+        return qQNaN();
+
+    qreal ratio = length(intersection - p0) / length(move);
+    return t0 + ratio * (t1 - t0);
+}
+
+QPointF SectorGate::point(void) const
+{
+    return this->_line.pointAt(0.5);
+}
+
+qreal SectorGate::halfWidth(void) const
+{
+    return this->_halfWidth;
+}
+
+/* -------------------------------------------------------------------------- *
+ *                               LapSectorTimes                               *
+ * -------------------------------------------------------------------------- */
+
+LapSectorTimes::LapSectorTimes(int race, int raceNum, int lap) :
+    race(race), raceNum(raceNum), lap(lap)
+{
+}
+
+qreal LapSectorTimes::total(void) const
+{
+    if (this->sectors.isEmpty())
+        return qQNaN();
+
+    qreal total(0);
+    foreach (qreal time, this->sectors)
+        total += time; // NaN si un secteur manque
+
+    return total;
+}
+
+/* -------------------------------------------------------------------------- *
+ *                                SectorTiming                                *
+ * -------------------------------------------------------------------------- */
+
+QHash<QString, SectorTiming> SectorTiming::_cache;
+
+SectorTiming::SectorTiming(const QString& competition) :
+    _competition(competition), _gatesLoaded(false)
+{
+}
+
+QString SectorTiming::competition(void) const
+{
+    return this->_competition;
+}
+
+int SectorTiming::sectorCount(void) const
+{
+    return qMax(0, this->_gates.size() - 1);
+}
+
+const QList<LapSectorTimes>& SectorTiming::laps(void) const
+{
+    return this->_laps;
+}
+
+QVector<qreal> SectorTiming::bestSectors(void) const
+{
+    QVector<qreal> best(this->sectorCount(), qQNaN());
+
+    foreach (const LapSectorTimes& lap, this->_laps)
+        for (int s(0); s < lap.sectors.size() && s < best.size(); ++s)
+            if (!qIsNaN(lap.sectors.at(s))
+                    && (qIsNaN(best.at(s)) || lap.sectors.at(s) < best.at(s)))
+                best[s] = lap.sectors.at(s);
+
+    return best;
+}
+
+void SectorTiming::reset(void)
+{
+    this->_gatesLoaded = false;
+    this->_gates.clear();
+    this->_laps.clear();
+}
+
+bool SectorTiming::update(void)
+{
+    TRACE_SCOPE("sql", "SectorTiming::update");
+
+    if (!this->_gatesLoaded && !this->loadGates())
+        return false;
+
+    if (this->_gates.size() < 2)
+    {
+        this->_laps.clear();
+        return true;
+    }
+
+    QHash<int, int> raceNums;
+    QList< QPair<int, int> > laps = this->lapsInDataBase(raceNums);
+    QSet< QPair<int, int> > present = laps.toSet();
+
+    // Tours supprimes depuis le dernier calcul
+    QSet< QPair<int, int> > computed;
+    for (int i(0); i < this->_laps.size(); ++i)
+    {
+        QPair<int, int> key(this->_laps.at(i).race, this->_laps.at(i).lap);
+
+        if (present.contains(key))
+            computed.insert(key);
+        else
+            this->_laps.removeAt(i--);
+    }
+
+    // Tours importes depuis le dernier calcul
+    QSet< QPair<int, int> > missing = present - computed;
+    if (missing.isEmpty())
+        return true;
+
+    QSet<int> races;
+    typedef QPair<int, int> LapKey;
+    foreach (const LapKey& key, missing)
+        races.insert(key.first);
+
+    QStringList placeholders;
+    for (int i(0); i < races.size(); ++i)
+        placeholders << "?";
+
+    // Positions de tous les tours a calculer, en une requete
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select ref_lap_race, ref_lap_num, longitude, latitude, timestamp from POSITION "
+                  "where ref_lap_race in (" + placeholders.join(", ") + ") "
+                  "order by ref_lap_race, ref_lap_num, timestamp");
+
+    foreach (int race, races)
+        query.addBindValue(race);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastQuery() << query.lastError().text();
+        return false;
+    }
+
+    QVector<TelemetrySeries> series;
+    QList<LapSectorTimes> rows;
+    QSet<LapKey> positioned;
+    TelemetrySeriesBuilder builder;
+    LapKey current(-1, -1);
+
+    while (query.next())
+    {
+        LapKey key(query.value(0).toInt(), query.value(1).toInt());
+
+        if (key != current)
+        {
+            if (builder.size() > 0)
+                series << builder.take();
+
+            current = key;
+
+            if (missing.contains(key))
+            {
+                rows << LapSectorTimes(key.first, raceNums.value(key.first),
+                                       key.second);
+                positioned.insert(key);
+            }
+        }
+
+        if (!missing.contains(key))
+            continue;
+
+        GeoCoordinate coord;
+        coord.setLongitude(query.value(2).toFloat());
+        coord.setLatitude(query.value(3).toFloat());
+
+        float time = query.value(4).toFloat() / 1000;
+        builder.append(time, coord.projection(), time);
+    }
+
+    if (builder.size() > 0)
+        series << builder.take();
+
+    // Une serie par tour ayant des positions
+    if (series.size() != rows.size())
+    {
+        qWarning() << "SectorTiming : positions incoherentes";
+        return false;
+    }
+
+    QVector< QVector<qreal> > crossings =
+            QtConcurrent::blockingMapped< QVector< QVector<qreal> > >(
+                series, GateCrossings(&this->_gates));
+
+    for (int i(0); i < rows.size(); ++i)
+    {
+        LapSectorTimes& row = rows[i];
+        row.crossings = crossings.at(i);
+        row.sectors.resize(this->sectorCount());
+
+        for (int s(0); s < row.sectors.size(); ++s)
+            row.sectors[s] = row.crossings.at(s + 1) - row.crossings.at(s);
+
+        this->_laps << row;
+    }
+
+    /* Tours sans position : ligne vide, pour qu'ils comptent comme calcules
+     * et ne relancent pas la requete a chaque appel */
+    foreach (const LapKey& key, missing - positioned)
+    {
+        LapSectorTimes row(key.first, raceNums.value(key.first), key.second);
+        row.crossings.fill(qQNaN(), this->_gates.size());
+        row.sectors.fill(qQNaN(), this->sectorCount());
+
+        this->_laps << row;
+    }
+
+    // Ordre stable : course puis tour
+    QMap<LapKey, LapSectorTimes> sorted;
+    foreach (const LapSectorTimes& lap, this->_laps)
+        sorted.insert(LapKey(lap.race, lap.lap), lap);
+    this->_laps = sorted.values();
+
+    return true;
+}
+
+QVector<qreal> SectorTiming::crossings(const TelemetrySeries& lap,
+                                       const QVector<SectorGate>& gates)
+{
+    QVector<qreal> times(gates.size(), qQNaN());
+    int size = lap.size();
+
+    if (size < 2)
+        return times;
+
+    /* Les portes sont franchies dans l'ordre : chacune est cherchee a partir
+     * du segment de la precedente. Sur un circuit ferme la premiere et la
+     * derniere porte sont au meme endroit : la premiere n'est cherchee que
+     * dans la premiere moitie du tour */
+    int cursor(0);
+
+    for (int g(0); g < gates.size(); ++g)
+    {
+        const SectorGate& gate = gates.at(g);
+        int end = (g == 0) ? size / 2 : size - 1;
+
+        for (int i(cursor); i < end && qIsNaN(times.at(g)); ++i)
+        {
+            times[g] = gate.crossing(lap.point(i), lap.time(i),
+                                     lap.point(i + 1), lap.time(i + 1));
+
+            if (!qIsNaN(times.at(g)))
+                cursor = i;
+        }
+
+        if (!qIsNaN(times.at(g)))
+            continue;
+
+        /* Tour coupe sur la porte de depart ou d'arrivee : le premier (ou
+         * dernier) point, s'il est a cote de la porte, en tient lieu */
+        int border = (g == 0) ? 0 : (g == gates.size() - 1 ? size - 1 : -1);
+
+        if (border >= 0)
+        {
+            qreal distance = length(lap.point(border) - gate.point())
+                             / GeoCoordinate::getDegreeEquivalence(1);
+
+            if (distance <= gate.halfWidth())
+                times[g] = lap.time(border);
+        }
+    }
+
+    return times;
+}
+
+bool SectorTiming::loadGates(void)
+{
+    this->_gates.clear();
+
+    QSqlQuery query;
+    query.prepare("select start_pos, end_pos from SECTOR where ref_compet = ? order by num");
+    query.addBindValue(this->_competition);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastQuery() << query.lastError().text();
+        return false;
+    }
+
+    // Debut de chaque secteur puis fin du dernier
+    QList<int> boundaries;
+    int end(-1);
+
+    while (query.next())
+    {
+        boundaries << query.value(0).toInt();
+        end = query.value(1).toInt();
+    }
+
+    if (end >= 0)
+        boundaries << end;
+
+    if (boundaries.size() >= 2)
+    {
+        QVector<int> positionIds;
+        TelemetrySeries reference = LapSeries::referenceTrack(this->_competition,
+                                                              &positionIds);
+
+        QHash<int, int> indexes; // id de POSITION -> point de la reference
+        for (int i(0); i < positionIds.size(); ++i)
+            indexes.insert(positionIds.at(i), i);
+
+        foreach (int id, boundaries)
+        {
+            int i = indexes.value(id, -1);
+
+            if (i < 0)
+            {
+                qWarning() << "SectorTiming : limite de secteur inconnue" << id;
+                this->_gates.clear();
+                return false;
+            }
+
+            QPointF tangent = reference.point(qMin(i + 1, reference.size() - 1))
+                            - reference.point(qMax(i - 1, 0));
+            this->_gates << SectorGate(reference.point(i), tangent,
+                                       SECTOR_GATE_HALF_WIDTH);
+        }
+    }
+
+    this->_gatesLoaded = true;
+    return true;
+}
+
+QList< QPair<int, int> > SectorTiming::lapsInDataBase(
+        QHash<int, int>& raceNums) const
+{
+    QList< QPair<int, int> > laps;
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("select LAP.ref_race, LAP.num, RACE.num from LAP "
+                  "join RACE on RACE.id = LAP.ref_race "
+                  "where RACE.ref_compet = ?");
+    query.addBindValue(this->_competition);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastQuery() << query.lastError().text();
+        return laps;
+    }
+
+    while (query.next())
+    {
+        laps << qMakePair(query.value(0).toInt(), query.value(1).toInt());
+        raceNums.insert(query.value(0).toInt(), query.value(2).toInt());
+    }
+
+    return laps;
+}
+
+SectorTiming& SectorTiming::forCompetition(const QString& competition)
+{
+    // Les numeros de course et de tour ne valent que pour une base
+    QString key = QSqlDatabase::database().databaseName() + "/" + competition;
+
+    QHash<QString, SectorTiming>::iterator it = _cache.find(key);
+    if (it == _cache.end())
+        it = _cache.insert(key, SectorTiming(competition));
+
+    return it.value();
+}
+
+void SectorTiming::resetCompetition(const QString& competition)
+{
+    forCompetition(competition).reset();
+}
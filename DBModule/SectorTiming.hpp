@@ -0,0 +1,105 @@
+#ifndef __SECTORTIMING_HPP__
+#define __SECTORTIMING_HPP__
+
+#include "GeoCoordinate.hpp"
+#include "LapSeries.hpp"
+#include "../Common/TelemetrySeries.hpp"
+#include "../Utils/Trace.hpp"
+#include <QtCore>
+#include <QtSql>
+
+// Demi-largeur des portes placees aux limites des secteurs (m)
+#define SECTOR_GATE_HALF_WIDTH 25
+
+/* Porte de chronometrage : segment perpendiculaire au tour de reference,
+ * franchi dans le sens de la course */
+class SectorGate
+{
+    public:
+
+        SectorGate(void);
+        SectorGate(const QPointF& point, const QPointF& tangent,
+                   qreal halfWidth);
+
+        /* Instant (s) ou le segment [t0, t1] franchit la porte, NaN s'il ne
+         * la franchit pas dans le sens de la course */
+        qreal crossing(const QPointF& p0, qreal t0,
+                       const QPointF& p1, qreal t1) const;
+
+        QPointF point(void) const;
+        qreal halfWidth(void) const;
+
+    protected:
+
+        QLineF _line;
+        QPointF _direction;
+        qreal _halfWidth;
+};
+
+/* Temps d'un tour dans chaque secteur */
+class LapSectorTimes
+{
+    public:
+
+        LapSectorTimes(int race = -1, int raceNum = -1, int lap = -1);
+
+        int race;                 // id de la course
+        int raceNum;              // numero de la course (affichage)
+        int lap;                  // numero du tour
+        QVector<qreal> crossings; // passage de chaque porte (s), NaN si absent
+        QVector<qreal> sectors;   // temps de chaque secteur (s), NaN si absent
+
+        qreal total(void) const;  // NaN si un secteur manque
+};
+
+/* Temps par secteur de tous les tours d'une competition.
+ *
+ * Une porte est placee au debut de chaque secteur et a la fin du dernier,
+ * sur le tour de reference. Pour chaque tour, les portes sont cherchees
+ * dans l'ordre le long du trace GPS (intersection de segments, instant
+ * interpole) : un seul parcours du tour. Les tours sont traites en
+ * parallele (QtConcurrent) une fois leurs positions lues en une requete.
+ *
+ * Le resultat est garde par competition : update() ne calcule que les tours
+ * importes depuis le dernier appel et oublie les tours supprimes. reset()
+ * force un nouveau calcul complet quand les secteurs changent.
+ *
+ *     SectorTiming& timing = SectorTiming::forCompetition(competition);
+ *     timing.update();
+ *     foreach (const LapSectorTimes& lap, timing.laps()) ...
+ */
+class SectorTiming
+{
+    public:
+
+        explicit SectorTiming(const QString& competition = QString());
+
+        QString competition(void) const;
+        int sectorCount(void) const;
+        const QList<LapSectorTimes>& laps(void) const;
+        QVector<qreal> bestSectors(void) const;
+
+        bool update(void);
+        void reset(void);
+
+        // Instance gardee pour la competition dans la base courante
+        static SectorTiming& forCompetition(const QString& competition);
+        static void resetCompetition(const QString& competition);
+
+        static QVector<qreal> crossings(const TelemetrySeries& lap,
+                                        const QVector<SectorGate>& gates);
+
+    protected:
+
+        bool loadGates(void);
+        QList< QPair<int, int> > lapsInDataBase(QHash<int, int>& raceNums) const;
+
+        QString _competition;
+        bool _gatesLoaded;
+        QVector<SectorGate> _gates;
+        QList<LapSectorTimes> _laps;
+
+        static QHash<QString, SectorTiming> _cache;
+};
+
+#endif /* __SECTORTIMING_HPP__ */
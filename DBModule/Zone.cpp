@@ -29,7 +29,7 @@ void Zone::add(DataPoint* dp)
     {
         int diff = dp->index() - points.last()->index();
 
-        qDebug() << "[" << diff << "]";
+        LOG_DEBUG(logLapDetector) << "[" << diff << "]";
 
         diffs.append(diff);
         points.append(dp);
@@ -2,6 +2,7 @@
 #define __ZONE_HPP__
 
 #include "DataPoint.hpp"
+#include "../Utils/Log.hpp"
 #include <QtGui>
 
 class Zone
@@ -6,11 +6,17 @@
 
 QT       += core gui sql
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 TARGET = EcoManager2013
 TEMPLATE = app
 
+# Instrumentation (Utils/Trace.hpp) : decommenter pour la retirer du binaire
+# DEFINES += ECO_NO_TRACE
+
+# Niveau de journalisation compile (Utils/Log.hpp), debug en release :
+# DEFINES += ECO_LOG_LEVEL=0
+
 
 SOURCES += main.cpp\
         MainWindow.cpp \
@@ -18,11 +24,20 @@ SOURCES += main.cpp\
     Map/SampleLapViewer.cpp \
     Map/MapView.cpp \
     Common/IndexedPosition.cpp \
+    Common/TelemetrySeries.cpp \
+    Common/LapResampler.cpp \
+    Common/LapDelta.cpp \
     Common/CoordinateItem.cpp \
+    Common/HighlightItem.cpp \
+    Common/LapReplay.cpp \
     Map/SectorItem.cpp \
-    Map/CurvePathBuilder.cpp \
+    Map/SectorGeometry.cpp \
     Map/AnimateSectorItem.cpp \
     Map/TrackItem.cpp \
+    Map/HeatTrackItem.cpp \
+    Map/DensityRaster.cpp \
+    Map/TrackGeometry.cpp \
+    Map/TrackPathItem.cpp \
     Map/TickItem.cpp \
     Map/PathBuilder.cpp \
     Map/MapScene.cpp \
@@ -31,9 +46,18 @@ SOURCES += main.cpp\
     Map/MapFrame.cpp \
     DBModule/DataPoint.cpp \
     DBModule/ExportModule.cpp \
+    DBModule/LapDataRows.cpp \
     DBModule/Zone.cpp \
     DBModule/Race.cpp \
     DBModule/LapDetector.cpp \
+    DBModule/LapChannel.cpp \
+    DBModule/ChannelRegistry.cpp \
+    DBModule/ChannelStore.cpp \
+    DBModule/LapSeries.cpp \
+    DBModule/SectorTiming.cpp \
+    DBModule/SectorStatistics.cpp \
+    DBModule/SectorEditSession.cpp \
+    DBModule/SectorEditModel.cpp \
     ExtensibleEllipseItem.cpp \
     RaceViewer.cpp \
     DBModule/ImportModule.cpp \
@@ -47,6 +71,8 @@ SOURCES += main.cpp\
     Plot/HorizontalScale.cpp \
     Plot/VerticalScale.cpp \
     Plot/PlotView.cpp \
+    Plot/AxisLink.cpp \
+    Plot/CurveGeometry.cpp \
     Plot/PlotCurve.cpp \
     Common/TreeLapInformationModel.cpp \
     Common/TreeNode.cpp \
@@ -56,21 +82,36 @@ SOURCES += main.cpp\
     Common/LapInformationTreeModel.cpp \
     Common/TreeElement.cpp \
     LapDataCompartor.cpp \
+    SectorTimesDialog.cpp \
     Plot/PlotPrintDialog.cpp \
     Utils/QException.cpp \
     Utils/DataBaseManager.cpp \
-    Utils/QCSVParser.cpp
+    Utils/QCSVParser.cpp \
+    Utils/QCSVWriter.cpp \
+    Utils/QCSVTable.cpp \
+    Utils/QCSVReader.cpp \
+    Utils/Trace.cpp \
+    Utils/Log.cpp
 
 HEADERS  += MainWindow.hpp \
     CompetitionEntryDialog.hpp \
     Map/SampleLapViewer.hpp \
     Map/MapView.hpp \
     Common/IndexedPosition.hpp \
+    Common/TelemetrySeries.hpp \
+    Common/LapResampler.hpp \
+    Common/LapDelta.hpp \
     Common/CoordinateItem.hpp \
+    Common/HighlightItem.hpp \
+    Common/LapReplay.hpp \
     Map/SectorItem.hpp \
-    Map/CurvePathBuilder.hpp \
+    Map/SectorGeometry.hpp \
     Map/AnimateSectorItem.hpp \
     Map/TrackItem.hpp \
+    Map/HeatTrackItem.hpp \
+    Map/DensityRaster.hpp \
+    Map/TrackGeometry.hpp \
+    Map/TrackPathItem.hpp \
     Map/TickItem.hpp \
     Map/PathBuilder.hpp \
     Map/MapScene.hpp \
@@ -79,9 +120,18 @@ HEADERS  += MainWindow.hpp \
     Map/MapFrame.hpp \
     DBModule/DataPoint.hpp \
     DBModule/ExportModule.hpp \
+    DBModule/LapDataRows.hpp \
     DBModule/Zone.hpp \
     DBModule/Race.hpp \
     DBModule/LapDetector.hpp \
+    DBModule/LapChannel.hpp \
+    DBModule/ChannelRegistry.hpp \
+    DBModule/ChannelStore.hpp \
+    DBModule/LapSeries.hpp \
+    DBModule/SectorTiming.hpp \
+    DBModule/SectorStatistics.hpp \
+    DBModule/SectorEditSession.hpp \
+    DBModule/SectorEditModel.hpp \
     ExtensibleEllipseItem.hpp \
     RaceViewer.hpp \
     DBModule/ImportModule.hpp \
@@ -95,6 +145,8 @@ HEADERS  += MainWindow.hpp \
     Plot/HorizontalScale.hpp \
     Plot/VerticalScale.hpp \
     Plot/PlotView.hpp \
+    Plot/AxisLink.hpp \
+    Plot/CurveGeometry.hpp \
     Plot/PlotCurve.hpp \
     Common/TreeLapInformationModel.hpp \
     Common/TreeNode.hpp \
@@ -104,10 +156,16 @@ HEADERS  += MainWindow.hpp \
     Common/LapInformationTreeModel.hpp \
     Common/TreeElement.hpp \
     LapDataCompartor.hpp \
+    SectorTimesDialog.hpp \
     Plot/PlotPrintDialog.hpp \
     Utils/QException.hpp \
     Utils/DataBaseManager.hpp \
-    Utils/QCSVParser.hpp
+    Utils/QCSVParser.hpp \
+    Utils/QCSVWriter.hpp \
+    Utils/QCSVTable.hpp \
+    Utils/QCSVReader.hpp \
+    Utils/Trace.hpp \
+    Utils/Log.hpp
 
 FORMS    += MainWindow.ui \
     CompetitionEntryDialog.ui \
@@ -115,6 +173,7 @@ FORMS    += MainWindow.ui \
     Map/MapFrame.ui \
     Plot/PlotFrame.ui \
     LapDataCompartor.ui \
+    SectorTimesDialog.ui \
     Plot/PlotPrintDialog.ui
 
 RESOURCES += \
@@ -92,12 +92,64 @@ void LapDataCompartor::addLapsData(const QList<QVariant>& dataLap1,
     this->ui->lapDataTreeView->expandAll();
 }
 
+void LapDataCompartor::addAlignedLapsData(int race1, int lap1,
+                                          const QList<QVariant>& dataLap1,
+                                          int race2, int lap2,
+                                          const QList<QVariant>& dataLap2,
+                                          double wheelPerimeter)
+{
+    // Remove laps information from the table
+    this->lapDataTableModel->removeRows(0, this->lapDataTableModel->rowCount());
+
+    this->lapDataTableModel->addRaceInformation(race1, lap1, dataLap1);
+    this->lapDataTableModel->addRaceInformation(race2, lap2, dataLap2);
+
+    QString title = "Comparaison du tour " + QString::number(lap1)
+                  + " de la course " + QString::number(race1)
+                  + " avec le tour " + QString::number(lap2)
+                  + " de la course " + QString::number(race2);
+    this->setWindowTitle(title);
+
+    // L'accélération entre deux tours différents n'a pas de sens
+    this->ui->accelerationLabel->setVisible(false);
+    this->ui->accelerationDoubleSpinBox->setVisible(false);
+
+    this->ui->distanceDifferenceDoubleSpinBox->setValue(
+                dataLap2.at(DISTANCE_COLUMN).toDouble()
+                - dataLap1.at(DISTANCE_COLUMN).toDouble());
+
+    // Alignement des deux tours sur la distance, un point par metre
+    LapResampler resampler;
+    resampler.addLap(LapSeries::distanceSpeed(race1, lap1, wheelPerimeter));
+    resampler.addLap(LapSeries::distanceSpeed(race2, lap2, wheelPerimeter));
+
+    if (resampler.lapCount() != 2 || !resampler.resample(1.0))
+    {
+        this->ui->lapDataTreeView->expandAll();
+        return;
+    }
+
+    int i = resampler.gridIndex(dataLap1.at(DISTANCE_COLUMN).toDouble());
+
+    qreal timeGap = resampler.values(1, LapResampler::TimeChannel).at(i)
+                  - resampler.values(0, LapResampler::TimeChannel).at(i);
+    qreal speedGap = resampler.values(1, LapResampler::ValueChannel).at(i)
+                   - resampler.values(0, LapResampler::ValueChannel).at(i);
+
+    this->ui->timeDifferenceMsDoubleSpinBox->setValue(qRound(timeGap * 1000));
+    this->ui->timeDifferenceSDoubleSpinBox->setValue(timeGap);
+    this->ui->speedDifferenceDoubleSpinBox->setValue(speedGap);
+
+    this->ui->lapDataTreeView->expandAll();
+}
+
 void LapDataCompartor::createTableModel(void)
 {
     // Create the model for the table of laps information
     QStringList headers;
     headers << tr("Course") << tr("Tps(ms)") << tr("Tps(s)") << tr("Dist(m)")
-            << tr("v(km\\h)") << tr("Acc (m\\s2)") << tr("RPM") << tr("PW");
+            << tr("v(km\\h)") << tr("Acc (m\\s2)")
+            << ChannelRegistry::tableChannels();
     this->lapDataTableModel = new LapInformationTreeModel(headers);
 
     /* Use a proxy model to manage background color of each row and manage
@@ -8,6 +8,9 @@
 
 #include "Common/LapInformationTreeModel.hpp"
 #include "LapInformationProxyModel.hpp"
+#include "Common/LapResampler.hpp"
+#include "DBModule/ChannelRegistry.hpp"
+#include "DBModule/LapSeries.hpp"
 #include <QtGui>
 
 namespace Ui {
@@ -27,6 +30,15 @@ class LapDataCompartor : public QDialog
         void addLapsData(const QList<QVariant>& dataLap1,
                          const QList<QVariant>& dataLap2);
 
+        /* Compare deux lignes de tours differents : les tours sont alignes
+         * sur la distance et les ecarts de temps et de vitesse sont ceux
+         * des deux tours a la distance de la premiere ligne */
+        void addAlignedLapsData(int race1, int lap1,
+                                const QList<QVariant>& dataLap1,
+                                int race2, int lap2,
+                                const QList<QVariant>& dataLap2,
+                                double wheelPerimeter);
+
     private:
 
         void createTableModel(void);
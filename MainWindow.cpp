@@ -1,11 +1,16 @@
 #include "MainWindow.hpp"
 #include "ui_MainWindow.h"
+#include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent), ui(new Ui::MainWindow),
     competitionBox(NULL), mapFrame(NULL), distancePlotFrame(NULL),
-    timePlotFrame(NULL), megaSquirtPlotFrame(NULL), sectorModel(NULL),
-    competitionNameModel(NULL), competitionModel(NULL),
+    timePlotFrame(NULL), megaSquirtPlotFrame(NULL), deltaPlotFrame(NULL),
+    timeAxisLink(NULL), distanceAxisLink(NULL),
+    lapReplay(NULL), replaySlider(NULL), replaySpeedBox(NULL),
+    sectorModel(NULL),
+    competitionNameModel(NULL), megaSquirtChannelModel(NULL),
+    competitionModel(NULL),
     raceInformationTableModel(NULL)
 {
     QCoreApplication::setOrganizationName("EcoMotion");
@@ -27,6 +32,7 @@ MainWindow::MainWindow(QWidget *parent) :
     this->createMapZone();
     this->createPlotZone();
     this->createMegaSquirtZone();
+    this->linkPlotAxes();
     this->createToolsBar();
 
     // Connect all the signals
@@ -45,7 +51,7 @@ MainWindow::~MainWindow(void)
 }
 
 /* Interception des events clavier emis sur la sectorView afin de pouvoir repercuter
- * la suppression logique d'un secteur sur la BD */
+ * la suppression d'un secteur sur la carte (fusion avec le secteur precedent) */
 bool MainWindow::eventFilter(QObject* src, QEvent* event)
 {
     if (src == this->ui->sectorView && event->type() == QEvent::KeyRelease)
@@ -67,10 +73,10 @@ bool MainWindow::eventFilter(QObject* src, QEvent* event)
 
             QModelIndex selectedSector = selectedRows.first();
 
+            // The rows of the sector view are the sectors of the map, in order
             if (selectedSector.isValid())
             {
-                QSqlRecord sectorRec = sectorModel->record(selectedSector.row());
-                int numSect = sectorRec.value(sectorModel->fieldIndex("num")).toInt();
+                int numSect = selectedSector.row();
                 this->mapFrame->scene()->mergeSector(numSect - 1, numSect);
             }
         }
@@ -86,6 +92,8 @@ void MainWindow::on_actionAboutQt_triggered(void)
 
 void MainWindow::on_actionQuit_triggered(void)
 {
+    this->commitSectorEdits();
+
     // Save the state of the mainWindow and its widgets
     this->writeSettings("MainWindow");
 
@@ -175,8 +183,47 @@ void MainWindow::on_actionExportConfigurationModule_triggered(void)
 
 void MainWindow::on_actionExportData_triggered(void)
 {
-    QMessageBox::information(this, "Action Export Data",
-                             "Exportation de données ...");
+    QStringList choices;
+    QSqlQuery query("select name from COMPETITION");
+    query.exec();
+
+    while (query.next())
+        choices << query.value(0).toString();
+
+    if (choices.isEmpty())
+        return;
+
+    bool ok;
+    QString nameCompet = QInputDialog::getItem(
+                this, tr("Nom de la compétition"), QString(), choices,
+                qMax(0, choices.indexOf(this->currentCompetition)), false, &ok);
+
+    if (!ok || nameCompet.isEmpty())
+        return;
+
+    QString filepath = QFileDialog::getSaveFileName(
+                this, tr("Choisir où sauvegarder les données de la compétition"),
+                QDir::homePath(), tr("Fichier CSV (*.csv)"));
+
+    if (filepath.isEmpty()) // User canceled
+        return;
+
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        QMessageBox::warning(this, tr("Impossible d'exporter les données"),
+                             file.errorString());
+        return;
+    }
+
+    // Tous les tours de la compétition en un seul passage
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool exported = ExportModule::buildCompetitionDataOutput(nameCompet, &file);
+    QApplication::restoreOverrideCursor();
+
+    if (!exported)
+        QMessageBox::warning(this, tr("Impossible d'exporter les données"),
+                             tr("Erreur lors de la récupération des données"));
 }
 
 /* Event that occured when the user double click on a race tree view item
@@ -201,8 +248,9 @@ void MainWindow::on_actionDelimitingSectors_triggered(void)
     dial->setModal(true);
     dial->resize(650, 400);
 
-    // if the user choose a new sample lap
-    if (dial->exec())
+    /* if the user choose a new sample lap. The pending edits are written
+     * first: they refer to the sectors about to be replaced */
+    if (dial->exec() && this->commitSectorEdits())
     {
         // Get track identifier
         QPair<int, int> refLap = dial->selectedReferencesLap();
@@ -254,6 +302,9 @@ void MainWindow::on_actionDelimitingSectors_triggered(void)
             }
             else
             {
+                // Sector times must be computed again with the new gates
+                SectorTiming::resetCompetition(currentCompetition);
+
                 // Erase previous sectors from the map scene
                 if (this->mapFrame->scene()->hasSectors())
                     this->mapFrame->scene()->clearSectors();
@@ -361,6 +412,7 @@ void MainWindow::on_actionLapDataEraseTable_triggered(void)
     // Erase all highlited point on the mapping view
     this->distancePlotFrame->scene()->clearPlotSelection();
     this->timePlotFrame->scene()->clearPlotSelection();
+    this->deltaPlotFrame->scene()->clearPlotSelection();
 
     // Remove laps information from the table
     this->raceInformationTableModel->removeRows(
@@ -379,28 +431,110 @@ void MainWindow::on_actionClearAllData_triggered(void)
 {
     qDebug() << "On efface tout";
 
+    // Nothing left to replay
+    this->on_actionStopReplay_triggered();
+
     // Clear the tracks of the mapping view
     this->mapFrame->scene()->clearTracks();
 
     // clear the curves of the graphic views
     this->distancePlotFrame->scene()->clearCurves();
     this->timePlotFrame->scene()->clearCurves();
+    this->megaSquirtPlotFrame->scene()->clearCurves();
+    this->deltaPlotFrame->scene()->clearCurves();
 
     // Clear the list of all tracks currently displayed
     this->currentTracksDisplayed.clear();
 
+    // No channel left: the MegaSquirt axes are hidden
+    foreach (VerticalScale* axis, this->megaSquirtAxes)
+        axis->setVisible(false);
+
+    // No more reference lap for the delta time
+    this->lapDelta.clear();
+    this->deltaReference.clear();
+    this->deltaDistanceSeries.clear();
+
     // Remove laps information from the table
     this->on_actionLapDataEraseTable_triggered();
 
+    // Pending sector edits are written before the sectors are cleared
+    this->commitSectorEdits();
+    this->sectorSession = SectorEditSession();
+    this->updateSectorEditActions();
+
     this->mapFrame->scene()->clearSectors(); // clear sectors
 
     // clear the sector view
-    if (this->sectorModel)
+    this->sectorModel->refresh();
+    this->ui->sectorView->setVisible(false);
+}
+
+void MainWindow::on_actionSectorTimes_triggered(void)
+{
+    if (this->currentCompetition.isEmpty())
+    {
+        QMessageBox::information(this, tr("Temps par secteur"),
+                                 tr("Aucune compétition sélectionnée"));
+        return;
+    }
+
+    // The gates are read from the data base
+    if (!this->commitSectorEdits())
+        return;
+
+    // Only the laps imported since the last call are computed
+    SectorStatistics& statistics =
+            SectorStatistics::forCompetition(this->currentCompetition);
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool updated = statistics.update();
+    QApplication::restoreOverrideCursor();
+
+    if (!updated)
     {
-        this->ui->sectorView->setVisible(false);
-        this->sectorModel->clear();
-        this->ui->sectorView->update();
+        QMessageBox::warning(this, tr("Temps par secteur"),
+                             tr("Impossible de calculer les temps par secteur"));
+        return;
     }
+
+    if (statistics.sectorCount() == 0)
+    {
+        QMessageBox::information(this, tr("Temps par secteur"),
+                                 tr("Aucun secteur n'est défini pour la compétition ")
+                                 + this->currentCompetition);
+        return;
+    }
+
+    SectorTimesDialog dialog(statistics, this);
+    dialog.resize(700, 450);
+    dialog.exec();
+}
+
+void MainWindow::on_actionRaceViewDisplayDensity_triggered(void)
+{
+    if (this->currentCompetition.isEmpty())
+        return;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    // Every lap of the competition is drawn as a single image
+    QVector<TelemetrySeries> laps =
+            LapSeries::competitionLaps(this->currentCompetition);
+
+    DensityRaster raster(DensityRaster::boundsOf(laps),
+                         GeoCoordinate::getDegreeEquivalence(DENSITY_RASTER_CELL_SIZE));
+    raster.add(laps);
+
+    this->mapFrame->scene()->setDensityLayer(raster.toImage(), raster.bounds());
+    this->mapFrame->showDensityLayer();
+
+    QApplication::restoreOverrideCursor();
+
+    if (laps.isEmpty())
+        QMessageBox::information(this, tr("Densité des tours"),
+                                 tr("Aucun tour n'a été importé pour la compétition ")
+                                 + this->currentCompetition);
 }
 
 void MainWindow::on_raceTable_customContextMenuRequested(const QPoint &pos)
@@ -417,28 +551,39 @@ void MainWindow::on_actionLapDataComparaison_triggered(void)
     if (rowsSelectedIndexes.count() != 2)
         return;
 
-    int lapNum, raceNum;
+    int lapNum[2], raceNum[2];
     QModelIndex LapNumModelIndex;
     QModelIndex RaceNumModelIndex;
 
-    // Get lap and race num for the first selected item
-    LapNumModelIndex  = rowsSelectedIndexes.at(0).parent();
-    RaceNumModelIndex = LapNumModelIndex.parent();
-
-    lapNum = this->raceInformationTableModel->data(
-                this->raceInformationTableModel->index(LapNumModelIndex.row(),
-                                                 0, RaceNumModelIndex)).toInt();
-    raceNum = this->raceInformationTableModel->data(
-                this->raceInformationTableModel->index(RaceNumModelIndex.row(),
-                                                       0)).toInt();
+    // Get lap and race num for each selected item
+    for (int i(0); i < 2; ++i)
+    {
+        LapNumModelIndex  = rowsSelectedIndexes.at(i).parent();
+        RaceNumModelIndex = LapNumModelIndex.parent();
+
+        lapNum[i] = this->raceInformationTableModel->data(
+                    this->raceInformationTableModel->index(
+                        LapNumModelIndex.row(), 0, RaceNumModelIndex)).toInt();
+        raceNum[i] = this->raceInformationTableModel->data(
+                    this->raceInformationTableModel->index(
+                        RaceNumModelIndex.row(), 0)).toInt();
+    }
 
     QVector<QVariant> row1 = this->raceInformationTableModel->rowData(
                 rowsSelectedIndexes.at(0));
     QVector<QVariant> row2 = this->raceInformationTableModel->rowData(
                 rowsSelectedIndexes.at(1));
 
-    LapDataCompartor ldc(raceNum, lapNum, this);
-    ldc.addLapsData(row1.toList(), row2.toList());
+    LapDataCompartor ldc(raceNum[0], lapNum[0], this);
+
+    // Two rows of different laps are compared at the same distance
+    if (rowsSelectedIndexes.at(0).parent() == rowsSelectedIndexes.at(1).parent())
+        ldc.addLapsData(row1.toList(), row2.toList());
+    else
+        ldc.addAlignedLapsData(raceNum[0], lapNum[0], row1.toList(),
+                               raceNum[1], lapNum[1], row2.toList(),
+                               this->getCurrentCompetitionWheelPerimeter());
+
     ldc.exec();
 }
 
@@ -459,21 +604,23 @@ void MainWindow::on_menuLapDataTable_aboutToShow(void)
             this->ui->raceTable->selectionModel()->selectedRows();
 
     bool multipleRowsSelected = rowsSelectedIndexes.count() > 0;
-    bool comparaisonVisible   = rowsSelectedIndexes.count() == 2 &&
+    bool sameLapSelected      = rowsSelectedIndexes.count() == 2 &&
                                 rowsSelectedIndexes.at(0).parent() ==
                                 rowsSelectedIndexes.at(1).parent();
+    bool lapRowsSelected      = rowsSelectedIndexes.count() == 2 &&
+                                rowsSelectedIndexes.at(0).parent().parent().isValid() &&
+                                rowsSelectedIndexes.at(1).parent().parent().isValid();
 
     // Afficher dans toutes les vues
     this->ui->actionLapDataDisplayInAllViews->setVisible(multipleRowsSelected);
 
     // Retirer les données sélectionnées (du tableau et des vues)
-    this->ui->actionLapDataExportToCSV->setVisible(comparaisonVisible);
+    this->ui->actionLapDataExportToCSV->setVisible(sameLapSelected);
 
-    /* On ne porpose de faire une comparaison entre deux données du tableau
-     * si et seulement si ce sont des données issues d'une meme course et
-     * du meme tour */
-    this->ui->actionLapDataComparaison->setVisible(comparaisonVisible);
-    this->ui->actionLapDataDrawSectors->setVisible(comparaisonVisible);
+    /* Deux données d'un même tour sont comparées directement, deux données
+     * de tours différents sont comparées à distance égale */
+    this->ui->actionLapDataComparaison->setVisible(lapRowsSelected);
+    this->ui->actionLapDataDrawSectors->setVisible(sameLapSelected);
 }
 
 void MainWindow::on_actionLapDataSelectAll_triggered(bool checked)
@@ -581,6 +728,7 @@ void MainWindow::on_menuEditRaceView_aboutToShow(void)
     // Par défaut, toutes les actions du menu sont masquées
     this->ui->actionRaceViewDisplayLap->setVisible(false);
     this->ui->actionRaceViewRemoveLap->setVisible(false);
+    this->ui->actionRaceViewSetDeltaReference->setVisible(false);
     this->ui->actionRaceViewExportLapDataInCSV->setVisible(false);
     this->ui->actionRaceViewDeleteRace->setVisible(false);
     this->ui->actionRaceViewDeleteRacesAtSpecificDate->setVisible(false);
@@ -653,6 +801,8 @@ void MainWindow::on_menuEditRaceView_aboutToShow(void)
 
         this->ui->actionRaceViewDisplayLap->setVisible(!lapAlreadyDisplayed);
         this->ui->actionRaceViewRemoveLap->setVisible(lapAlreadyDisplayed);
+        this->ui->actionRaceViewSetDeltaReference->setVisible(
+                    lapAlreadyDisplayed && trackIdentifier != this->deltaReference);
         this->ui->actionRaceViewExportLapDataInCSV->setVisible(true);
 
         this->raceViewItemidentifier = QVariant::fromValue(trackIdentifier);
@@ -697,6 +847,17 @@ void MainWindow::on_actionRaceViewRemoveLap_triggered(void)
     this->removeTrackFromAllView(trackIdentifier);
 }
 
+void MainWindow::on_actionRaceViewSetDeltaReference_triggered(void)
+{
+    /* Vérifie que l'identifiant de l'élément séléctionné dans la liste des
+     * courses est bien celui d'un tour. A savoir un QMap<QString, QVariant> */
+    if(!this->raceViewItemidentifier.canConvert< QMap<QString, QVariant> >())
+        return;
+
+    this->setDeltaReference(
+                this->raceViewItemidentifier.value< QMap<QString, QVariant> >());
+}
+
 void MainWindow::on_actionRaceViewDeleteRace_triggered(void)
 {
     /* Vérifie que l'identifiant de l'élément séléctionné dans la liste des
@@ -877,6 +1038,10 @@ void MainWindow::removeTrackFromAllView(QMap<QString, QVariant> const& trackId)
         qDebug() << "time supprimé !!!";
 
     this->currentTracksDisplayed.removeOne(trackId);
+
+    // The channel ranges may shrink without this lap
+    this->reloadMegaSquirtCurves();
+    this->removeDeltaCurve(trackId);
 }
 
 void MainWindow::on_actionListing_des_courses_triggered(void)
@@ -950,88 +1115,123 @@ void MainWindow::loadCompetition(int index)
 
 void MainWindow::removeSector(const QString &competitionName, int sectorNum)
 {
-    QSqlDatabase::database().driver()->beginTransaction();
+    Q_UNUSED(competitionName);
 
-    QSqlQuery delQuery("delete from sector where ref_compet = ? and num = ?");
-    delQuery.addBindValue(competitionName);
-    delQuery.addBindValue(sectorNum);
+    // Written in the data base by commitSectorEdits
+    this->sectorSession.removeSector(sectorNum);
+}
 
-    if (delQuery.exec())
-    {
-        qDebug() << "sector deleted.";
+void MainWindow::addSector(QString competName, int sectNum,
+                           IndexedPosition firstCoord, IndexedPosition lastCoord)
+{
+    Q_UNUSED(competName);
 
-        QSqlQuery updateNumSect("update SECTOR set num = num - 1 where ref_compet = ? and num > ?");
-        updateNumSect.addBindValue(competitionName);
-        updateNumSect.addBindValue(sectorNum);
+    this->sectorSession.insertSector(sectNum, firstCoord.index(),
+                                     lastCoord.index());
+}
 
-        if (!updateNumSect.exec())
-        {
-            qWarning() << updateNumSect.lastError();
-            QSqlDatabase::database().driver()->rollbackTransaction();
-        }
-        else
-        {
-            QSqlDatabase::database().driver()->commitTransaction();
-            qDebug() << "sector effectively deleted.";
-        }
-    }
-    else
-    {
-        qWarning() << "Unable to delete sector" << delQuery.lastError();
-        QSqlDatabase::database().driver()->rollbackTransaction();
-    }
+void MainWindow::updateSector(QString competName, int sectNum,
+                          IndexedPosition firstCoord, IndexedPosition lastCoord)
+{
+    Q_UNUSED(competName);
 
-    this->sectorModel->select();
-    this->ui->sectorView->setVisible(this->sectorModel->rowCount() > 0);
+    this->sectorSession.updateSector(sectNum, firstCoord.index(),
+                                     lastCoord.index());
 }
 
-void MainWindow::addSector(QString competName, int sectNum,
-                           IndexedPosition firstCoord, IndexedPosition lastCoord)
+void MainWindow::endSectorEdit(const QString& competitionName)
 {
-    QSqlDatabase::database().driver()->beginTransaction();
+    Q_UNUSED(competitionName);
+
+    // The next edits on the map can be undone separately
+    this->sectorSession.endStep();
+    this->updateSectorEditActions();
 
-    QSqlQuery updateNumSect("update SECTOR set num = num + 1 where ref_compet = ? and num >= ?");
-    updateNumSect.addBindValue(competName);
-    updateNumSect.addBindValue(sectNum);
+    // The sector view shows the sectors of the map, saved or not
+    this->sectorModel->refresh();
+    this->ui->sectorView->setVisible(this->sectorSession.count() > 0);
+}
 
-    if (!updateNumSect.exec())
+void MainWindow::on_actionUndoSectorEdit_triggered(void)
+{
+    if (this->sectorSession.undo())
     {
-        QSqlDatabase::database().driver()->rollbackTransaction();
+        this->drawSectors();
+        this->sectorModel->refresh();
     }
-    else
+
+    this->updateSectorEditActions();
+}
+
+void MainWindow::on_actionRedoSectorEdit_triggered(void)
+{
+    if (this->sectorSession.redo())
     {
-        QSqlQuery insertQuery("insert into SECTOR (num, ref_compet, start_pos, end_pos) values (?, ?, ?, ?)");
-        insertQuery.addBindValue(sectNum);
-        insertQuery.addBindValue(competName);
-        insertQuery.addBindValue(firstCoord.index());
-        insertQuery.addBindValue(lastCoord.index());
+        this->drawSectors();
+        this->sectorModel->refresh();
+    }
 
-        if (insertQuery.exec())
-        {
-            QSqlDatabase::database().driver()->commitTransaction();
-        }
-        else
-        {
-            qWarning() << "Unable to insert new sector after : " << insertQuery.lastError();
-            QSqlDatabase::database().driver()->rollbackTransaction();
-        }
+    this->updateSectorEditActions();
+}
+
+void MainWindow::on_actionSaveSectors_triggered(void)
+{
+    this->commitSectorEdits();
+}
+
+void MainWindow::on_actionReplay_triggered(bool checked)
+{
+    if (checked && !this->prepareReplay())
+    {
+        this->ui->actionReplay->setChecked(false);
+        this->statusBar()->showMessage(tr("Aucun tour à relire"), 3000);
+        return;
     }
 
-    this->sectorModel->select();
-    this->ui->sectorView->setVisible(true);
+    this->lapReplay->setRunning(checked);
 }
 
-void MainWindow::updateSector(QString competName, int sectNum,
-                          IndexedPosition firstCoord, IndexedPosition lastCoord)
+void MainWindow::on_actionStopReplay_triggered(void)
+{
+    this->lapReplay->stop();
+
+    bool blocked = this->replaySlider->blockSignals(true);
+    this->replaySlider->setValue(0);
+    this->replaySlider->blockSignals(blocked);
+}
+
+void MainWindow::on_actionLinkPlotAxes_toggled(bool checked)
+{
+    this->timeAxisLink->setEnabled(checked);
+    this->distanceAxisLink->setEnabled(checked);
+}
+
+void MainWindow::seekReplay(int msec)
+{
+    // The cursors follow the slider, even while the replay is paused
+    if (this->prepareReplay())
+        this->lapReplay->seek(msec / 1000.0);
+}
+
+void MainWindow::setReplaySpeed(int index)
+{
+    this->lapReplay->setSpeed(this->replaySpeedBox->itemData(index).toDouble());
+}
+
+void MainWindow::updateReplaySlider(float time)
 {
-    QSqlQuery updateBoundaries("update SECTOR set start_pos = ?, end_pos = ? where ref_compet = ? and num = ?");
-    updateBoundaries.addBindValue(firstCoord.index());
-    updateBoundaries.addBindValue(lastCoord.index());
-    updateBoundaries.addBindValue(competName);
-    updateBoundaries.addBindValue(sectNum);
+    if (this->replaySlider->isSliderDown())
+        return;
+
+    bool blocked = this->replaySlider->blockSignals(true);
+    this->replaySlider->setValue(qRound(time * 1000));
+    this->replaySlider->blockSignals(blocked);
+}
 
-    if (!updateBoundaries.exec())
-        qWarning() << updateBoundaries.lastQuery() << updateBoundaries.lastError();
+void MainWindow::updateReplayState(bool running)
+{
+    // The replay also stops by itself at the end of the longest lap
+    this->ui->actionReplay->setChecked(running);
 }
 
 void MainWindow::displayLapInformation(float timeValue, const QVariant &trackId)
@@ -1069,6 +1269,8 @@ void MainWindow::displayLapInformation(
 
 void MainWindow::deleteRace(int raceId)
 {
+    TRACE_SCOPE("sql", "MainWindow::deleteRace");
+
     /* ---------------------------------------------------------------------- *
      *                       Delete race from data base                       *
      * ---------------------------------------------------------------------- */
@@ -1198,6 +1400,50 @@ void MainWindow::createToolsBar(void)
                      this, SLOT(loadCompetition(int)));
 
     this->competitionNameModel->select();
+
+    // Replay controls : play/pause and stop come from Qt Designer
+    this->lapReplay = new LapReplay(this);
+
+    this->replaySpeedBox = new QComboBox();
+    this->replaySpeedBox->setToolTip(tr("Vitesse de relecture"));
+    this->replaySpeedBox->addItem(tr("x 0.5"), 0.5);
+    this->replaySpeedBox->addItem(tr("x 1"), 1.0);
+    this->replaySpeedBox->addItem(tr("x 2"), 2.0);
+    this->replaySpeedBox->addItem(tr("x 4"), 4.0);
+    this->replaySpeedBox->addItem(tr("x 8"), 8.0);
+    this->replaySpeedBox->setCurrentIndex(1);
+
+    this->replaySlider = new QSlider(Qt::Horizontal);
+    this->replaySlider->setToolTip(tr("Instant de la relecture"));
+    this->replaySlider->setRange(0, 0);
+    this->replaySlider->setSizePolicy(QSizePolicy::Expanding,
+                                      QSizePolicy::Maximum);
+
+    this->ui->mainToolBar->addWidget(this->replaySpeedBox);
+    this->ui->mainToolBar->addWidget(this->replaySlider);
+
+    QObject::connect(this->replaySpeedBox, SIGNAL(currentIndexChanged(int)),
+                     this, SLOT(setReplaySpeed(int)));
+    QObject::connect(this->replaySlider, SIGNAL(valueChanged(int)),
+                     this, SLOT(seekReplay(int)));
+}
+
+bool MainWindow::prepareReplay(void)
+{
+    // The longest lap displayed sets the length of the replay
+    float duration = qMax(this->mapFrame->scene()->replayDuration(),
+                          this->timePlotFrame->scene()->replayDuration());
+
+    if (duration <= 0)
+        return false;
+
+    if (duration != this->lapReplay->duration())
+    {
+        this->lapReplay->setDuration(duration);
+        this->replaySlider->setRange(0, qRound(duration * 1000));
+    }
+
+    return true;
 }
 
 void MainWindow::createMapZone(void)
@@ -1214,8 +1460,15 @@ void MainWindow::createMapZone(void)
     this->ui->mapSplitter->insertWidget(0, this->mapFrame);
     this->ui->mapSplitter->setStretchFactor(0, 3);
 
-    // Manage sector model
-    this->sectorModel = NULL;
+    // Manage sector model: the sectors being edited, one row per sector
+    this->sectorModel = new SectorEditModel(&this->sectorSession, this);
+    connect(this->sectorModel, SIGNAL(sectorsEdited()),
+            this, SLOT(updateSectorEditActions()));
+
+    ColorizerProxyModel* coloredModel = new ColorizerProxyModel(6, this);
+    coloredModel->setSourceModel(this->sectorModel);
+    this->ui->sectorView->setModel(coloredModel);
+    this->ui->sectorView->horizontalHeader()->setResizeMode(QHeaderView::Stretch);
 }
 
 void MainWindow::createPlotZone(void)
@@ -1267,6 +1520,23 @@ void MainWindow::createPlotZone(void)
     QVBoxLayout* timePlotLayout = new QVBoxLayout(this->ui->tabTime);
     timePlotLayout->setMargin(0);
     timePlotLayout->addWidget(this->timePlotFrame);
+
+    // Create delta time plot frame (gap to the reference lap by distance)
+    this->deltaPlotFrame = new PlotFrame;
+    HorizontalScale* deltaDistAxis = new HorizontalScale(Scale::Bottom);
+    deltaDistAxis->setResolution(5);
+    deltaDistAxis->setUnitLabel("d(m)");
+    this->deltaPlotFrame->addHorizontalAxis(deltaDistAxis);
+
+    VerticalScale* deltaAxis = new VerticalScale(Scale::Left);
+    deltaAxis->setResolution(1);
+    deltaAxis->setUnitLabel("Δt(s)");
+    this->deltaPlotFrame->addVerticalAxis(deltaAxis);
+
+    // Add the delta plot frame the the tab widget
+    QVBoxLayout* deltaPlotLayout = new QVBoxLayout(this->ui->tabDelta);
+    deltaPlotLayout->setMargin(0);
+    deltaPlotLayout->addWidget(this->deltaPlotFrame);
 }
 
 void MainWindow::createMegaSquirtZone(void)
@@ -1278,19 +1548,254 @@ void MainWindow::createMegaSquirtZone(void)
     timeAxis->setUnitLabel("t(s)");
     this->megaSquirtPlotFrame->addHorizontalAxis(timeAxis);
 
+    /* RPM and pulse width differ by three orders of magnitude: the first
+     * channel is read on the left, the others on the right */
+    for (int i(0); i < this->megaSquirtComboBoxes().count(); ++i)
+    {
+        VerticalScale* axis = new VerticalScale(i == 0 ? Scale::Left : Scale::Right);
+        axis->setResolution(1);
+        axis->setVisible(false);
+        this->megaSquirtPlotFrame->addVerticalAxis(axis);
+        this->megaSquirtAxes.append(axis);
+    }
+
     // Add the plot frame to the megaSquirt splitter
     this->ui->megaSquirtSplitter->addWidget(this->megaSquirtPlotFrame);
 
-    // Build model (model) for the comboBoxes (view/controler)
-    QStringList megaSquirtParamList;
-    megaSquirtParamList << "RPM" << "Batt V" << "PW" << "Gammae" << "Gair";
-    QStringListModel* megaSquirtParamModel = new QStringListModel(megaSquirtParamList);
+    /* Build model (model) for the comboBoxes (view/controler). The channels
+     * are those imported in the database (LAP_CHANNEL) */
+    this->megaSquirtChannelModel = new QStringListModel(this);
 
     // Apply the model to each comboBox
-    this->ui->megaSquirtComboBox1->setModel(megaSquirtParamModel);
-    this->ui->megaSquirtComboBox2->setModel(megaSquirtParamModel);
-    this->ui->megaSquirtComboBox3->setModel(megaSquirtParamModel);
-    this->ui->megaSquirtComboBox4->setModel(megaSquirtParamModel);
+    foreach (QComboBox* comboBox, this->megaSquirtComboBoxes())
+        comboBox->setModel(this->megaSquirtChannelModel);
+
+    this->reloadMegaSquirtChannels();
+}
+
+void MainWindow::linkPlotAxes(void)
+{
+    /* Zoom and scroll are shared between the plots with the same abscissa
+     * unit only: a time range has no meaning on a distance plot */
+    this->timeAxisLink = new AxisLink(this);
+    this->timeAxisLink->addView(this->timePlotFrame->view());
+    this->timeAxisLink->addView(this->megaSquirtPlotFrame->view());
+
+    this->distanceAxisLink = new AxisLink(this);
+    this->distanceAxisLink->addView(this->distancePlotFrame->view());
+    this->distanceAxisLink->addView(this->deltaPlotFrame->view());
+}
+
+QList<QComboBox*> MainWindow::megaSquirtComboBoxes(void) const
+{
+    QList<QComboBox*> comboBoxes;
+    comboBoxes << this->ui->megaSquirtComboBox1
+               << this->ui->megaSquirtComboBox2
+               << this->ui->megaSquirtComboBox3
+               << this->ui->megaSquirtComboBox4;
+
+    return comboBoxes;
+}
+
+QStringList MainWindow::selectedMegaSquirtChannels(void) const
+{
+    QStringList channels;
+
+    foreach (QComboBox* comboBox, this->megaSquirtComboBoxes())
+        if (!comboBox->currentText().isEmpty())
+            channels << comboBox->currentText();
+
+    channels.removeDuplicates();
+
+    return channels;
+}
+
+void MainWindow::reloadMegaSquirtChannels(void)
+{
+    // The MegaSquirt zone is not built yet
+    if (this->megaSquirtChannelModel == NULL)
+        return;
+
+    QList<QComboBox*> comboBoxes = this->megaSquirtComboBoxes();
+    QStringList selection;
+
+    foreach (QComboBox* comboBox, comboBoxes)
+    {
+        selection << comboBox->currentText();
+        comboBox->blockSignals(true);
+    }
+
+    // The first (empty) entry means "no channel"
+    QStringList channels;
+    channels << QString() << ChannelRegistry::channelNames();
+    this->megaSquirtChannelModel->setStringList(channels);
+
+    // Keep the previous selection if the channel still exists
+    for (int i(0); i < comboBoxes.count(); ++i)
+    {
+        comboBoxes.at(i)->setCurrentIndex(qMax(0, channels.indexOf(selection.at(i))));
+        comboBoxes.at(i)->blockSignals(false);
+    }
+
+    this->reloadMegaSquirtCurves();
+}
+
+void MainWindow::reloadMegaSquirtCurves(void)
+{
+    TRACE_SCOPE("sql", "MainWindow::reloadMegaSquirtCurves");
+
+    this->megaSquirtPlotFrame->scene()->clearCurves();
+
+    QStringList names = this->selectedMegaSquirtChannels();
+    QList<QPair<TrackIdentifier, QList<LapChannel> > > laps;
+    QHash<QString, QPair<float, float> > ranges;
+    QHash<QString, QString> units;
+
+    // Only the selected channels are read, in a single query per lap
+    foreach (const TrackIdentifier& trackId, this->currentTracksDisplayed)
+    {
+        QList<LapChannel> channels = ChannelStore::load(
+                    trackId["race"].toInt(), trackId["lap"].toInt(), names);
+
+        // Range of each channel over every displayed lap
+        foreach (const LapChannel& channel, channels)
+        {
+            if (channel.isEmpty())
+                continue;
+
+            const QVector<float>& values = channel.values();
+            float minimum = *std::min_element(values.constBegin(), values.constEnd());
+            float maximum = *std::max_element(values.constBegin(), values.constEnd());
+
+            if (ranges.contains(channel.name()))
+            {
+                QPair<float, float>& range = ranges[channel.name()];
+                range.first = qMin(range.first, minimum);
+                range.second = qMax(range.second, maximum);
+            }
+            else
+                ranges.insert(channel.name(), qMakePair(minimum, maximum));
+
+            units.insert(channel.name(), channel.unit());
+        }
+
+        laps.append(qMakePair(trackId, channels));
+    }
+
+    /* Each channel is stretched over the plot height; its axis translates
+     * the plot ordinate back to the channel values */
+    for (int i(0); i < this->megaSquirtAxes.count(); ++i)
+    {
+        VerticalScale* axis = this->megaSquirtAxes.at(i);
+        bool used = i < names.count() && ranges.contains(names.at(i));
+        axis->setVisible(used);
+
+        if (!used)
+            continue;
+
+        QPair<float, float> range = ranges.value(names.at(i));
+        float factor = qMax(range.second - range.first, 1e-3f) / MEGASQUIRT_PLOT_HEIGHT;
+        axis->scale(factor);
+        axis->translate(range.first / factor);
+
+        QString unit = units.value(names.at(i));
+        axis->setUnitLabel(unit.isEmpty() ? names.at(i)
+                                          : names.at(i) + "(" + unit + ")");
+    }
+
+    for (int l(0); l < laps.count(); ++l)
+    {
+        foreach (const LapChannel& channel, laps.at(l).second)
+        {
+            if (channel.isEmpty())
+                continue;
+
+            QPair<float, float> range = ranges.value(channel.name());
+            float factor = qMax(range.second - range.first, 1e-3f) / MEGASQUIRT_PLOT_HEIGHT;
+
+            TelemetrySeriesBuilder builder(channel.size());
+            for (int i(0); i < channel.size(); ++i)
+            {
+                qreal time = channel.timestamp(i) / 1000.0;
+                builder.append(time, time, (channel.value(i) - range.first) / factor);
+            }
+
+            this->megaSquirtPlotFrame->scene()->addCurve(builder.take(),
+                                                         laps.at(l).first);
+        }
+    }
+
+    this->megaSquirtPlotFrame->updateScales();
+}
+
+void MainWindow::addDeltaCurve(const TrackIdentifier& trackId,
+                               const TelemetrySeries& distanceSeries)
+{
+    TRACE_SCOPE("scene", "MainWindow::addDeltaCurve");
+
+    this->deltaDistanceSeries.append(qMakePair(trackId, distanceSeries));
+
+    // The first lap displayed is the reference until another one is chosen
+    if (!this->lapDelta.hasReference())
+    {
+        this->setDeltaReference(trackId);
+        return;
+    }
+
+    // Only the new lap is computed, the other curves are unchanged
+    TelemetrySeries delta = this->lapDelta.delta(distanceSeries);
+
+    if (!delta.isEmpty())
+        this->deltaPlotFrame->scene()->addCurve(delta, trackId);
+}
+
+void MainWindow::removeDeltaCurve(const TrackIdentifier& trackId)
+{
+    for (int i(0); i < this->deltaDistanceSeries.count(); ++i)
+        if (this->deltaDistanceSeries.at(i).first == trackId)
+            this->deltaDistanceSeries.removeAt(i--);
+
+    if (trackId != this->deltaReference)
+    {
+        this->deltaPlotFrame->scene()->removeCurves(trackId);
+        return;
+    }
+
+    // The reference is gone : the next displayed lap replaces it
+    this->lapDelta.clear();
+    this->deltaReference.clear();
+    this->deltaPlotFrame->scene()->clearCurves();
+
+    if (!this->deltaDistanceSeries.isEmpty())
+        this->setDeltaReference(this->deltaDistanceSeries.first().first);
+}
+
+void MainWindow::setDeltaReference(const TrackIdentifier& trackId)
+{
+    TRACE_SCOPE("scene", "MainWindow::setDeltaReference");
+
+    for (int i(0); i < this->deltaDistanceSeries.count(); ++i)
+    {
+        if (this->deltaDistanceSeries.at(i).first != trackId)
+            continue;
+
+        this->deltaReference = trackId;
+        this->lapDelta.setReference(this->deltaDistanceSeries.at(i).second);
+
+        // Every displayed lap is compared to the new reference
+        this->deltaPlotFrame->scene()->clearCurves();
+
+        typedef QPair<TrackIdentifier, TelemetrySeries> DistanceSeries;
+        foreach (const DistanceSeries& lap, this->deltaDistanceSeries)
+        {
+            TelemetrySeries delta = this->lapDelta.delta(lap.second);
+
+            if (!delta.isEmpty())
+                this->deltaPlotFrame->scene()->addCurve(delta, lap.first);
+        }
+
+        return;
+    }
 }
 
 void MainWindow::createRaceTable(void)
@@ -1298,7 +1803,8 @@ void MainWindow::createRaceTable(void)
     // Create the model for the table of laps information
     QStringList headers;
     headers << tr("Course") << tr("Tps(ms)") << tr("Tps(s)") << tr("Dist(m)")
-            << tr("v(km\\h)") << tr("Acc (m\\s2)") << tr("RPM") << tr("PW");
+            << tr("v(km\\h)") << tr("Acc (m\\s2)")
+            << ChannelRegistry::tableChannels();
     this->raceInformationTableModel = new LapInformationTreeModel(headers); //this->raceInformationTableModel = new TreeLapInformationModel(headers);
 
     /* Use a proxy model to manage background color of each row and manage
@@ -1351,6 +1857,8 @@ void MainWindow::writeSettings(const QString& settingsGroup) const
 
 void MainWindow::displayDataLap(void)
 {
+    TRACE_SCOPE("scene", "MainWindow::displayDataLap");
+
     QModelIndex curIndex = this->ui->raceView->selectionModel()->currentIndex();
 
     if (curIndex.parent().parent().isValid())
@@ -1379,30 +1887,8 @@ void MainWindow::displayDataLap(void)
         /* ------------------------------------------------------------------ *
          *                         Populate map scene                         *
          * ------------------------------------------------------------------ */
-        QSqlQuery posQuery("select longitude, latitude, timestamp from POSITION where ref_lap_race = ? and ref_lap_num = ? order by timestamp");
-        posQuery.addBindValue(ref_race);
-        posQuery.addBindValue(ref_lap);
-
-        if (posQuery.exec())
-        {
-            QVector<QPointF> pos;
-            QVector<float> indexValues;
-
-            while (posQuery.next())
-            {
-                GeoCoordinate tmp;
-                tmp.setLongitude(posQuery.value(0).toFloat());
-                tmp.setLatitude(posQuery.value(1).toFloat());
-
-                //see projection method doc for usage purpose
-                pos.append(tmp.projection());
-                indexValues << posQuery.value(2).toFloat() / 1000;
-            }
-
-            qDebug() << posQuery.lastQuery();
-            qDebug() <<  ref_race << curIndex.row() << pos.size();
-            this->mapFrame->scene()->addTrack(pos, indexValues, trackIdentifier);
-        }
+        this->mapFrame->scene()->addTrack(LapSeries::positions(ref_race, ref_lap),
+                                          trackIdentifier);
 
         // If a sampling lap has already be defined, just load it in the view
         if (!this->mapFrame->scene()->hasSectors())
@@ -1411,199 +1897,22 @@ void MainWindow::displayDataLap(void)
         /* ------------------------------------------------------------------ *
          *         Populate plot frames (play the role of plot scene )        *
          * ------------------------------------------------------------------ */
-        QSqlQuery speedQuery;
-        speedQuery.prepare("select timestamp, value from SPEED where ref_lap_race = ? and ref_lap_num = ? order by timestamp");
-        speedQuery.addBindValue(ref_race);
-        speedQuery.addBindValue(ref_lap);
+        TelemetrySeries distSpeedSeries = LapSeries::distanceSpeed(
+                    ref_race, ref_lap, this->getCurrentCompetitionWheelPerimeter());
 
-        if (speedQuery.exec())
+        if (!distSpeedSeries.isEmpty())
         {
-            QList<IndexedPosition> distSpeedPoints; // liste des points de la vitesse par rapport à la distance
-            QList<IndexedPosition> timeSpeedPoints; // Liste des points de la vitesse par rapport au temps
-//            QList<IndexedPosition> distSpeedPoints2; // liste des points de la vitesse par rapport à la distance
-//            QList<IndexedPosition> timeSpeedPoints2; // Liste des points de la vitesse par rapport au temps
-            QList<IndexedPosition> dAccPoints;      // Liste des points de l'accélération par rapport à la distance
-            QList<IndexedPosition> tAccPoints;      // Liste des points de l'accélération par rapport au temps
-            QPointF lastSpeed(0,0); // Modifié
-
-            double wheelPerimeter(this->getCurrentCompetitionWheelPerimeter());
-            int count = 0;
-            double lastPos = wheelPerimeter;
-
-            while (speedQuery.next())
-            {
-                //qDebug() << "timestamp = " << speedQuery.value(0).toFloat();
-
-                double time = speedQuery.value(0).toFloat() / 1000; // Le temps est sauvé en millisecondes dans la db et on le veut en secondes
-                double speed = speedQuery.value(1).toDouble();
-                double pos;
-
-                IndexedPosition dPoint, tPoint;
-                dPoint.setIndex(time);
-                tPoint.setIndex(time);
-
-//                if (count > 0)
-//                {
-                    qreal diff = (speed - lastSpeed.y()) / 3.6; // vitesse en m/s
-                    qreal acc = diff / (time - lastSpeed.x());
-
-//                    if (qAbs(acc) < 2 && (time - lastSpeed.x()) < 1)
-//                    {
-                        int multipleWheelPerimeter = ceil(((speed + lastSpeed.y()) / (2 * 3.6)) * (time - lastSpeed.x())) / wheelPerimeter;
-                        pos = lastPos + multipleWheelPerimeter * wheelPerimeter;
-
-                        //qDebug() << "multipleWheelPerimeter = " << multipleWheelPerimeter;
-
-                        dPoint.setX(pos);
-                        dPoint.setY(speed);
-                        lastPos = pos;
-
-
-
-                        tPoint.setX(time);
-                        tPoint.setY(speed);
-                        timeSpeedPoints << tPoint;
-
-                        dAccPoints << IndexedPosition((pos + lastPos) / 2, acc, time);
-                        tAccPoints << IndexedPosition((lastSpeed.x() + time) / 2, acc, time);
-//                    }
-//                    else
-//                    {
-//                        qDebug() << "count : " << count;
-//                        dPoint.setX(lastPos);
-//                        dPoint.setY(lastSpeed.y());
-//                        tPoint.setX(time);
-//                        tPoint.setY(lastSpeed.y());
-//                        timeSpeedPoints << tPoint;
-//                    }
-//                }
-//                else
-//                {
-//                    dPoint.setX(0);
-//                    dPoint.setY(speed);
-//                }
-
-                distSpeedPoints << dPoint;
-                lastSpeed = QPointF(time, speed);
-                count++;
-            }
+            this->distancePlotFrame->scene()->addCurve(distSpeedSeries, trackIdentifier);
+            this->addDeltaCurve(trackIdentifier, distSpeedSeries);
 
-            /*
-            QList<QPointF> lineZero;
-
-            if (! dAccPoints.isEmpty()) {
-                lineZero << QPointF(dAccPoints.first().x(), 50) << QPointF(dAccPoints.last().x(), 50);
-                PlotCurve* dc = distancePlotFrame->addCurve(dAccPoints, trackIdentifier);
-                dc->translate(0, 50);
-                dc->scale(1, 5);
-                distancePlotFrame->addCurve(lineZero);
-
-                lineZero.clear();
-                lineZero << QPointF(tAccPoints.first().x(), 50) << QPointF(tAccPoints.last().x(), 50);
-                PlotCurve* tc = timePlotFrame->addCurve(tAccPoints, trackIdentifier);
-                tc->translate(0, 50);
-                tc->scale(1, 5);
-                timePlotFrame->addCurve(lineZero);
-            }
-*/
-
-//            QList<QList<QVariant> > lapdata;
-//            this->getAllDataFromSpeed(trackIdentifier, 0, 10000, lapdata);
-
-//            for(int i(0); i < lapdata.count(); ++i)
-//            {
-//                QList<QVariant> data = lapdata.at(i);
-
-//                IndexedPosition dPoint, tPoint;
-//                dPoint.setIndex(data.at(1).toFloat()); // Tps (s)
-//                tPoint.setIndex(data.at(1).toFloat()); // Tps (s)
-
-//                dPoint.setX(data.at(2).toFloat()); // Dist (m)
-//                dPoint.setY(data.at(3).toFloat() + 1); // V (km\h)
-
-//                tPoint.setX(data.at(1).toFloat()); // Tps (s)
-//                tPoint.setY(data.at(3).toFloat() + 1); // V (km\h)
-
-//                distSpeedPoints2 << dPoint;
-//                timeSpeedPoints2 << tPoint;
-//            }
-
-            this->distancePlotFrame->scene()->addCurve(distSpeedPoints, trackIdentifier);//this->distancePlotFrame->addCurve(distSpeedPoints, trackIdentifier);
-            this->timePlotFrame->scene()->addCurve(timeSpeedPoints, trackIdentifier);//this->timePlotFrame->addCurve(timeSpeedPoints, trackIdentifier);
-//            this->distancePlotFrame->scene()->addCurve(distSpeedPoints2, trackIdentifier);//this->distancePlotFrame->addCurve(distSpeedPoints, trackIdentifier);
-//            this->timePlotFrame->scene()->addCurve(timeSpeedPoints2, trackIdentifier);//this->timePlotFrame->addCurve(timeSpeedPoints, trackIdentifier);
-
-//            bool accelerationPositiv = false;
-
-//            foreach (const IndexedPosition& ip, dAccPoints) {
-//                qreal value = (ip.y() - 50) / 5;
-//                qDebug() << value;
-//                if (value > 0 && ! accelerationPositiv) {
-//                    qDebug() << "+ transition found";
-//                    mapFrame->scene()->fixSymbol(ip.index(), QColor(0, 255, 0, 150), trackIdentifier);
-//                    accelerationPositiv = true;
-//                } else if (value < 0 && accelerationPositiv) {
-//                    qDebug() << "- transition found";
-//                    mapFrame->scene()->fixSymbol(ip.index(), QColor(203, 0, 0, 150), trackIdentifier);
-//                    accelerationPositiv = false;
-//                }
-//            }
-//            if (tAccPoints.size() > 2) {
-//                CurvePathBuilder builder(tAccPoints.at(0), tAccPoints.at(1), 1);
-
-//                for (int i = 2; i < tAccPoints.size(); i++)
-//                    builder.append(tAccPoints.at(i));
-//                timePlotFrame->scene()->addPath(builder.exBound());
-//            }
-
-            /*
-            QList<QVariant> raceInformation;
-            for (int i(0); i < tAccPoints.count(); i++)
-            {
-                raceInformation.clear();
-
-                // ajout des informations
-                raceInformation.append("Course " + QString::number(ref_race) + " tour " + QString::number(ref_lap)); // course
-                raceInformation.append(timeSpeedPoints.at(i).index()); // tps 1
-                raceInformation.append(timeSpeedPoints.at(i).index()); // tps 2
-                raceInformation.append(distSpeedPoints.at(i).x()); // distance
-                raceInformation.append(timeSpeedPoints.at(i).y()); // vitesse
-                raceInformation.append(tAccPoints.at(i).y()); // Acceleration
-                raceInformation.append("RPM"); // RPM
-                raceInformation.append("PW"); // PW
-
-                this->raceInformationTableModel->addRaceInformation(raceInformation);
-            }
-            */
-
-            qDebug() << "Nb lignes retournées par la requete = " << count;
-            qDebug() << "distSpeedPoints.count() = " << distSpeedPoints.count();
-            qDebug() << "timeSpeedPoints.count() = " << timeSpeedPoints.count();
-            qDebug() << "dAccPoints.count() = " << dAccPoints.count();
-            qDebug() << "tAccPoints.count() = " << tAccPoints.count();
-
-//            QList<QVariant> raceInformation;
-//            for (int i(0); i < tAccPoints.count(); i++) // Environ 1000 éléments
-//            {
-//                raceInformation.clear();
-
-//                // ajout des informations
-//                raceInformation.append(QVariant());
-//                raceInformation.append(timeSpeedPoints.at(i).index()); // tps 1
-//                raceInformation.append(timeSpeedPoints.at(i).index()); // tps 2
-//                raceInformation.append(distSpeedPoints.at(i).x()); // distance
-//                raceInformation.append(timeSpeedPoints.at(i).y()); // vitesse
-//                raceInformation.append(tAccPoints.at(i).y()); // Acceleration
-//                raceInformation.append("RPM"); // RPM
-//                raceInformation.append("PW");  // PW
-
-//                this->raceInformationTableModel->addRaceInformation(
-//                            ref_race, ref_lap, raceInformation);
-//            }
-
-//            this->ui->raceTable->expandAll();
+            TelemetrySeries timeSpeedSeries = LapSeries::timeSpeed(distSpeedSeries);
+            this->timePlotFrame->scene()->addCurve(timeSpeedSeries, trackIdentifier);
+            this->mapFrame->scene()->setTrackSpeeds(trackIdentifier, timeSpeedSeries);
         }
 
+        /* Channels selected in the MegaSquirt combo boxes: every lap is
+         * read again, the new one may widen the channel ranges */
+        this->reloadMegaSquirtCurves();
     }
 }
 
@@ -1616,6 +1925,8 @@ void MainWindow::connectSignals(void)
             this, SLOT(addSector(QString,int,IndexedPosition,IndexedPosition)));
     connect(this->mapFrame->scene(), SIGNAL(sectorUpdated(QString,int,IndexedPosition,IndexedPosition)),
             this, SLOT(updateSector(QString,int,IndexedPosition,IndexedPosition)));
+    connect(this->mapFrame->scene(), SIGNAL(sectorsEdited(QString)),
+            this, SLOT(endSectorEdit(QString)));
     connect(this->mapFrame->scene(), SIGNAL(pointSelected(float,QVariant)),
             this->distancePlotFrame->scene(), SLOT(highlightPoints(float,QVariant)));
     connect(this->mapFrame->scene(), SIGNAL(pointSelected(float,QVariant)),
@@ -1666,10 +1977,58 @@ void MainWindow::connectSignals(void)
             this, SLOT(displayLapInformation(float,float,QVariant)));
     connect(this->timePlotFrame, SIGNAL(clear()),
             this, SLOT(on_actionClearAllData_triggered()));
+
+    // Lap replay : the same clock moves the cursors of the map and the plots
+    connect(this->lapReplay, SIGNAL(timeChanged(float)),
+            this->mapFrame->scene(), SLOT(setReplayTime(float)));
+    connect(this->lapReplay, SIGNAL(timeChanged(float)),
+            this->distancePlotFrame->scene(), SLOT(setReplayTime(float)));
+    connect(this->lapReplay, SIGNAL(timeChanged(float)),
+            this->timePlotFrame->scene(), SLOT(setReplayTime(float)));
+    connect(this->lapReplay, SIGNAL(timeChanged(float)),
+            this, SLOT(updateReplaySlider(float)));
+    connect(this->lapReplay, SIGNAL(stopped()),
+            this->mapFrame->scene(), SLOT(clearReplay()));
+    connect(this->lapReplay, SIGNAL(stopped()),
+            this->distancePlotFrame->scene(), SLOT(clearReplay()));
+    connect(this->lapReplay, SIGNAL(stopped()),
+            this->timePlotFrame->scene(), SLOT(clearReplay()));
+    connect(this->lapReplay, SIGNAL(stateChanged(bool)),
+            this, SLOT(updateReplayState(bool)));
+
+    // Delta plot frame/scene : same abscissa and index as the distance plot
+    connect(this->mapFrame->scene(), SIGNAL(pointSelected(float,QVariant)),
+            this->deltaPlotFrame->scene(), SLOT(highlightPoints(float,QVariant)));
+    connect(this->mapFrame->scene(), SIGNAL(intervalSelected(float,float,QVariant)),
+            this->deltaPlotFrame->scene(), SLOT(highlightSector(float,float,QVariant)));
+    connect(this->deltaPlotFrame->scene(), SIGNAL(selectionChanged()),
+            this, SLOT(on_actionLapDataEraseTable_triggered()));
+    connect(this->deltaPlotFrame->scene(), SIGNAL(pointSelected(float,QVariant)),
+            this->mapFrame->scene(), SLOT(highlightPoint(float,QVariant)));
+    connect(this->deltaPlotFrame->scene(), SIGNAL(pointSelected(float,QVariant)),
+            this, SLOT(displayLapInformation(float,QVariant)));
+    connect(this->deltaPlotFrame->scene(), SIGNAL(intervalSelected(float,float,QVariant)),
+            this->mapFrame->scene(), SLOT(highlightSector(float,float,QVariant)));
+    connect(this->deltaPlotFrame->scene(), SIGNAL(intervalSelected(float,float,QVariant)),
+            this, SLOT(displayLapInformation(float,float,QVariant)));
+    connect(this->deltaPlotFrame, SIGNAL(clear()),
+            this, SLOT(on_actionClearAllData_triggered()));
+
+    // MegaSquirt plot frame/scene
+    connect(this->mapFrame->scene(), SIGNAL(pointSelected(float,QVariant)),
+            this->megaSquirtPlotFrame->scene(), SLOT(highlightPoints(float,QVariant)));
+    connect(this->megaSquirtPlotFrame, SIGNAL(clear()),
+            this, SLOT(on_actionClearAllData_triggered()));
+
+    foreach (QComboBox* comboBox, this->megaSquirtComboBoxes())
+        connect(comboBox, SIGNAL(currentIndexChanged(int)),
+                this, SLOT(reloadMegaSquirtCurves()));
 }
 
 void MainWindow::reloadRaceView(void)
 {
+    TRACE_SCOPE("model", "MainWindow::reloadRaceView");
+
     QSqlQueryModel* model = new QSqlQueryModel(this);
     QSqlQuery getAllLaps;
     getAllLaps.prepare("select date, race.num, lap.num, race.id, lap.num "
@@ -1708,62 +2067,96 @@ void MainWindow::reloadRaceView(void)
     this->ui->raceView->setColumnHidden(1, true);
     this->ui->raceView->setColumnHidden(2, true);
 
+    // New races may have brought new MegaSquirt channels
+    this->reloadMegaSquirtChannels();
+
 //    connect(this->ui->raceView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), this, SLOT(competitionSelection(QItemSelection,QItemSelection)));
 }
 
 void MainWindow::loadSectors(const QString &competitionName)
 {
-    this->sectorModel = new QSqlTableModel(this);
-    this->sectorModel->setTable("SECTOR");
-    this->sectorModel->setEditStrategy(QSqlTableModel::OnFieldChange);
-    this->sectorModel->setFilter(QString("ref_compet = '%1'").arg(competitionName));
-    this->sectorModel->setSort(this->sectorModel->fieldIndex("num"), Qt::AscendingOrder);
-    this->sectorModel->setHeaderData(3, Qt::Horizontal, tr("Vmin (km/h)"));
-    this->sectorModel->setHeaderData(4, Qt::Horizontal, tr("Vmax (km/h)"));
-    this->sectorModel->select();
+    TRACE_SCOPE("model", "MainWindow::loadSectors");
 
-    ColorizerProxyModel* coloredModel = new ColorizerProxyModel(6, this);
-    coloredModel->setSourceModel(this->sectorModel);
-    coloredModel->setIndexColumn(1);
-    this->ui->sectorView->setModel(coloredModel);
-    this->ui->sectorView->setColumnHidden(this->sectorModel->fieldIndex("id"), true);
-    this->ui->sectorView->setColumnHidden(this->sectorModel->fieldIndex("num"), true);
-    this->ui->sectorView->setColumnHidden(this->sectorModel->fieldIndex("ref_compet"), true);
-    this->ui->sectorView->setColumnHidden(this->sectorModel->fieldIndex("start_pos"), true);
-    this->ui->sectorView->setColumnHidden(this->sectorModel->fieldIndex("end_pos"), true);
-    this->ui->sectorView->horizontalHeader()->setResizeMode(QHeaderView::Stretch);
+    /* Edits made on the map are kept in memory until commitSectorEdits:
+     * the pending session of this competition is only drawn again, the
+     * one of another competition is written before being replaced */
+    if (this->sectorSession.competition() != competitionName ||
+        !this->sectorSession.isModified())
+    {
+        this->commitSectorEdits();
+
+        this->sectorSession = SectorEditSession(competitionName);
+        this->sectorSession.load();
+        this->sectorModel->refresh();
+        this->updateSectorEditActions();
+    }
+
+    this->drawSectors();
+
+    this->ui->sectorView->setVisible(mapFrame->scene()->hasSectors());
+}
+
+void MainWindow::drawSectors(void)
+{
+    TRACE_SCOPE("scene", "MainWindow::drawSectors");
+
+    this->mapFrame->scene()->clearSectors();
 
     QSqlQuery posQuery;
-    posQuery.prepare("select longitude, latitude, id from POSITION where id >= ? and id <= ?");
-    int currentSector = 0;
-    int startPosInd = this->sectorModel->fieldIndex("start_pos");
-    int endPosInd = this->sectorModel->fieldIndex("end_pos");
+    posQuery.prepare("select longitude, latitude, id, timestamp from POSITION where id >= ? and id <= ?");
 
-    qDebug() << "sectors nb ; " << this->sectorModel->rowCount()  ;
-    while (currentSector < this->sectorModel->rowCount())
+    foreach (const EditedSector& sector, this->sectorSession.sectors())
     {
-        posQuery.bindValue(0, this->sectorModel->record(currentSector).value(startPosInd));
-        posQuery.bindValue(1, this->sectorModel->record(currentSector).value(endPosInd));
+        posQuery.bindValue(0, sector.startPos);
+        posQuery.bindValue(1, sector.endPos);
 
         if (posQuery.exec())
         {
-            QVector<IndexedPosition> sectorPoints;
+            TelemetrySeriesBuilder sectorPoints;
 
             while (posQuery.next())
             {
                 GeoCoordinate tmp;
                 tmp.setLongitude(posQuery.value(0).toFloat());
                 tmp.setLatitude(posQuery.value(1).toFloat());
-                sectorPoints.append(IndexedPosition(tmp.projection(), posQuery.value(2).toInt()));
+                sectorPoints.append(posQuery.value(3).toFloat() / 1000,
+                                    tmp.projection(), posQuery.value(2).toInt());
             }
 
-            if (! sectorPoints.isEmpty())
-                this->mapFrame->scene()->addSector(sectorPoints, competitionName);
+            if (sectorPoints.size() > 0)
+                this->mapFrame->scene()->addSector(sectorPoints.take(),
+                                                   this->sectorSession.competition());
         }
-        currentSector++;
+    }
+}
+
+bool MainWindow::commitSectorEdits(void)
+{
+    if (!this->sectorSession.isModified())
+        return true;
+
+    // All the cuts and merges in one transaction
+    if (!this->sectorSession.commit())
+    {
+        QMessageBox::warning(this, tr("Enregistrement des secteurs"),
+                             tr("Impossible d'enregistrer les secteurs dans la base de données"));
+        return false;
     }
 
-    this->ui->sectorView->setVisible(mapFrame->scene()->hasSectors());
+    // A single refresh of the sector table
+    this->sectorModel->refresh();
+    this->ui->sectorView->setVisible(this->sectorModel->rowCount() > 0);
+
+    this->updateSectorEditActions();
+    return true;
+}
+
+void MainWindow::updateSectorEditActions(void)
+{
+    this->ui->actionUndoSectorEdit->setEnabled(this->sectorSession.canUndo());
+    this->ui->actionRedoSectorEdit->setEnabled(this->sectorSession.canRedo());
+    this->ui->actionSaveSectors->setEnabled(this->sectorSession.isModified());
+    this->setWindowModified(this->sectorSession.isModified());
 }
 
 void MainWindow::highlightPointInAllView(const QModelIndex &index)
@@ -1793,18 +2186,22 @@ void MainWindow::highlightPointInAllView(const QModelIndex &index)
     this->mapFrame->scene()->highlightPoint(time, trackId);
     this->timePlotFrame->scene()->highlightPoint(time, trackId);
     this->distancePlotFrame->scene()->highlightPoint(time, trackId);
+    this->deltaPlotFrame->scene()->highlightPoint(time, trackId);
 }
 
 void MainWindow::updateDataBase(QString const& dbFilePath,
                                bool(*dataBaseAction)(QString const&))
 {
+    // Sector edits belong to the data base being closed
+    this->commitSectorEdits();
+    this->sectorSession = SectorEditSession();
+
     /* ---------------------------------------------------------------------- *
      * Plusieurs modèles (2) sont basé sur les tables, il faut donc les       *
      * supprimer en premier                                                   *
      * ---------------------------------------------------------------------- */
     this->ui->sectorView->setVisible(false);
-    delete this->sectorModel;
-    this->sectorModel = NULL;
+    this->sectorModel->refresh();
 
     delete this->competitionNameModel;
     this->competitionNameModel = NULL;
@@ -1822,7 +2219,7 @@ void MainWindow::updateDataBase(QString const& dbFilePath,
         return;
 
     QFileInfo dbFile(QSqlDatabase::database().databaseName());
-    this->setWindowTitle(tr("EcoManager - ") + dbFile.baseName());
+    this->setWindowTitle(tr("EcoManager - ") + dbFile.baseName() + "[*]");
 
     /* ---------------------------------------------------------------------- *
      *    Rétablir la liste des compétitions en fonction de la nouvelle db    *
@@ -1846,6 +2243,8 @@ bool MainWindow::getAllDataFromSpeed(
         const TrackIdentifier& trackId, float lowerTimeValue,
         float upperTimeValue, QList< QList<QVariant> >& data)
 {
+    TRACE_SCOPE("sql", "MainWindow::getAllDataFromSpeed");
+
     // Get the race number and the lap number from the trackId
     int ref_race = trackId["race"].toInt();
     int ref_lap  = trackId["lap"].toInt();
@@ -1854,23 +2253,12 @@ bool MainWindow::getAllDataFromSpeed(
     qDebug() << "lower = " << lowerTimeValue;
     qDebug() << "upper = " << upperTimeValue;
 
-    /* upperTimeValue passé en paramètre est exprimé en secondes mais les
-     * timestamp sauvées dans la base de données sont en millisecondes */
-    int upperTimeStamp = upperTimeValue * 1000;
-
-    // Récupérer les informations de temps et de vitesses
-    QSqlQuery query;
-    query.prepare("select timestamp, value from SPEED where timestamp <= ? and ref_lap_race = ? and ref_lap_num = ? order by timestamp");
-    query.addBindValue(upperTimeStamp);
-    query.addBindValue(ref_race);
-    query.addBindValue(ref_lap);
-
-    /* If you only need to move forward through the results (e.g., by using next()),
-     * you can use setForwardOnly(), which will save a significant amount of memory
-     * overhead and improve performance on some databases. */
-    query.setForwardOnly(true);
+    // Mêmes lignes que l'export csv (ExportModule::buildLapDataOutput)
+    LapDataRows rows(ref_race, ref_lap,
+                     this->getCurrentCompetitionWheelPerimeter(),
+                     lowerTimeValue, upperTimeValue);
 
-    if (!query.exec())
+    if (!rows.exec())
     {
         QString errorMsg("Impossible de récupérer les données numériques "
                          "associées à votre sélection pour le tour " +
@@ -1881,41 +2269,22 @@ bool MainWindow::getAllDataFromSpeed(
         return false;
     }
 
-    double wheelPerimeter(this->getCurrentCompetitionWheelPerimeter());
-    double time(0),  lastTime(0);
-    double speed(0), lastSpeed(0);
-    double pos(wheelPerimeter),   lastPos(0);
-
-    while(query.next())
+    while (rows.next())
     {
-        lastTime  = time;
-        lastSpeed = speed;
-        lastPos   = pos;
-
-        time  = query.value(0).toFloat() / 1000; // Le temps est sauvé en millisecondes dans la db et on le veut en secondes
-        speed = query.value(1).toDouble();
-
-        int multipleWheelPerimeter = ceil(((speed + lastSpeed) / (2 * 3.6)) * (time - lastTime)) / wheelPerimeter;
-        pos = lastPos + multipleWheelPerimeter * wheelPerimeter;
-
         // Données a afficher dans le tableau
-        if(time >= lowerTimeValue)
-        {
-            qreal diff = (speed -lastSpeed) / 3.6; // vitesse en m/s
-            qreal acc  = diff / (time - lastTime);
-
-            QList<QVariant> lapData;
-            lapData.append(time * 1000); // Tps (ms)
-            lapData.append(time);        // Tps (s)
-            lapData.append(pos);         // Dist (m)
-            lapData.append(speed);       // V (km\h)
-            lapData.append(qAbs(acc) > 2 ? "NS" : QString::number(acc)); // Acc (m\s²)
-            lapData.append("RPM");       // RPM
-            lapData.append("PW");        // PW
-
-            // Ajout de la ligne de données à la liste
-            data.append(lapData);
-        }
+        QList<QVariant> lapData;
+        lapData.append(rows.time() * 1000); // Tps (ms)
+        lapData.append(rows.time());        // Tps (s)
+        lapData.append(rows.distance());    // Dist (m)
+        lapData.append(rows.speed());       // V (km\h)
+        lapData.append(rows.isAccelerationSignificant() ?
+                           QString::number(rows.acceleration()) : "NS"); // Acc (m\s²)
+
+        for (int c(0); c < rows.channelCount(); ++c)
+            lapData.append(rows.channelValue(c));
+
+        // Ajout de la ligne de données à la liste
+        data.append(lapData);
     }
 
     qDebug() << "Nombre de données calculées = " << data.count();
@@ -1934,46 +2303,32 @@ void MainWindow::exportLapDataToCSV(const TrackIdentifier &trackId,
     if (filepath.isEmpty()) // User canceled
         return;
 
-    // Supprime le fichier s'il existe
     QFile file(filepath);
-    if(file.exists())
-        file.remove();
-
-    // Calcule toutes les données à mettre dans le fichier csv
-    QList< QList<QVariant> > lapdata;
-    if (!this->getAllDataFromSpeed(
-                trackId, lowerTimeValue, upperTimeValue, lapdata))
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
     {
         QMessageBox::warning(this, tr("Impossible d'exporter les données"),
-                             tr("Erreur lors de la récupération des données"));
+                             file.errorString());
         return;
     }
 
-    // Converti toutes les données QVariant en QString
-    QList<QCSVRow> data;
-    foreach (QList<QVariant> dataRow, lapdata)
-    {
-        QCSVRow row;
-        foreach (QVariant variantData, dataRow)
-            row.append(variantData.toString());
+    // Les données sont calculées et écrites ligne par ligne
+    QCSVWriter writer(&file);
+    writer.writeRow(ExportModule::lapDataHeader());
 
-        data.append(row);
+    if (!ExportModule::buildLapDataOutput(
+                writer, trackId["race"].toInt(), trackId["lap"].toInt(),
+                this->getCurrentCompetitionWheelPerimeter(),
+                lowerTimeValue, upperTimeValue) || !writer.flush())
+    {
+        QMessageBox::warning(this, tr("Impossible d'exporter les données"),
+                             tr("Erreur lors de la récupération des données"));
     }
-
-    // Sauvegarde toutes les données dans le fichier csv
-    QCSVRow header;
-    header << "Temps (ms)" << "Temps (s)" << "Distance (m)" << "V (km\\h)"
-           << "Accélération (m\\s²)" << "RPM" << "PW";
-
-    QCSVParser csvParser(filepath);
-    csvParser.addRow(header);
-    for(int i(0); i < data.count(); ++i)
-        csvParser.addRow(data.at(i));
-    csvParser.save();
 }
 
 void MainWindow::closeEvent(QCloseEvent* event)
 {
+    this->commitSectorEdits();
+
     // Save the state of the mainWindow and its widgets
     this->writeSettings("MainWindow");
 
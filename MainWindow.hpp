@@ -3,7 +3,9 @@
 
 #include "Map/MapScene.hpp"
 #include "Map/MapFrame.hpp"
+#include "Map/DensityRaster.hpp"
 #include "Plot/PlotFrame.hpp"
+#include "Plot/AxisLink.hpp"
 #include "Plot/HorizontalScale.hpp"
 #include "Plot/VerticalScale.hpp"
 #include "DBModule/ImportModule.hpp"
@@ -12,18 +14,31 @@
 #include "Common/GroupingTreeModel.hpp"
 #include "Common/TreeLapInformationModel.hpp"
 #include "DBModule/ExportModule.hpp"
+#include "DBModule/LapDataRows.hpp"
+#include "DBModule/ChannelStore.hpp"
+#include "DBModule/LapSeries.hpp"
+#include "DBModule/SectorEditSession.hpp"
+#include "DBModule/SectorEditModel.hpp"
 #include "Common/ColorizerProxyModel.hpp"
 #include "Map/SampleLapViewer.hpp"
 #include "LapInformationProxyModel.hpp"
 #include "Common/LapInformationTreeModel.hpp"
+#include "Common/LapDelta.hpp"
+#include "Common/LapReplay.hpp"
 #include "LapDataCompartor.hpp"
+#include "SectorTimesDialog.hpp"
 #include "Utils/DataBaseManager.hpp"
 #include "Utils/QCSVParser.hpp"
+#include "Utils/Trace.hpp"
 
 #include <QtGui>
 #include <QtSql>
 #include <float.h>
 
+/* Plot height shared by the MegaSquirt channels: each one is stretched over
+ * it and read on its own vertical axis */
+#define MEGASQUIRT_PLOT_HEIGHT 100
+
 namespace Ui {
 class MainWindow;
 }
@@ -67,6 +82,14 @@ class MainWindow : public QMainWindow
         void on_actionLapDataEraseTable_triggered(void);
         void on_actionLapDataTableResizeToContents_triggered(bool checked);
         void on_actionClearAllData_triggered(void);
+        void on_actionSectorTimes_triggered(void);
+        void on_actionUndoSectorEdit_triggered(void);
+        void on_actionRedoSectorEdit_triggered(void);
+        void on_actionSaveSectors_triggered(void);
+        void on_actionReplay_triggered(bool checked);
+        void on_actionStopReplay_triggered(void);
+        void on_actionLinkPlotAxes_toggled(bool checked);
+        void on_actionRaceViewDisplayDensity_triggered(void);
         void on_raceTable_customContextMenuRequested(const QPoint &pos);
         void on_actionLapDataComparaison_triggered(void);
         void on_raceTable_doubleClicked(const QModelIndex &index);
@@ -78,6 +101,7 @@ class MainWindow : public QMainWindow
         void on_menuEditRaceView_aboutToShow(void);
         void on_actionRaceViewDisplayLap_triggered(void);
         void on_actionRaceViewRemoveLap_triggered(void);
+        void on_actionRaceViewSetDeltaReference_triggered(void);
         void on_actionRaceViewExportLapDataInCSV_triggered(void);
         void on_actionRaceViewDeleteRace_triggered(void);
         void on_actionRaceViewDeleteRacesAtSpecificDate_triggered(void);
@@ -98,6 +122,12 @@ class MainWindow : public QMainWindow
         void removeSector(const QString& competitionName, int sectorNum);
         void addSector(QString, int, IndexedPosition, IndexedPosition);
         void updateSector(QString, int, IndexedPosition, IndexedPosition);
+        void endSectorEdit(const QString& competitionName);
+        void updateSectorEditActions(void);
+        void seekReplay(int msec);
+        void setReplaySpeed(int index);
+        void updateReplaySlider(float time);
+        void updateReplayState(bool running);
 
         void displayLapInformation(float timeValue, const QVariant& trackId);
         void displayLapInformation(float lowerTimeValue, float upperTimeValue,
@@ -106,6 +136,9 @@ class MainWindow : public QMainWindow
         void deleteRace(int raceId);
         void deleteRaces(QVariantList listRaceId);
 
+        void reloadMegaSquirtChannels(void);
+        void reloadMegaSquirtCurves(void);
+
     private:
 
         void centerOnScreen(void);
@@ -114,6 +147,7 @@ class MainWindow : public QMainWindow
         void createMapZone(void);
         void createPlotZone(void);
         void createMegaSquirtZone(void);
+        void linkPlotAxes(void);
         void createRaceTable(void);
         void readSettings(const QString& settingsGroup);
         void writeSettings(const QString& settingsGroup) const;
@@ -121,8 +155,17 @@ class MainWindow : public QMainWindow
         void connectSignals(void);
         void reloadRaceView(void);
         void loadSectors(const QString& competitionName);
+        void drawSectors(void);
+        bool commitSectorEdits(void);
+        bool prepareReplay(void);
         void highlightPointInAllView(const QModelIndex& index);
         void removeTrackFromAllView(QMap<QString, QVariant> const& trackId);
+        void addDeltaCurve(const TrackIdentifier& trackId,
+                           const TelemetrySeries& distanceSeries);
+        void removeDeltaCurve(const TrackIdentifier& trackId);
+        void setDeltaReference(const TrackIdentifier& trackId);
+        QList<QComboBox*> megaSquirtComboBoxes(void) const;
+        QStringList selectedMegaSquirtChannels(void) const;
 
         void updateDataBase(QString const& dbFilePath,
                            bool(*dataBaseAction)(QString const&));
@@ -154,10 +197,32 @@ class MainWindow : public QMainWindow
         PlotFrame* distancePlotFrame;
         PlotFrame* timePlotFrame;
         PlotFrame* megaSquirtPlotFrame;
+        PlotFrame* deltaPlotFrame;
+
+        // One vertical axis per selected MegaSquirt channel
+        QList<VerticalScale*> megaSquirtAxes;
+
+        // Shared abscissa of the plots with the same unit (time or distance)
+        AxisLink* timeAxisLink;
+        AxisLink* distanceAxisLink;
+
+        // Delta time against the reference lap (distance domain)
+        LapDelta lapDelta;
+        TrackIdentifier deltaReference;
+        QList< QPair<TrackIdentifier, TelemetrySeries> > deltaDistanceSeries;
+
+        // Sector cuts and merges not yet written in the data base
+        SectorEditSession sectorSession;
+
+        // Replay of the displayed laps (one clock for the map and the plots)
+        LapReplay* lapReplay;
+        QSlider* replaySlider;
+        QComboBox* replaySpeedBox;
 
         // Models
-        QSqlTableModel* sectorModel;
+        SectorEditModel* sectorModel;
         QSqlTableModel* competitionNameModel;
+        QStringListModel* megaSquirtChannelModel;
 
         // Personal Models
         GroupingTreeModel* competitionModel;
@@ -0,0 +1,266 @@
+#include "DensityRaster.hpp"
+#include <qmath.h>
+
+#if QT_VERSION >= 0x050000
+#include <QtConcurrent>
+#endif
+
+namespace
+{
+    // Comptage d'un paquet de tours dans ses propres tableaux
+    struct BinLaps
+    {
+        typedef DensityRaster::Buffer result_type;
+
+        explicit BinLaps(const DensityRaster* raster) :
+            raster(raster)
+        {
+        }
+
+        DensityRaster::Buffer operator()(const QVector<TelemetrySeries>& laps) const
+        {
+            DensityRaster::Buffer buffer;
+            this->raster->bin(laps, buffer);
+            return buffer;
+        }
+
+        const DensityRaster* raster;
+    };
+}
+
+DensityRaster::DensityRaster(const QRectF& bounds, qreal cellSize) :
+    _cellSize(cellSize > 0 ? cellSize : 1), _lapCount(0)
+{
+    // Taille de la grille bornee : les cellules grandissent si besoin
+    qreal side = qMax(bounds.width(), bounds.height());
+    if (side / this->_cellSize > DENSITY_RASTER_MAX_SIDE - 1)
+        this->_cellSize = side / (DENSITY_RASTER_MAX_SIDE - 1);
+
+    // Une cellule de plus : les points sur le bord droit ou bas sont comptes
+    this->_width  = qFloor(bounds.width() / this->_cellSize) + 1;
+    this->_height = qFloor(bounds.height() / this->_cellSize) + 1;
+
+    // Grille calee sur le coin haut gauche (x min, y max) des donnees
+    this->_bounds = QRectF(bounds.left(),
+                           bounds.bottom() - this->_height * this->_cellSize,
+                           this->_width * this->_cellSize,
+                           this->_height * this->_cellSize);
+
+    this->clear();
+}
+
+void DensityRaster::add(const QVector<TelemetrySeries>& laps)
+{
+    TRACE_SCOPE("scene", "DensityRaster::add");
+
+    if (laps.isEmpty())
+        return;
+
+    // Un paquet par coeur, tours distribues a tour de role
+    int chunkCount = qBound(1, QThread::idealThreadCount(), laps.size());
+    QList< QVector<TelemetrySeries> > chunks;
+
+    for (int c(0); c < chunkCount; ++c)
+    {
+        QVector<TelemetrySeries> chunk;
+        for (int i(c); i < laps.size(); i += chunkCount)
+            chunk << laps.at(i);
+        chunks << chunk;
+    }
+
+    Buffer partial = QtConcurrent::blockingMappedReduced<Buffer>(
+                chunks, BinLaps(this), DensityRaster::merge);
+
+    merge(this->_buffer, partial);
+    this->_lapCount += laps.size();
+}
+
+void DensityRaster::clear(void)
+{
+    int size = this->_width * this->_height;
+
+    this->_buffer.counts.fill(0, size);
+    this->_buffer.speedSums.fill(0, size);
+    this->_buffer.speedCounts.fill(0, size);
+    this->_lapCount = 0;
+}
+
+int DensityRaster::width(void) const
+{
+    return this->_width;
+}
+
+int DensityRaster::height(void) const
+{
+    return this->_height;
+}
+
+qreal DensityRaster::cellSize(void) const
+{
+    return this->_cellSize;
+}
+
+QRectF DensityRaster::bounds(void) const
+{
+    return this->_bounds;
+}
+
+int DensityRaster::lapCount(void) const
+{
+    return this->_lapCount;
+}
+
+quint32 DensityRaster::count(int column, int row) const
+{
+    return this->_buffer.counts.at(row * this->_width + column);
+}
+
+qreal DensityRaster::meanSpeed(int column, int row) const
+{
+    int cell = row * this->_width + column;
+    quint32 speedCount = this->_buffer.speedCounts.at(cell);
+
+    return speedCount > 0 ? this->_buffer.speedSums.at(cell) / speedCount
+                          : qQNaN();
+}
+
+QImage DensityRaster::toImage(void) const
+{
+    TRACE_SCOPE("scene", "DensityRaster::toImage");
+
+    QImage image(this->_width, this->_height, QImage::Format_ARGB32);
+    image.fill(0);
+
+    int size = this->_width * this->_height;
+    quint32 maxCount(0);
+    qreal minSpeed(0), maxSpeed(0);
+    bool first(true);
+
+    for (int cell(0); cell < size; ++cell)
+    {
+        maxCount = qMax(maxCount, this->_buffer.counts.at(cell));
+
+        if (this->_buffer.speedCounts.at(cell) == 0)
+            continue;
+
+        qreal speed = this->_buffer.speedSums.at(cell) / this->_buffer.speedCounts.at(cell);
+        minSpeed = first ? speed : qMin(minSpeed, speed);
+        maxSpeed = first ? speed : qMax(maxSpeed, speed);
+        first = false;
+    }
+
+    if (maxCount == 0)
+        return image;
+
+    QVector<QRgb> ramp(HEAT_TRACK_BUCKETS);
+    for (int b(0); b < HEAT_TRACK_BUCKETS; ++b)
+        ramp[b] = HeatTrackItem::bucketColor(b).rgb();
+
+    qreal speedScale = (maxSpeed > minSpeed) ?
+                (HEAT_TRACK_BUCKETS - 1) / (maxSpeed - minSpeed) : 0;
+    qreal countScale = 195 / qLn(1 + maxCount);
+
+    for (int row(0); row < this->_height; ++row)
+    {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(row));
+
+        for (int column(0); column < this->_width; ++column)
+        {
+            int cell = row * this->_width + column;
+            quint32 count = this->_buffer.counts.at(cell);
+
+            if (count == 0)
+                continue;
+
+            // Opacite : echelle logarithmique, les passages rares restent visibles
+            int alpha = 60 + qRound(qLn(1 + count) * countScale);
+            QRgb color = qRgb(255, 255, 255);
+
+            if (this->_buffer.speedCounts.at(cell) > 0)
+            {
+                qreal speed = this->_buffer.speedSums.at(cell) / this->_buffer.speedCounts.at(cell);
+                color = ramp.at(qBound(0, qRound((speed - minSpeed) * speedScale),
+                                       HEAT_TRACK_BUCKETS - 1));
+            }
+
+            line[column] = qRgba(qRed(color), qGreen(color), qBlue(color), alpha);
+        }
+    }
+
+    return image;
+}
+
+QRectF DensityRaster::boundsOf(const QVector<TelemetrySeries>& laps)
+{
+    QRectF bounds;
+
+    foreach (const TelemetrySeries& lap, laps)
+        if (!lap.isEmpty())
+            bounds = bounds.isNull() ? lap.boundingRect()
+                                     : bounds.united(lap.boundingRect());
+
+    return bounds;
+}
+
+void DensityRaster::bin(const QVector<TelemetrySeries>& laps,
+                        Buffer& buffer) const
+{
+    int size = this->_width * this->_height;
+    buffer.counts.fill(0, size);
+    buffer.speedSums.fill(0, size);
+    buffer.speedCounts.fill(0, size);
+
+    quint32* counts = buffer.counts.data();
+    float* speedSums = buffer.speedSums.data();
+    quint32* speedCounts = buffer.speedCounts.data();
+
+    qreal left = this->_bounds.left();
+    qreal top  = this->_bounds.bottom(); // y max : premiere rangee
+    qreal inverse = 1 / this->_cellSize;
+
+    foreach (const TelemetrySeries& lap, laps)
+    {
+        const qreal* xs = lap.xData();
+        const qreal* ys = lap.yData();
+        const float* speeds = lap.hasSpeeds() ? lap.speedData() : NULL;
+
+        for (int i(0); i < lap.size(); ++i)
+        {
+            int column = int((xs[i] - left) * inverse);
+            int row    = int((top - ys[i]) * inverse);
+
+            if (column < 0 || column >= this->_width || row < 0 || row >= this->_height)
+                continue;
+
+            int cell = row * this->_width + column;
+            counts[cell]++;
+
+            if (speeds != NULL && !qIsNaN(speeds[i]))
+            {
+                speedSums[cell] += speeds[i];
+                speedCounts[cell]++;
+            }
+        }
+    }
+}
+
+void DensityRaster::merge(Buffer& result, const Buffer& partial)
+{
+    // Premier paquet recu : repris tel quel
+    if (result.counts.isEmpty())
+    {
+        result = partial;
+        return;
+    }
+
+    quint32* counts = result.counts.data();
+    float* speedSums = result.speedSums.data();
+    quint32* speedCounts = result.speedCounts.data();
+
+    for (int cell(0); cell < partial.counts.size(); ++cell)
+    {
+        counts[cell]      += partial.counts.at(cell);
+        speedSums[cell]   += partial.speedSums.at(cell);
+        speedCounts[cell] += partial.speedCounts.at(cell);
+    }
+}
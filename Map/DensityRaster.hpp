@@ -0,0 +1,75 @@
+#ifndef __DENSITYRASTER_HPP__
+#define __DENSITYRASTER_HPP__
+
+#include "HeatTrackItem.hpp"
+#include "../Common/TelemetrySeries.hpp"
+#include "../Utils/Trace.hpp"
+#include <QtGui>
+
+// Cote d'une cellule pour la carte (m)
+#define DENSITY_RASTER_CELL_SIZE 2
+// Nombre maximal de cellules sur un cote de la grille
+#define DENSITY_RASTER_MAX_SIDE 1024
+
+/* Densite des passages de plusieurs tours sur une grille reguliere.
+ *
+ * Chaque point GPS des tours est compte dans la cellule qui le contient,
+ * avec sa vitesse (colonne speed de la serie, NaN ou absente si inconnue)
+ * pour la vitesse moyenne de la cellule. Les tours sont repartis en autant de paquets que
+ * de coeurs : chaque paquet est compte dans ses propres tableaux
+ * (QtConcurrent), les tableaux sont ensuite additionnes.
+ *
+ * toImage() rend la grille en une seule image : la couleur donne la vitesse
+ * moyenne (rampe de HeatTrackItem), l'opacite le nombre de points. Le cout
+ * d'affichage ne depend plus du nombre de tours.
+ *
+ *     QVector<TelemetrySeries> laps = LapSeries::competitionLaps(competition);
+ *     DensityRaster raster(DensityRaster::boundsOf(laps), cellSize);
+ *     raster.add(laps);
+ *     scene->setDensityLayer(raster.toImage(), raster.bounds());
+ */
+class DensityRaster
+{
+    public:
+
+        // Cumuls par cellule, rangee par rangee depuis le haut (y max)
+        struct Buffer
+        {
+            QVector<quint32> counts;
+            QVector<float> speedSums;
+            QVector<quint32> speedCounts;
+        };
+
+        DensityRaster(const QRectF& bounds, qreal cellSize);
+
+        void add(const QVector<TelemetrySeries>& laps);
+        void clear(void);
+
+        int width(void) const;
+        int height(void) const;
+        qreal cellSize(void) const;
+        QRectF bounds(void) const; // etendue de la grille, y vers le haut
+        int lapCount(void) const;
+
+        quint32 count(int column, int row) const;
+        qreal meanSpeed(int column, int row) const; // NaN sans vitesse
+
+        QImage toImage(void) const;
+
+        static QRectF boundsOf(const QVector<TelemetrySeries>& laps);
+
+        // Comptage d'un paquet de tours, appele en parallele
+        void bin(const QVector<TelemetrySeries>& laps, Buffer& buffer) const;
+        static void merge(Buffer& result, const Buffer& partial);
+
+    protected:
+
+        QRectF _bounds;
+        qreal _cellSize;
+        int _width;
+        int _height;
+        int _lapCount;
+        Buffer _buffer;
+};
+
+#endif /* __DENSITYRASTER_HPP__ */
@@ -0,0 +1,169 @@
+#include "HeatTrackItem.hpp"
+#include "../Common/LapResampler.hpp"
+#include <algorithm>
+
+HeatTrackItem::HeatTrackItem(const TrackGeometry& geometry,
+                             const QVector<qreal>& times,
+                             QGraphicsItem* parent) :
+    QGraphicsItem(parent), _geometry(geometry), _times(times), _minimum(0),
+    _maximum(0), _level(0)
+{
+    if (geometry.size() > 0)
+        this->_bounds = QPolygonF(geometry.points()).boundingRect();
+
+    this->setZValue(1); // au-dessus du trace blanc
+}
+
+QRectF HeatTrackItem::boundingRect(void) const
+{
+    return this->_bounds;
+}
+
+void HeatTrackItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*,
+                          QWidget*)
+{
+    QPen pen;
+    pen.setWidth(HEAT_TRACK_WIDTH);
+    pen.setCosmetic(true);
+    pen.setCapStyle(Qt::RoundCap);
+
+    for (int b(0); b < this->_buckets.size(); ++b)
+    {
+        if (this->_buckets.at(b).isEmpty())
+            continue;
+
+        pen.setColor(bucketColor(b));
+        painter->setPen(pen);
+        painter->drawLines(this->_buckets.at(b));
+    }
+}
+
+void HeatTrackItem::setSpeeds(const TelemetrySeries& speed)
+{
+    this->_speeds.clear();
+    this->_speedSums.clear();
+
+    if (speed.isEmpty() || this->_geometry.size() < 2)
+    {
+        this->fillBuckets();
+        return;
+    }
+
+    // Vitesse a l'instant de chaque point GPS, puis moyenne par segment
+    QVector<qreal> vertexSpeeds =
+            LapResampler::interpolate(speed.times(), speed.ys(), this->_times);
+
+    this->_speeds.resize(this->_geometry.size() - 1);
+    this->_speedSums.resize(this->_geometry.size());
+    this->_speedSums[0] = 0;
+
+    for (int i(0); i < this->_speeds.size(); ++i)
+    {
+        this->_speeds[i] = (vertexSpeeds.at(i) + vertexSpeeds.at(i + 1)) / 2;
+        this->_speedSums[i + 1] = this->_speedSums.at(i) + this->_speeds.at(i);
+    }
+
+    this->_minimum = this->minimumSpeed();
+    this->_maximum = this->maximumSpeed();
+    this->fillBuckets();
+}
+
+bool HeatTrackItem::hasSpeeds(void) const
+{
+    return !this->_speeds.isEmpty();
+}
+
+qreal HeatTrackItem::minimumSpeed(void) const
+{
+    if (this->_speeds.isEmpty())
+        return 0;
+
+    return *std::min_element(this->_speeds.constBegin(), this->_speeds.constEnd());
+}
+
+qreal HeatTrackItem::maximumSpeed(void) const
+{
+    if (this->_speeds.isEmpty())
+        return 0;
+
+    return *std::max_element(this->_speeds.constBegin(), this->_speeds.constEnd());
+}
+
+void HeatTrackItem::setSpeedRange(qreal minimum, qreal maximum)
+{
+    if (minimum == this->_minimum && maximum == this->_maximum)
+        return;
+
+    this->_minimum = minimum;
+    this->_maximum = maximum;
+    this->fillBuckets();
+}
+
+int HeatTrackItem::level(void) const
+{
+    return this->_level;
+}
+
+void HeatTrackItem::setLevel(int level)
+{
+    level = qBound(TRACK_GEOMETRY_MIN_LEVEL, level, TRACK_GEOMETRY_MAX_LEVEL);
+
+    if (level == this->_level)
+        return;
+
+    this->_level = level;
+    this->fillBuckets();
+}
+
+QColor HeatTrackItem::bucketColor(int bucket)
+{
+    // Table calculee une seule fois : bleu (240) -> rouge (0)
+    static QVector<QColor> colors;
+
+    if (colors.isEmpty())
+        for (int b(0); b < HEAT_TRACK_BUCKETS; ++b)
+            colors << QColor::fromHsv(240 - (240 * b) / (HEAT_TRACK_BUCKETS - 1),
+                                      255, 255);
+
+    return colors.at(qBound(0, bucket, HEAT_TRACK_BUCKETS - 1));
+}
+
+void HeatTrackItem::fillBuckets(void)
+{
+    this->_buckets.clear();
+
+    if (this->_speeds.isEmpty())
+    {
+        this->update();
+        return;
+    }
+
+    this->_buckets.resize(HEAT_TRACK_BUCKETS);
+
+    qreal range = this->_maximum - this->_minimum;
+    qreal scale = (range > 0) ? (HEAT_TRACK_BUCKETS - 1) / range : 0;
+
+    // Memes points que le trace blanc a ce niveau de zoom
+    const QVector<QPointF>& points = this->_geometry.points();
+    QVector<int> kept =
+            this->_geometry.indexes(TrackGeometry::toleranceOf(this->_level));
+
+    for (int k(1); k < kept.size(); ++k)
+    {
+        int first = kept.at(k - 1);
+        int last = kept.at(k);
+
+        // Moyenne des segments complets remplaces
+        qreal speed = (this->_speedSums.at(last) - this->_speedSums.at(first))
+                      / (last - first);
+
+        int b = qBound(0, qRound((speed - this->_minimum) * scale),
+                       HEAT_TRACK_BUCKETS - 1);
+        this->_buckets[b] << QLineF(points.at(first), points.at(last));
+    }
+
+    for (int b(0); b < this->_buckets.size(); ++b)
+        this->_buckets[b].squeeze();
+
+    this->update();
+}
@@ -0,0 +1,73 @@
+#ifndef __HEATTRACKITEM_HPP__
+#define __HEATTRACKITEM_HPP__
+
+#include "../Common/TelemetrySeries.hpp"
+#include "TrackGeometry.hpp"
+#include <QtGui>
+
+// Nombre de couleurs de la rampe (lent : bleu -> rapide : rouge)
+#define HEAT_TRACK_BUCKETS 32
+// Epaisseur du trace colore (pixels, independante du zoom)
+#define HEAT_TRACK_WIDTH 3
+
+/* Trace d'un tour colore selon la vitesse.
+ *
+ * Les segments du trace sont ranges une fois pour toutes par couleur :
+ * paint() ne fait qu'un drawLines() par couleur utilisee, quel que soit le
+ * nombre de points. La vitesse de chaque point est interpolee a son instant
+ * dans la serie de vitesse du tour ; les segments ne sont reclasses que si
+ * la plage de vitesses de la rampe ou le niveau de zoom change.
+ *
+ * Les segments relient les points gardes par le TrackGeometry du trace blanc
+ * au niveau de zoom courant ; chacun prend la vitesse moyenne des segments
+ * complets qu'il remplace.
+ *
+ *     HeatTrackItem* heat = new HeatTrackItem(path->geometry(), times, track);
+ *     heat->setLevel(TrackGeometry::levelOf(scale));
+ */
+class HeatTrackItem : public QGraphicsItem
+{
+    public:
+
+        // times : instant (s) de chaque point de geometry
+        HeatTrackItem(const TrackGeometry& geometry, const QVector<qreal>& times,
+                      QGraphicsItem* parent = 0);
+
+        virtual QRectF boundingRect(void) const;
+        virtual void paint(QPainter* painter,
+                           const QStyleOptionGraphicsItem* option,
+                           QWidget* widget);
+
+        // speed : time (s), y (km/h)
+        void setSpeeds(const TelemetrySeries& speed);
+        bool hasSpeeds(void) const;
+        qreal minimumSpeed(void) const;
+        qreal maximumSpeed(void) const;
+
+        // Vitesses associees aux deux extremites de la rampe
+        void setSpeedRange(qreal minimum, qreal maximum);
+
+        int level(void) const;
+        void setLevel(int level);
+
+        static QColor bucketColor(int bucket);
+
+        enum { Type = UserType + 4 };
+        int type() const { return Type; }
+
+    protected:
+
+        void fillBuckets(void);
+
+        TrackGeometry _geometry;    // coordonnees de la scene
+        QVector<qreal> _times;      // instant de chaque point (s)
+        QVector<qreal> _speeds;     // vitesse de chaque segment complet (km/h)
+        QVector<qreal> _speedSums;  // sommes cumulees de _speeds
+        QVector< QVector<QLineF> > _buckets;
+        QRectF _bounds;
+        qreal _minimum;
+        qreal _maximum;
+        int _level;
+};
+
+#endif /* __HEATTRACKITEM_HPP__ */
@@ -45,6 +45,11 @@ MapScene* MapFrame::scene(void) const
     return this->mapScene;
 }
 
+void MapFrame::showDensityLayer(void)
+{
+    this->ui->densityButton->setChecked(true);
+}
+
 // updateScale
 void MapFrame::on_zoomSlider_valueChanged(int value)
 {
@@ -52,6 +57,9 @@ void MapFrame::on_zoomSlider_valueChanged(int value)
 
     this->mapView->resetMatrix();
     this->mapView->scale(scaleFactor, scaleFactor);
+
+    // Less detailed tracks when zoomed out
+    this->mapScene->setViewScale(scaleFactor);
 }
 
 void MapFrame::on_selectPointZoneButton_toggled(bool checked)
@@ -85,6 +93,16 @@ void MapFrame::on_eraseSelectionToolButton_clicked(void)
     this->mapScene->clearSceneSelection();
 }
 
+void MapFrame::on_heatMapButton_toggled(bool checked)
+{
+    this->mapScene->setHeatMapEnabled(checked);
+}
+
+void MapFrame::on_densityButton_toggled(bool checked)
+{
+    this->mapScene->setDensityLayerVisible(checked);
+}
+
 void MapFrame::zoom(int level)
 {
     this->ui->zoomSlider->setValue(this->ui->zoomSlider->value() + level * 2);
@@ -22,6 +22,9 @@ class MapFrame : public QFrame
         MapView*  view(void) const;
         MapScene* scene(void) const;
 
+        // Coche le bouton de la densite apres un nouveau calcul
+        void showDensityLayer(void);
+
     signals:
 
         void clearTracks(void);
@@ -35,6 +38,8 @@ class MapFrame : public QFrame
         void on_dragButton_toggled(bool checked);
         void on_clearToolButton_clicked(void);
         void on_eraseSelectionToolButton_clicked(void);
+        void on_heatMapButton_toggled(bool checked);
+        void on_densityButton_toggled(bool checked);
 
         // Personal slots
         void zoom(int level);
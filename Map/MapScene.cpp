@@ -2,7 +2,8 @@
 
 MapScene::MapScene(qreal ratio, QObject* parent) :
     QGraphicsScene(parent), _amplificationRatio(ratio),
-    _trackAcceptHoverEvents(false), _selectedGroup(NULL)
+    _trackAcceptHoverEvents(false), _heatMap(false), _densityVisible(true),
+    _pointsVisible(false), _zoomLevel(0), _selectedGroup(NULL), _highlight(NULL), _densityLayer(NULL)
 {
 }
 
@@ -11,17 +12,24 @@ MapScene::~MapScene(void)
     delete this->_selectedGroup;
 }
 
-void MapScene::addSector(const QVector<IndexedPosition>& points,
+void MapScene::addSector(const TelemetrySeries& points,
                          const QString& targetCompetition)
 {
+    TRACE_SCOPE("scene", "MapScene::addSector");
+
     // Initialisation du secteur
     SectorItem* newSector = new SectorItem(targetCompetition);
 
-    // Ajout de tous les points dans le secteur
-    foreach (const IndexedPosition& p, points)
-        newSector->append(IndexedPosition(p.x() * this->_amplificationRatio,
-                                          p.y() * -this->_amplificationRatio,
-                                          p.index()));
+    // Ajout de tous les points dans le secteur en une seule fois
+    QList<IndexedPosition> positions;
+    positions.reserve(points.size());
+
+    for (int i(0); i < points.size(); ++i)
+        positions << IndexedPosition(points.x(i) * this->_amplificationRatio,
+                                     points.y(i) * -this->_amplificationRatio,
+                                     points.index(i));
+
+    newSector->append(positions);
 
     // Colorisation du secteur
     ColorPicker picker(6);
@@ -71,13 +79,14 @@ void MapScene::mergeSector(int fstNum, int sndNum)
 
     if (fst != snd)
     {
-        fst->append(snd->points().mid(1));
+        fst->merge(*snd);
         emit sectorUpdated(fst->competition(), fstNum, fst->first(), fst->last());
     }
 
     this->_sectors.removeAt(sndNum);
     this->removeItem(snd);
     emit sectorRemoved(snd->competition(), sndNum);
+    emit sectorsEdited(fst->competition());
 
     this->reorderSectorColors();
 }
@@ -109,37 +118,54 @@ void MapScene::addTrack(const QVector<QPointF>& points)
     this->setSceneRect(this->itemsBoundingRect());
 }
 
-void MapScene::addTrack(const QVector<QPointF>& points,
-                        const QVector<float>& metaData, QVariant idTrack)
+void MapScene::addTrack(const TelemetrySeries& points, QVariant idTrack)
 {
+    TRACE_SCOPE("scene", "MapScene::addTrack");
+
     if (points.isEmpty())
         return;
 
-    QPainterPath route;
+    QVector<QPointF> route(points.size());
+    QVector<float> routeTimes(points.size());
     TrackItem* track = new TrackItem;
     track->setId(idTrack);
 
+    const qreal* xs = points.xData();
+    const qreal* ys = points.yData();
+    const qreal* times = points.timeData();
+
     // Add each CoordinateItems which constitute the track
-    for (int i(0); i < points.count(); i++)
+    for (int i(0); i < points.size(); i++)
     {
-        qreal sx = points[i].x() * this->_amplificationRatio;
-        qreal sy = points[i].y() * -this->_amplificationRatio;
+        qreal sx = xs[i] * this->_amplificationRatio;
+        qreal sy = ys[i] * -this->_amplificationRatio;
 
         CoordinateItem* ci = new CoordinateItem;
         ci->setPos(sx, sy);
         ci->setAcceptHoverEvents(this->_trackAcceptHoverEvents);
-        track->insertCoordinate(ci, metaData.value(i));
+        ci->setVisible(this->_pointsVisible);
+        track->insertCoordinate(ci, times[i]);
 
-        if (i == 0)
-            route.moveTo(sx, sy);
-        else
-            route.lineTo(sx, sy);
+        route[i] = QPointF(sx, sy);
+        routeTimes[i] = times[i];
     }
 
     this->_tracks << track;
+    this->highlightItem()->addCurve(idTrack, routeTimes, route, Qt::red);
     this->addItem(track);
-    QGraphicsItem* path = this->addPath(route, QPen(Qt::white));
-    path->setParentItem(track);
+
+    // Trace simplifie selon le zoom de la vue
+    TrackPathItem* path = new TrackPathItem(route, track);
+    path->setPen(QPen(Qt::white));
+    path->setLevel(this->_zoomLevel);
+    this->_trackPaths << path;
+
+    // Trace colore, visible une fois les vitesses connues
+    HeatTrackItem* heat = new HeatTrackItem(path->geometry(), routeTimes, track);
+    heat->setLevel(this->_zoomLevel);
+    heat->setVisible(false);
+    this->_heatTracks << heat;
+
     this->setSceneRect(this->itemsBoundingRect());
 }
 
@@ -152,9 +178,22 @@ bool MapScene::removeTrack(const QVariant& idTrack)
 
         if (targetTrack->id() == idTrack)
         {
+            for (int h(this->_heatTracks.count() - 1); h >= 0; --h)
+                if (this->_heatTracks.at(h)->parentItem() == targetTrack)
+                    this->_heatTracks.removeAt(h);
+
+            for (int p(this->_trackPaths.count() - 1); p >= 0; --p)
+                if (this->_trackPaths.at(p)->parentItem() == targetTrack)
+                    this->_trackPaths.removeAt(p);
+
             this->_tracks.removeAt(i);
             this->removeItem(targetTrack);
             delete targetTrack;
+
+            if (this->_highlight != NULL)
+                this->_highlight->removeCurve(idTrack);
+
+            this->updateHeatRange();
             return true;
         }
     }
@@ -162,6 +201,143 @@ bool MapScene::removeTrack(const QVariant& idTrack)
     return false;
 }
 
+void MapScene::setTrackSpeeds(const QVariant& idTrack,
+                              const TelemetrySeries& speed)
+{
+    TRACE_SCOPE("scene", "MapScene::setTrackSpeeds");
+
+    foreach (HeatTrackItem* heat, this->_heatTracks)
+    {
+        TrackItem* track = static_cast<TrackItem*>(heat->parentItem());
+
+        if (track->id() == idTrack)
+        {
+            heat->setSpeeds(speed);
+            heat->setVisible(this->_heatMap && heat->hasSpeeds());
+        }
+    }
+
+    this->updateHeatRange();
+}
+
+bool MapScene::isHeatMapEnabled(void) const
+{
+    return this->_heatMap;
+}
+
+void MapScene::setViewScale(qreal scale)
+{
+    int level = TrackGeometry::levelOf(scale);
+
+    if (level == this->_zoomLevel)
+        return;
+
+    this->_zoomLevel = level;
+
+    foreach (TrackPathItem* path, this->_trackPaths)
+        path->setLevel(level);
+
+    foreach (HeatTrackItem* heat, this->_heatTracks)
+        heat->setLevel(level);
+
+    this->updatePointsVisibility();
+}
+
+void MapScene::updatePointsVisibility(void)
+{
+    // Points utiles a la selection et au survol, ou assez espaces pour etre vus
+    bool visible = this->_trackAcceptHoverEvents ||
+                   this->_zoomLevel >= MAP_SCENE_POINTS_MIN_LEVEL;
+
+    if (visible == this->_pointsVisible)
+        return;
+
+    this->_pointsVisible = visible;
+
+    foreach (TrackItem* track, this->_tracks)
+        track->setCoordinatesVisible(visible);
+}
+
+void MapScene::setHeatMapEnabled(bool enable)
+{
+    this->_heatMap = enable;
+
+    foreach (HeatTrackItem* heat, this->_heatTracks)
+        heat->setVisible(enable && heat->hasSpeeds());
+}
+
+void MapScene::updateHeatRange(void)
+{
+    // Meme rampe pour tous les tours affiches : les couleurs se comparent
+    qreal minimum(0), maximum(0);
+    bool first(true);
+
+    foreach (HeatTrackItem* heat, this->_heatTracks)
+    {
+        if (!heat->hasSpeeds())
+            continue;
+
+        minimum = first ? heat->minimumSpeed() : qMin(minimum, heat->minimumSpeed());
+        maximum = first ? heat->maximumSpeed() : qMax(maximum, heat->maximumSpeed());
+        first = false;
+    }
+
+    foreach (HeatTrackItem* heat, this->_heatTracks)
+        if (heat->hasSpeeds())
+            heat->setSpeedRange(minimum, maximum);
+}
+
+void MapScene::setDensityLayer(const QImage& image, const QRectF& bounds)
+{
+    TRACE_SCOPE("scene", "MapScene::setDensityLayer");
+
+    this->clearDensityLayer();
+
+    if (image.isNull() || bounds.isEmpty())
+        return;
+
+    // Un pixel par cellule, haut de l'image au y max (axe y inverse)
+    this->_densityLayer = this->addPixmap(QPixmap::fromImage(image));
+    this->_densityLayer->setTransformationMode(Qt::FastTransformation);
+    this->_densityLayer->setPos(bounds.left() * this->_amplificationRatio,
+                                bounds.bottom() * -this->_amplificationRatio);
+    this->_densityLayer->setTransform(QTransform::fromScale(
+            bounds.width() * this->_amplificationRatio / image.width(),
+            bounds.height() * this->_amplificationRatio / image.height()));
+    this->_densityLayer->setZValue(-2); // sous les secteurs
+    this->_densityLayer->setVisible(this->_densityVisible);
+
+    this->setSceneRect(this->itemsBoundingRect());
+}
+
+bool MapScene::hasDensityLayer(void) const
+{
+    return this->_densityLayer != NULL;
+}
+
+bool MapScene::isDensityLayerVisible(void) const
+{
+    return this->_densityVisible;
+}
+
+void MapScene::setDensityLayerVisible(bool visible)
+{
+    this->_densityVisible = visible;
+
+    if (this->_densityLayer != NULL)
+        this->_densityLayer->setVisible(visible);
+}
+
+void MapScene::clearDensityLayer(void)
+{
+    if (!this->_densityLayer)
+        return;
+
+    this->removeItem(this->_densityLayer);
+    delete this->_densityLayer;
+    this->_densityLayer = NULL;
+}
+
 void MapScene::fixSymbol(float timeValue, QColor color, QVariant trackId)
 {
     //FIXME !!
@@ -257,6 +433,7 @@ void MapScene::cutSectorBetween(const QPointF& p1, const QPointF& p2)
 
                 this->addSectorItem(subSectors.first, i);
                 this->addSectorItem(subSectors.second, i + 1);
+                emit sectorsEdited(subSectors.first->competition());
                 found = true;
             }
         }
@@ -367,40 +544,8 @@ void MapScene::manageSelectedZone(void)
 
 void MapScene::highlightPoint(float timeValue, QVariant trackId)
 {
-    TrackItem* targetTrack(NULL);
-    bool found(false);
-
-    for (int i(0); !found && i < this->_tracks.count(); i++)
-    {
-        TrackItem* tr = this->_tracks[i];
-
-        if (tr->id() == trackId)
-        {
-            found = true;
-            targetTrack = tr;
-        }
-    }
-
-    /* Vu que mnt on a une corrélation parfaite entre les vues graphiques et
-     * la vue mapping, on devrait tjs trouver la trackItem correspondant
-     */
-    if (!found)
-        return;
-
-    CoordinateItem* nearestCoord = targetTrack->nearestCoord(timeValue);
-    if (nearestCoord == NULL)
-        return;
-
-    TickItem* tick = new TickItem;
-    tick->setPos(nearestCoord->pos());
-
-    if (this->_selectedGroup == NULL)
-    {
-        this->_selectedGroup = new QGraphicsItemGroup;
-        this->addItem(this->_selectedGroup);
-    }
-
-    this->_selectedGroup->addToGroup(tick);
+    if (this->_highlight != NULL)
+        this->_highlight->highlightPoint(trackId, timeValue);
 }
 
 void MapScene::highlightOnlySector(float t1, float t2, QVariant trackId)
@@ -411,39 +556,25 @@ void MapScene::highlightOnlySector(float t1, float t2, QVariant trackId)
 
 void MapScene::highlightSector(float t1, float t2, QVariant trackId)
 {
-    qDebug() << "sector délimité sur graphique: " << t1 << t2;
-
-    TrackItem* targetTrack(NULL);
-    bool found(false);
-
-    for (int i(0); !found && i < this->_tracks.count(); i++)
-    {
-        TrackItem* tr = this->_tracks[i];
-
-        if (tr->id() == trackId)
-        {
-            found = true;
-            targetTrack = tr;
-        }
-    }
-
-    if (!found)
-        return;
-
-    AnimateSectorItem* sect = targetTrack->sectorOn(t1, t2);
-    if (sect == NULL)
-        return;
+    if (this->_highlight != NULL)
+        this->_highlight->highlightRange(trackId, t1, t2);
+}
 
-    sect->setBrush(QBrush(Qt::red));
+void MapScene::setReplayTime(float time)
+{
+    if (this->_highlight != NULL)
+        this->_highlight->setCursorTime(time);
+}
 
-    if (this->_selectedGroup == NULL)
-    {
-        this->_selectedGroup = new QGraphicsItemGroup;
-        this->addItem(this->_selectedGroup);
-    }
+void MapScene::clearReplay(void)
+{
+    if (this->_highlight != NULL)
+        this->_highlight->hideCursors();
+}
 
-    this->_selectedGroup->addToGroup(sect);
-    sect->launchAnimation();
+float MapScene::replayDuration(void) const
+{
+    return this->_highlight != NULL ? this->_highlight->duration() : 0;
 }
 
 void MapScene::clearSceneSelection(void)
@@ -454,6 +585,9 @@ void MapScene::clearSceneSelection(void)
         //delete this->_selectedGroup;
         this->_selectedGroup = NULL;
     }
+
+    if (this->_highlight != NULL)
+        this->_highlight->clearHighlights();
 }
 
 void MapScene::clearTracks(void)
@@ -464,6 +598,13 @@ void MapScene::clearTracks(void)
     while (!this->_tracks.isEmpty())
         this->removeItem(this->_tracks.takeFirst());
 
+    this->_heatTracks.clear();
+    this->_trackPaths.clear();
+    this->clearDensityLayer();
+
+    if (this->_highlight != NULL)
+        this->_highlight->clearCurves();
+
     foreach (QGraphicsItemGroup* gr, this->_symbols.values())
         this->removeItem(gr);
 
@@ -473,7 +614,7 @@ void MapScene::clearTracks(void)
 void MapScene::clearSectors(void)
 {
     while (!this->_sectors.isEmpty())
-        this->removeItem(this->_sectors.takeFirst());
+        delete this->_sectors.takeFirst();
 }
 
 void MapScene::clear(void)
@@ -481,6 +622,10 @@ void MapScene::clear(void)
     this->clearSceneSelection();
     this->_sectors.clear();
     this->_tracks.clear();
+    this->_heatTracks.clear();
+    this->_trackPaths.clear();
+    this->_highlight = NULL;
+    this->_densityLayer = NULL;
 }
 
 void MapScene::enableTrackAcceptHoverEvents(bool enable)
@@ -489,6 +634,7 @@ void MapScene::enableTrackAcceptHoverEvents(bool enable)
         this->_tracks[i]->setAcceptHoverEvents(enable);
 
     this->_trackAcceptHoverEvents = enable;
+    this->updatePointsVisibility();
 }
 
 int MapScene::sectorCount(void) const
@@ -532,3 +678,15 @@ void MapScene::reorderSectorColors(void) const
     }
 
 }
+
+HighlightItem* MapScene::highlightItem(void)
+{
+    // Un seul item pour toutes les mises en evidence de la carte
+    if (this->_highlight == NULL)
+    {
+        this->_highlight = new HighlightItem;
+        this->addItem(this->_highlight);
+    }
+
+    return this->_highlight;
+}
@@ -2,17 +2,26 @@
 #define __MAPSCENE_HPP__
 
 #include "TrackItem.hpp"
+#include "HeatTrackItem.hpp"
+#include "TrackPathItem.hpp"
 #include "TickItem.hpp"
 #include "PathBuilder.hpp"
-#include "CurvePathBuilder.hpp"
 #include "SectorItem.hpp"
 #include "AnimateSectorItem.hpp"
 #include "MapView.hpp"
 #include "../Common/ColorPicker.hpp"
 #include "../Common/IndexedPosition.hpp"
+#include "../Common/TelemetrySeries.hpp"
 #include "../Common/CoordinateItem.hpp"
+#include "../Common/HighlightItem.hpp"
+#include "../Utils/Trace.hpp"
 #include <QtGui>
 
+/* Niveau de zoom (voir TrackGeometry) a partir duquel les points GPS des
+ * tours sont dessines : en dessous, plusieurs points tombent sur le meme
+ * pixel et seul le trace simplifie est affiche */
+#define MAP_SCENE_POINTS_MIN_LEVEL 2
+
 class MapScene : public QGraphicsScene
 {
     Q_OBJECT
@@ -22,16 +31,28 @@ class MapScene : public QGraphicsScene
         MapScene(qreal ratio = 1, QObject* parent = 0);
         virtual ~MapScene(void);
 
-        void addSector(const QVector<IndexedPosition>& points,
+        void addSector(const TelemetrySeries& points,
                        const QString &targetCompetition = QString());
         bool hasSectors(void) const;
         void mergeSector(int fstNum, int sndNum);
         void addTrack(const QVector<QPointF>& points);
-        void addTrack(const QVector<QPointF>& points,
-                      const QVector<float>& metaData,
+        void addTrack(const TelemetrySeries& track,
                       QVariant idTrack = QVariant());
         bool removeTrack(const QVariant& idTrack);
 
+        // Coloration des traces selon la vitesse (speed : time (s), y (km/h))
+        void setTrackSpeeds(const QVariant& idTrack, const TelemetrySeries& speed);
+        bool isHeatMapEnabled(void) const;
+
+        /* Image de densite des tours (DensityRaster::toImage) couvrant bounds,
+         * en coordonnees de projection comme les traces */
+        void setDensityLayer(const QImage& image, const QRectF& bounds);
+        bool hasDensityLayer(void) const;
+        bool isDensityLayerVisible(void) const;
+
+        // Duree du trace le plus long, pour la relecture (LapReplay)
+        float replayDuration(void) const;
+
         void fixSymbol(float timeValue, QColor color, QVariant trackId);
         void removeSymbol(QVariant trackId);
 
@@ -40,6 +61,7 @@ class MapScene : public QGraphicsScene
         void sectorRemoved(QString, int);
         void sectorAdded(QString, int, IndexedPosition, IndexedPosition);
         void sectorUpdated(QString, int, IndexedPosition, IndexedPosition);
+        void sectorsEdited(QString); // fin d'une coupe ou d'une fusion
 
         void pointSelected(float absciss, QVariant idTrack);
         void intervalSelected(float firstAbsciss, float secondAbsciss, QVariant idTrack);
@@ -51,26 +73,43 @@ class MapScene : public QGraphicsScene
         void highlightPoint(float timeValue, QVariant trackId);
         void highlightSector(float t1, float t2, QVariant trackId);
         void highlightOnlySector(float t1, float t2, QVariant trackId);
+        void setReplayTime(float time); // s depuis le depart de chaque trace
+        void clearReplay(void);
         void clearSceneSelection(void);
         void clearTracks(void);
         void clearSectors(void);
+        void clearDensityLayer(void);
+        void setDensityLayerVisible(bool visible); // garde l'image calculee
         void clear(void);
         void enableTrackAcceptHoverEvents(bool enable);
+        void setHeatMapEnabled(bool enable);
+        void setViewScale(qreal scale); // choisit le niveau des traces
         int  sectorCount(void) const;
 
     private:
 
         void addSectorItem(SectorItem* sect, int index);
         void reorderSectorColors(void) const;
+        void updateHeatRange(void);
+        void updatePointsVisibility(void);
+        HighlightItem* highlightItem(void);
 
     protected:
 
         qreal _amplificationRatio;
         bool _trackAcceptHoverEvents;
+        bool _heatMap;
+        bool _densityVisible;
+        bool _pointsVisible;
+        int _zoomLevel;
 
         QList<SectorItem*> _sectors;
         QList<TrackItem*> _tracks;
+        QList<HeatTrackItem*> _heatTracks;
+        QList<TrackPathItem*> _trackPaths;
         QGraphicsItemGroup* _selectedGroup;
+        HighlightItem* _highlight;
+        QGraphicsPixmapItem* _densityLayer;
         QMap<int, QGraphicsItemGroup*> _symbols;
 };
 
@@ -0,0 +1,205 @@
+#include "SectorGeometry.hpp"
+#include <qmath.h>
+
+namespace
+{
+    // Normale unitaire du segment a -> b, nulle si le segment est vide
+    inline bool unitNormal(const QPointF& a, const QPointF& b, QPointF& normal)
+    {
+        qreal dx = b.x() - a.x();
+        qreal dy = b.y() - a.y();
+        qreal length = qSqrt(dx * dx + dy * dy);
+
+        if (length <= 0)
+            return false;
+
+        // Meme sens que QLineF::normalVector()
+        normal = QPointF(dy / length, -dx / length);
+        return true;
+    }
+}
+
+SectorGeometry::SectorGeometry(qreal width) :
+    _halfWidth(width / 2), _outlineValid(false)
+{
+}
+
+int SectorGeometry::size(void) const
+{
+    return this->_points.size();
+}
+
+bool SectorGeometry::isEmpty(void) const
+{
+    return this->_points.isEmpty();
+}
+
+qreal SectorGeometry::width(void) const
+{
+    return this->_halfWidth * 2;
+}
+
+const QVector<QPointF>& SectorGeometry::points(void) const
+{
+    return this->_points;
+}
+
+const QVector<QPointF>& SectorGeometry::offsets(void) const
+{
+    return this->_offsets;
+}
+
+void SectorGeometry::append(const QPointF& point)
+{
+    this->append(QVector<QPointF>() << point);
+}
+
+void SectorGeometry::append(const QVector<QPointF>& points)
+{
+    if (points.isEmpty())
+        return;
+
+    int previousSize = this->_points.size();
+    this->_points += points;
+    this->_offsets.resize(this->_points.size());
+
+    // Le dernier point existant a un nouveau voisin
+    this->updateOffsets(previousSize - 1, this->_points.size() - 1);
+}
+
+void SectorGeometry::append(const SectorGeometry& other, int from)
+{
+    from = qMax(0, from);
+    if (from >= other.size())
+        return;
+
+    int previousSize = this->_points.size();
+    this->_points += other._points.mid(from);
+    this->_offsets += other._offsets.mid(from);
+
+    // Seuls les deux points de part et d'autre de la jonction changent
+    this->updateOffsets(previousSize - 1, previousSize);
+}
+
+int SectorGeometry::crossing(const QLineF& line, QPointF* intersection) const
+{
+    QPointF point;
+
+    for (int i(1); i < this->_points.size(); ++i)
+    {
+        QLineF segment(this->_points.at(i - 1), this->_points.at(i));
+
+        if (line.intersect(segment, &point) == QLineF::BoundedIntersection)
+        {
+            if (intersection != 0)
+                *intersection = point;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+QPair<SectorGeometry, SectorGeometry> SectorGeometry::split(
+        int index, const QPointF& cut) const
+{
+    QPair<SectorGeometry, SectorGeometry> parts(SectorGeometry(this->width()),
+                                                SectorGeometry(this->width()));
+    index = qBound(0, index, this->_points.size());
+
+    // Premiere partie : debut du trace puis point de coupe
+    SectorGeometry& first = parts.first;
+    first._points = this->_points.mid(0, index);
+    first._offsets = this->_offsets.mid(0, index);
+    first._points << cut;
+    first._offsets << QPointF();
+    first.updateOffsets(index - 1, index);
+
+    // Seconde partie : point de coupe puis fin du trace
+    SectorGeometry& second = parts.second;
+    second._points << cut;
+    second._offsets << QPointF();
+    second._points += this->_points.mid(index);
+    second._offsets += this->_offsets.mid(index);
+    second.updateOffsets(0, 1);
+
+    return parts;
+}
+
+const QPolygonF& SectorGeometry::outline(void) const
+{
+    if (this->_outlineValid)
+        return this->_outline;
+
+    int size = this->_points.size();
+    this->_outline.clear();
+    this->_outlineValid = true;
+
+    if (size < 2)
+        return this->_outline;
+
+    // Bord interieur a l'endroit, bord exterieur a l'envers, puis fermeture
+    this->_outline.resize(2 * size + 1);
+
+    const QPointF* points = this->_points.constData();
+    const QPointF* offsets = this->_offsets.constData();
+    QPointF* outline = this->_outline.data();
+
+    for (int i(0); i < size; ++i)
+    {
+        outline[i] = points[i] + offsets[i];
+        outline[2 * size - 1 - i] = points[i] - offsets[i];
+    }
+
+    outline[2 * size] = outline[0];
+
+    return this->_outline;
+}
+
+QPainterPath SectorGeometry::path(void) const
+{
+    QPainterPath path;
+    path.addPolygon(this->outline());
+    path.closeSubpath();
+
+    return path;
+}
+
+void SectorGeometry::updateOffsets(int from, int to)
+{
+    from = qMax(0, from);
+    to = qMin(to, this->_points.size() - 1);
+
+    for (int i(from); i <= to; ++i)
+        this->_offsets[i] = this->offsetAt(i);
+
+    this->_outlineValid = false;
+}
+
+QPointF SectorGeometry::offsetAt(int index) const
+{
+    QPointF before, after;
+    bool hasBefore = index > 0 &&
+            unitNormal(this->_points.at(index - 1), this->_points.at(index), before);
+    bool hasAfter = index < this->_points.size() - 1 &&
+            unitNormal(this->_points.at(index), this->_points.at(index + 1), after);
+
+    if (!hasBefore && !hasAfter)
+        return QPointF();
+
+    if (!hasBefore || !hasAfter)
+        return (hasBefore ? before : after) * this->_halfWidth;
+
+    // Bissectrice des deux normales, allongee pour garder la largeur
+    QPointF bisector = before + after;
+    qreal length = qSqrt(bisector.x() * bisector.x() + bisector.y() * bisector.y());
+
+    if (length <= 1e-9) // demi-tour
+        return before * this->_halfWidth;
+
+    bisector /= length;
+    qreal cosine = bisector.x() * before.x() + bisector.y() * before.y();
+    qreal scale = 1 / qMax(cosine, 1 / SECTOR_GEOMETRY_MITER_LIMIT);
+
+    return bisector * (this->_halfWidth * scale);
+}
@@ -0,0 +1,67 @@
+#ifndef __SECTORGEOMETRY_HPP__
+#define __SECTORGEOMETRY_HPP__
+
+#include <QtGui>
+
+// Largeur de la bande d'un secteur (unites de la scene)
+#define SECTOR_GEOMETRY_WIDTH 2.0
+// Allongement maximal du decalage dans les virages serres
+#define SECTOR_GEOMETRY_MITER_LIMIT 2.0
+
+/* Forme d'un secteur : bande de largeur constante autour de son trace.
+ *
+ * Les points du trace sont ranges dans un tableau contigu, avec pour chacun
+ * son decalage vers le bord interieur (normale moyenne des deux segments
+ * voisins). Le bord interieur vaut point + decalage, le bord exterieur
+ * point - decalage : les deux bords sont obtenus en un seul parcours.
+ *
+ * Le decalage d'un point ne depend que de ses voisins. Ajouter des points,
+ * couper ou joindre deux formes ne recalcule donc que les points autour de
+ * la jonction ; les autres decalages sont recopies. Le contour (bord
+ * interieur puis bord exterieur a l'envers) est garde jusqu'a la prochaine
+ * modification.
+ *
+ *     SectorGeometry geometry;
+ *     geometry.append(points);
+ *     item->setPath(geometry.path());
+ */
+class SectorGeometry
+{
+    public:
+
+        explicit SectorGeometry(qreal width = SECTOR_GEOMETRY_WIDTH);
+
+        int size(void) const;
+        bool isEmpty(void) const;
+        qreal width(void) const;
+        const QVector<QPointF>& points(void) const;
+        const QVector<QPointF>& offsets(void) const;
+
+        void append(const QPointF& point);
+        void append(const QVector<QPointF>& points);
+        // Jonction : les points de other a partir de from sont ajoutes
+        void append(const SectorGeometry& other, int from = 0);
+
+        /* Premier segment [index - 1, index] coupe par line, -1 si aucun.
+         * Le point d'intersection est place dans intersection */
+        int crossing(const QLineF& line, QPointF* intersection = 0) const;
+        // Coupe au point cut, situe sur le segment [index - 1, index]
+        QPair<SectorGeometry, SectorGeometry> split(int index,
+                                                    const QPointF& cut) const;
+
+        const QPolygonF& outline(void) const;
+        QPainterPath path(void) const;
+
+    protected:
+
+        void updateOffsets(int from, int to);
+        QPointF offsetAt(int index) const;
+
+        qreal _halfWidth;
+        QVector<QPointF> _points;
+        QVector<QPointF> _offsets;
+        mutable QPolygonF _outline;
+        mutable bool _outlineValid;
+};
+
+#endif /* __SECTORGEOMETRY_HPP__ */
@@ -1,52 +1,45 @@
 #include "SectorItem.hpp"
 
 SectorItem::SectorItem(const QString& owningCompetition, QGraphicsItem* parent)
-    : QGraphicsPathItem(parent), _pathBuilder(NULL),
-      _competition(owningCompetition)
+    : QGraphicsPathItem(parent), _competition(owningCompetition)
 {
 }
 
 SectorItem::~SectorItem(void)
 {
-    delete this->_pathBuilder;
 }
 
 QPair<SectorItem *, SectorItem *> SectorItem::split(QLineF splittingLine)
 {
-    int currentIndex(1);
-    int count(this->_mainLine.count());
-    bool match(false);
     QPointF pointIntersection;
     QPair<SectorItem*, SectorItem*> subSectors;
 
-    while (currentIndex < count && !match)
-    {
-        QLineF segment(this->_mainLine.at(currentIndex - 1),
-                       this->_mainLine.at(currentIndex));
+    int currentIndex = this->_geometry.crossing(splittingLine, &pointIntersection);
+    if (currentIndex < 0)
+        return subSectors;
 
-        if (splittingLine.intersect(segment, &pointIntersection)
-                == QLineF::BoundedIntersection)
-        {
-            SectorItem* first = new SectorItem(this->_competition);
-            SectorItem* second = new SectorItem(this->_competition);
+    IndexedPosition indexedIntersection(pointIntersection);
+    float intersectionIndex = this->_mainLine[currentIndex].index();
+    indexedIntersection.setIndex(intersectionIndex);
 
-            IndexedPosition indexedIntersection(pointIntersection);
-            float intersectionIndex = this->_mainLine[currentIndex].index();
-            indexedIntersection.setIndex(intersectionIndex);
+    // Les decalages deja calcules sont repris, seule la coupe est recalculee
+    QPair<SectorGeometry, SectorGeometry> geometries =
+            this->_geometry.split(currentIndex, pointIntersection);
 
-            first->append(this->_mainLine.mid(0, currentIndex));
-            first->append(indexedIntersection, splittingLine);
+    SectorItem* first = new SectorItem(this->_competition);
+    first->_mainLine = this->_mainLine.mid(0, currentIndex);
+    first->_mainLine << indexedIntersection;
+    first->_geometry = geometries.first;
+    first->updatePath();
 
-            second->append(indexedIntersection, splittingLine);
-            second->append(this->_mainLine.mid(currentIndex));
+    SectorItem* second = new SectorItem(this->_competition);
+    second->_mainLine << indexedIntersection;
+    second->_mainLine += this->_mainLine.mid(currentIndex);
+    second->_geometry = geometries.second;
+    second->updatePath();
 
-            subSectors.first = first;
-            subSectors.second = second;
-            match = true;
-        }
-
-        currentIndex++;
-    }
+    subSectors.first = first;
+    subSectors.second = second;
 
     return subSectors;
 }
@@ -55,55 +48,35 @@ void SectorItem::append(const IndexedPosition& point, const QLineF& dirVect)
 {
     Q_UNUSED(dirVect);
 
-    /*
-    this->_mainLines << point;
-
-    if (this->_mainLines.count() == 2)
-    {
-        this->_pathBuilder = new CurvePathBuilder(this->_mainLines.at(0),
-                                                  this->_mainLines.at(1));
-    }
-    else if (this->_mainLines.count() > 2)
-    {
-        this->_pathBuilder->append(point);
-        this->updatePath();
-    }
-    */
-
-    this->addPoint(point);
+    this->_mainLine << point;
+    this->_geometry.append(point);
     this->updatePath();
 }
 
 void SectorItem::append(const QList<IndexedPosition>& points)
 {
-    /*
-    int count(points.count());
-    int i(0);
+    QVector<QPointF> positions;
+    positions.reserve(points.count());
 
-    if (this->_pathBuilder == NULL && this->_mainLines.count() + count >= 2)
-    {
-        for(; this->_mainLines.count() < 2; i++)
-            this->_mainLines << points.at(i);
+    for(int i(0); i < points.count(); ++i)
+        positions << points.at(i);
 
-        this->_pathBuilder = new CurvePathBuilder(this->_mainLines.at(0),
-                                                  this->_mainLines.at(1));
-    }
+    // Un seul calcul de la forme pour tous les points
+    this->_mainLine += points;
+    this->_geometry.append(positions);
+    this->updatePath();
+}
 
-    if (this->_mainLines.count() < 2)
+void SectorItem::merge(const SectorItem& other)
+{
+    if (other._mainLine.isEmpty())
         return;
 
-    for(; i < count; i++)
-    {
-        this->_mainLines << points.at(i);
-        this->_pathBuilder->append(points.at(i));
-    }
-
-    this->updatePath();
-    */
-
-    for(int i(0); i < points.count(); ++i)
-        this->addPoint(points.at(i));
+    // Le premier point de other est le dernier de ce secteur
+    int from = this->_mainLine.isEmpty() ? 0 : 1;
 
+    this->_mainLine += other._mainLine.mid(from);
+    this->_geometry.append(other._geometry, from);
     this->updatePath();
 }
 
@@ -140,23 +113,7 @@ void SectorItem::setOwningCompetition(const QString& owningCompetition)
 
 void SectorItem::updatePath()
 {
-    if (this->_pathBuilder == NULL) return;
-
-    QPainterPath newPath;
-    newPath.addPath(this->_pathBuilder->inBound());
-
-    QPainterPath exBound = this->_pathBuilder->exBound().toReversed();
-    newPath.connectPath(exBound);
-    this->setPath(newPath);
-}
-
-void SectorItem::addPoint(const IndexedPosition &point)
-{
-    this->_mainLine << point;
+    if (this->_geometry.size() < 2) return;
 
-    if (this->_mainLine.count() == 2)
-        this->_pathBuilder = new CurvePathBuilder(this->_mainLine.at(0),
-                                                  this->_mainLine.at(1));
-    else if (this->_mainLine.count() > 2)
-        this->_pathBuilder->append(point);
+    this->setPath(this->_geometry.path());
 }
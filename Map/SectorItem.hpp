@@ -2,7 +2,7 @@
 #define __SECTORITEM_HPP__
 
 #include "../Common/IndexedPosition.hpp"
-#include "CurvePathBuilder.hpp"
+#include "SectorGeometry.hpp"
 #include <QGraphicsPathItem>
 
 class SectorItem : public QGraphicsPathItem
@@ -17,6 +17,7 @@ class SectorItem : public QGraphicsPathItem
         void append(const IndexedPosition& point,
                     const QLineF& dirVect = QLineF());
         void append(const QList<IndexedPosition>& points);
+        void merge(const SectorItem& other);
         QPair<IndexedPosition, IndexedPosition> boundaries(void) const;
         IndexedPosition first(void) const;
         IndexedPosition last(void) const;
@@ -27,12 +28,11 @@ class SectorItem : public QGraphicsPathItem
     private:
 
         void updatePath(void);
-        void addPoint(const IndexedPosition& point); // Amélioration
 
     protected:
 
         QList<IndexedPosition> _mainLine;
-        CurvePathBuilder* _pathBuilder;
+        SectorGeometry _geometry;
         QString _competition;
 };
 
@@ -0,0 +1,157 @@
+#include "TrackGeometry.hpp"
+#include <qmath.h>
+#include <functional>
+#include <queue>
+#include <limits>
+
+namespace
+{
+    qreal triangleArea(const QPointF& a, const QPointF& b, const QPointF& c)
+    {
+        return qAbs((b.x() - a.x()) * (c.y() - a.y())
+                    - (c.x() - a.x()) * (b.y() - a.y())) / 2;
+    }
+}
+
+TrackGeometry::TrackGeometry(const QVector<QPointF>& points) :
+    _points(points)
+{
+    this->computeImportance();
+}
+
+int TrackGeometry::size(void) const
+{
+    return this->_points.size();
+}
+
+const QVector<QPointF>& TrackGeometry::points(void) const
+{
+    return this->_points;
+}
+
+const QVector<qreal>& TrackGeometry::importance(void) const
+{
+    return this->_importance;
+}
+
+QVector<int> TrackGeometry::indexes(qreal tolerance) const
+{
+    qreal threshold = tolerance * tolerance;
+    QVector<int> kept;
+
+    for (int i(0); i < this->_importance.size(); ++i)
+        if (this->_importance.at(i) >= threshold)
+            kept << i;
+
+    return kept;
+}
+
+QPainterPath TrackGeometry::path(int level) const
+{
+    level = qBound(TRACK_GEOMETRY_MIN_LEVEL, level, TRACK_GEOMETRY_MAX_LEVEL);
+
+    QHash<int, QPainterPath>::const_iterator it = this->_paths.constFind(level);
+    if (it != this->_paths.constEnd())
+        return it.value();
+
+    QPainterPath path;
+    QVector<int> kept = this->indexes(toleranceOf(level));
+
+    for (int k(0); k < kept.size(); ++k)
+    {
+        if (k == 0)
+            path.moveTo(this->_points.at(kept.at(k)));
+        else
+            path.lineTo(this->_points.at(kept.at(k)));
+    }
+
+    this->_paths.insert(level, path);
+    return path;
+}
+
+int TrackGeometry::levelOf(qreal scale)
+{
+    if (scale <= 0)
+        return TRACK_GEOMETRY_MIN_LEVEL;
+
+    // Niveau dont l'echelle est juste inferieure : ecart < 2 * tolerance
+    int level = qFloor(qLn(scale) / qLn(2.0) + 1e-9);
+    return qBound(TRACK_GEOMETRY_MIN_LEVEL, level, TRACK_GEOMETRY_MAX_LEVEL);
+}
+
+qreal TrackGeometry::toleranceOf(int level)
+{
+    // Taille d'un pixel dans la scene a l'echelle 2^level
+    return TRACK_GEOMETRY_TOLERANCE / qPow(2.0, level);
+}
+
+void TrackGeometry::computeImportance(void)
+{
+    int size = this->_points.size();
+    this->_importance.fill(std::numeric_limits<qreal>::infinity(), size);
+
+    if (size < 3)
+        return;
+
+    // Liste doublement chainee des points restants
+    QVector<int> previous(size);
+    QVector<int> next(size);
+    QVector<bool> removed(size, false);
+
+    for (int i(0); i < size; ++i)
+    {
+        previous[i] = i - 1;
+        next[i] = i + 1;
+    }
+
+    // File de priorite sur l'aire ; les entrees perimees sont ignorees
+    typedef std::pair<qreal, int> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > queue;
+
+    for (int i(1); i < size - 1; ++i)
+    {
+        this->_importance[i] = triangleArea(this->_points.at(i - 1),
+                                            this->_points.at(i),
+                                            this->_points.at(i + 1));
+        queue.push(Entry(this->_importance.at(i), i));
+    }
+
+    qreal largest(0);
+
+    while (!queue.empty())
+    {
+        Entry entry = queue.top();
+        queue.pop();
+
+        int i = entry.second;
+        if (removed.at(i) || entry.first != this->_importance.at(i))
+            continue;
+
+        /* Un point ne peut pas etre moins important qu'un point retire avant
+         * lui : l'ordre de retrait est conserve par le seuil */
+        largest = qMax(largest, entry.first);
+        this->_importance[i] = largest;
+        removed[i] = true;
+
+        int p = previous.at(i);
+        int n = next.at(i);
+        next[p] = n;
+        previous[n] = p;
+
+        if (p > 0)
+        {
+            this->_importance[p] = triangleArea(this->_points.at(previous.at(p)),
+                                                this->_points.at(p),
+                                                this->_points.at(n));
+            queue.push(Entry(this->_importance.at(p), p));
+        }
+
+        if (n < size - 1)
+        {
+            this->_importance[n] = triangleArea(this->_points.at(p),
+                                                this->_points.at(n),
+                                                this->_points.at(next.at(n)));
+            queue.push(Entry(this->_importance.at(n), n));
+        }
+    }
+}
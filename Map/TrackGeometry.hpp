@@ -0,0 +1,53 @@
+#ifndef __TRACKGEOMETRY_HPP__
+#define __TRACKGEOMETRY_HPP__
+
+#include <QtGui>
+
+// Ecart tolere entre le trace simplifie et le trace complet (pixels)
+#define TRACK_GEOMETRY_TOLERANCE 0.5
+// Niveaux de zoom : la vue est a l'echelle 2^niveau (MapFrame::zoomSlider)
+#define TRACK_GEOMETRY_MIN_LEVEL -5
+#define TRACK_GEOMETRY_MAX_LEVEL 5
+
+/* Trace d'un tour a plusieurs resolutions.
+ *
+ * L'importance de chaque point est calculee une seule fois a la
+ * construction (algorithme de Visvalingam : aire du triangle forme avec
+ * ses voisins au moment ou il serait retire). Simplifier a une tolerance
+ * donnee revient alors a garder les points dont l'importance depasse le
+ * carre de la tolerance, sans recalcul.
+ *
+ * path() renvoie le trace d'un niveau de zoom : la tolerance vaut
+ * TRACK_GEOMETRY_TOLERANCE pixel a l'echelle de ce niveau. Chaque niveau
+ * n'est construit qu'une fois.
+ *
+ *     TrackGeometry geometry(points);     // coordonnees de la scene
+ *     item->setPath(geometry.path(TrackGeometry::levelOf(scale)));
+ */
+class TrackGeometry
+{
+    public:
+
+        explicit TrackGeometry(const QVector<QPointF>& points = QVector<QPointF>());
+
+        int size(void) const;
+        const QVector<QPointF>& points(void) const;
+        const QVector<qreal>& importance(void) const;
+
+        // Indices des points gardes pour un ecart tolere (unites de la scene)
+        QVector<int> indexes(qreal tolerance) const;
+        QPainterPath path(int level) const;
+
+        static int levelOf(qreal scale);
+        static qreal toleranceOf(int level);
+
+    protected:
+
+        void computeImportance(void);
+
+        QVector<QPointF> _points;
+        QVector<qreal> _importance; // aire effective, infinie aux extremites
+        mutable QHash<int, QPainterPath> _paths;
+};
+
+#endif /* __TRACKGEOMETRY_HPP__ */
@@ -8,6 +8,14 @@ TrackItem::TrackItem(int id, QGraphicsItem *parent) :
 // insertion d'une coordonnée dans la liste chainée suivant le timestamp
 void TrackItem::insertCoordinate(CoordinateItem* coord, float timestamp)
 {
+    // Points ajoutes dans l'ordre (MapScene::addTrack) : pas de parcours
+    if (this->_timeTrack.isEmpty() || this->_timeTrack.last().first <= timestamp)
+    {
+        this->_timeTrack.append(QPair<float, CoordinateItem*>(timestamp, coord));
+        coord->setParentItem(this);
+        return;
+    }
+
     QMutableLinkedListIterator< QPair<float, CoordinateItem*> > it(this->_timeTrack);
     bool inserted(false);
 
@@ -43,6 +51,14 @@ void TrackItem::setAcceptHoverEvents(bool enabled)
     //QGraphicsItem::setAcceptHoverEvents(enabled);
 }
 
+void TrackItem::setCoordinatesVisible(bool visible)
+{
+    QLinkedListIterator< QPair<float, CoordinateItem*> > it(this->_timeTrack);
+
+    while (it.hasNext())
+        it.next().second->setVisible(visible);
+}
+
 QVariant TrackItem::id(void) const
 {
     return this->_internalId;
@@ -71,47 +87,6 @@ CoordinateItem* TrackItem::nearestCoord(float time)
     return NULL;
 }
 
-AnimateSectorItem* TrackItem::sectorOn(float t1, float t2)
-{
-    QLinkedListIterator< QPair<float, CoordinateItem*> > it(this->_timeTrack);
-    QPair<float, CoordinateItem*> elem;
-    AnimateSectorItem* sect(NULL);
-    bool firstFound(false);
-    bool secondFound(false);
-    int index(0);
-    float lowerBound = qMin(t1, t2);
-    float upperBound = qMax(t1, t2);
-
-    while (it.hasNext() && (!firstFound || !secondFound))
-    {
-        elem = it.next();
-
-        if (!firstFound && elem.first > lowerBound)
-        {
-            firstFound = true;
-            sect = new AnimateSectorItem;
-        }
-
-        if (firstFound)
-        {
-            IndexedPosition pos;
-            pos.setX(elem.second->x());
-            pos.setY(elem.second->y());
-            pos.setIndex(index);
-            index++;
-            sect->append(pos);
-
-            if (elem.first > upperBound)
-            {
-                secondFound = true;
-            }
-        }
-
-    }
-
-    return sect;
-}
-
 float TrackItem::getAssociateTime(const CoordinateItem* coord) const
 {
     QLinkedListIterator< QPair<float, CoordinateItem*> > it(this->_timeTrack);
@@ -1,7 +1,6 @@
 #ifndef __TRACKITEM_HPP__
 #define __TRACKITEM_HPP__
 
-#include "AnimateSectorItem.hpp"
 #include "../Common/CoordinateItem.hpp"
 #include "../Common/IndexedPosition.hpp"
 #include <QtGui>
@@ -17,12 +16,12 @@ class TrackItem : public QGraphicsItem
         virtual QRectF boundingRect(void) const;
         virtual void paint(QPainter*,const QStyleOptionGraphicsItem*, QWidget*);
         virtual void setAcceptHoverEvents(bool enabled);
+        void setCoordinatesVisible(bool visible);
 
         QVariant id(void) const;
         void setId(QVariant id);
 
         CoordinateItem* nearestCoord(float time);
-        AnimateSectorItem* sectorOn(float t1, float t2);
 
         float getAssociateTime(const CoordinateItem* coord) const;
 
@@ -0,0 +1,29 @@
+#include "TrackPathItem.hpp"
+
+TrackPathItem::TrackPathItem(const QVector<QPointF>& points,
+                             QGraphicsItem* parent) :
+    QGraphicsPathItem(parent), _geometry(points), _level(0)
+{
+    this->setPath(this->_geometry.path(this->_level));
+}
+
+const TrackGeometry& TrackPathItem::geometry(void) const
+{
+    return this->_geometry;
+}
+
+int TrackPathItem::level(void) const
+{
+    return this->_level;
+}
+
+void TrackPathItem::setLevel(int level)
+{
+    level = qBound(TRACK_GEOMETRY_MIN_LEVEL, level, TRACK_GEOMETRY_MAX_LEVEL);
+
+    if (level == this->_level)
+        return;
+
+    this->_level = level;
+    this->setPath(this->_geometry.path(level));
+}
@@ -0,0 +1,27 @@
+#ifndef __TRACKPATHITEM_HPP__
+#define __TRACKPATHITEM_HPP__
+
+#include "TrackGeometry.hpp"
+#include <QtGui>
+
+/* Trace d'un tour sur la carte, simplifie selon le niveau de zoom de la vue
+ * (voir TrackGeometry) */
+class TrackPathItem : public QGraphicsPathItem
+{
+    public:
+
+        explicit TrackPathItem(const QVector<QPointF>& points,
+                               QGraphicsItem* parent = 0);
+
+        const TrackGeometry& geometry(void) const;
+
+        int level(void) const;
+        void setLevel(int level);
+
+    protected:
+
+        TrackGeometry _geometry;
+        int _level;
+};
+
+#endif /* __TRACKPATHITEM_HPP__ */
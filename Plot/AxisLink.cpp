@@ -0,0 +1,88 @@
+#include "AxisLink.hpp"
+
+AxisLink::AxisLink(QObject* parent) :
+    QObject(parent), _source(NULL), _left(0), _right(0), _enabled(true),
+    _applying(false)
+{
+    // Une seule mise a jour par image, quel que soit le nombre de changements
+    this->_timer.setSingleShot(true);
+    this->_timer.setInterval(AXIS_LINK_FRAME_INTERVAL);
+
+    connect(&this->_timer, SIGNAL(timeout()), this, SLOT(applyRange()));
+}
+
+void AxisLink::addView(PlotView* view)
+{
+    if (view == NULL || this->_views.contains(view))
+        return;
+
+    this->_views << view;
+
+    connect(view, SIGNAL(rectChange(QRectF)),
+            this, SLOT(viewRangeChanged(QRectF)));
+    connect(view, SIGNAL(destroyed(QObject*)),
+            this, SLOT(viewDestroyed(QObject*)));
+}
+
+void AxisLink::removeView(PlotView* view)
+{
+    if (!this->_views.removeOne(view))
+        return;
+
+    view->disconnect(this);
+
+    if (this->_source == view)
+        this->_source = NULL;
+}
+
+int AxisLink::viewCount(void) const
+{
+    return this->_views.count();
+}
+
+bool AxisLink::isEnabled(void) const
+{
+    return this->_enabled;
+}
+
+void AxisLink::setEnabled(bool enabled)
+{
+    this->_enabled = enabled;
+
+    if (!enabled)
+        this->_timer.stop();
+}
+
+void AxisLink::viewRangeChanged(const QRectF& rect)
+{
+    // Recadrage fait par le lien lui-meme : il n'est pas renvoye
+    if (!this->_enabled || this->_applying || rect.width() <= 0)
+        return;
+
+    this->_source = qobject_cast<PlotView*>(this->sender());
+    this->_left = rect.left();
+    this->_right = rect.right();
+
+    if (!this->_timer.isActive())
+        this->_timer.start();
+}
+
+void AxisLink::viewDestroyed(QObject* view)
+{
+    // Le pointeur ne sert qu'a la comparaison : la vue est deja detruite
+    this->_views.removeAll(static_cast<PlotView*>(view));
+
+    if (this->_source == view)
+        this->_source = NULL;
+}
+
+void AxisLink::applyRange(void)
+{
+    this->_applying = true;
+
+    foreach (PlotView* view, this->_views)
+        if (view != this->_source)
+            view->setHorizontalRange(this->_left, this->_right);
+
+    this->_applying = false;
+}
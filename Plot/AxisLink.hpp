@@ -0,0 +1,59 @@
+#ifndef __AXISLINK_HPP__
+#define __AXISLINK_HPP__
+
+#include "PlotView.hpp"
+#include <QtGui>
+
+// Intervalle entre deux mises a jour des graphiques lies (ms, une image)
+#define AXIS_LINK_FRAME_INTERVAL 16
+
+/* Axe horizontal partage par plusieurs graphiques.
+ *
+ * Chaque zoom ou deplacement d'une vue liee (PlotView::rectChange) est
+ * repercute sur l'axe horizontal des autres vues, leur axe vertical est
+ * garde. Les changements sont regroupes : seule la derniere etendue recue
+ * est appliquee, une fois par image, et une vue qui affiche deja cette
+ * etendue n'est pas recadree.
+ *
+ * Les vues liees doivent avoir la meme unite en abscisse (temps ou
+ * distance).
+ *
+ *     AxisLink* timeAxis = new AxisLink(this);
+ *     timeAxis->addView(timePlotFrame->view());
+ *     timeAxis->addView(megaSquirtPlotFrame->view());
+ */
+class AxisLink : public QObject
+{
+    Q_OBJECT
+
+    public:
+
+        explicit AxisLink(QObject* parent = 0);
+
+        void addView(PlotView* view);
+        void removeView(PlotView* view);
+        int viewCount(void) const;
+        bool isEnabled(void) const;
+
+    public slots:
+
+        void setEnabled(bool enabled);
+
+    protected slots:
+
+        void viewRangeChanged(const QRectF& rect);
+        void viewDestroyed(QObject* view);
+        void applyRange(void);
+
+    protected:
+
+        QList<PlotView*> _views;
+        PlotView* _source; // vue a l'origine de la derniere etendue
+        qreal _left;
+        qreal _right;
+        bool _enabled;
+        bool _applying;
+        QTimer _timer;
+};
+
+#endif /* __AXISLINK_HPP__ */
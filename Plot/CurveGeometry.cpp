@@ -0,0 +1,140 @@
+#include "CurveGeometry.hpp"
+
+CurveGeometry::CurveGeometry(void) :
+    _coarse(false), _indexesSorted(true), _xsSorted(true)
+{
+}
+
+CurveGeometry CurveGeometry::fromSeries(const TelemetrySeries& series)
+{
+    const qreal* xs = series.xData();
+    const qreal* ys = series.yData();
+    const float* indexes = series.indexData();
+
+    CurveGeometry geometry;
+    geometry.reserve(series.size());
+
+    for (int i(0); i < series.size(); ++i)
+        geometry.append(QPointF(xs[i], ys[i]), indexes[i]);
+
+    return geometry;
+}
+
+CurveGeometry CurveGeometry::fromPoints(const QList<QPointF>& points)
+{
+    CurveGeometry geometry;
+    geometry.reserve(points.size());
+
+    // Sans index, comme un CoordinateItem cree sans setIndex()
+    foreach (const QPointF& point, points)
+        geometry.append(point, 0);
+
+    return geometry;
+}
+
+CurveGeometry CurveGeometry::coarse(const TelemetrySeries& series, int buckets)
+{
+    CurveGeometry geometry;
+    geometry._coarse = true;
+
+    int size = series.size();
+    if (size == 0 || buckets <= 0)
+        return geometry;
+
+    const qreal* xs = series.xData();
+    const qreal* ys = series.yData();
+
+    // Minimum et maximum de chaque tranche, dans l'ordre de la courbe
+    buckets = qMin(buckets, size);
+    geometry._points.reserve(2 * buckets);
+
+    for (int b(0); b < buckets; ++b)
+    {
+        int first = qint64(b) * size / buckets;
+        int last = qint64(b + 1) * size / buckets;
+        int lowest(first), highest(first);
+
+        for (int i(first + 1); i < last; ++i)
+        {
+            if (ys[i] < ys[lowest])
+                lowest = i;
+            else if (ys[i] > ys[highest])
+                highest = i;
+        }
+
+        geometry._points << QPointF(xs[qMin(lowest, highest)], ys[qMin(lowest, highest)]);
+        if (lowest != highest)
+            geometry._points << QPointF(xs[qMax(lowest, highest)], ys[qMax(lowest, highest)]);
+    }
+
+    geometry._bounds = geometry._points.boundingRect();
+    return geometry;
+}
+
+void CurveGeometry::reserve(int size)
+{
+    this->_points.reserve(size);
+    this->_indexes.reserve(size);
+}
+
+void CurveGeometry::append(const QPointF& point, float index)
+{
+    if (!this->_points.isEmpty())
+    {
+        this->_indexesSorted &= this->_indexes.last() <= index;
+        this->_xsSorted &= this->_points.last().x() <= point.x();
+
+        // QRectF::united() ignore les rectangles vides
+        this->_bounds.setCoords(qMin(this->_bounds.left(), point.x()),
+                                qMin(this->_bounds.top(), point.y()),
+                                qMax(this->_bounds.right(), point.x()),
+                                qMax(this->_bounds.bottom(), point.y()));
+    }
+    else
+    {
+        this->_bounds = QRectF(point, QSizeF(0, 0));
+    }
+
+    this->_points << point;
+    this->_indexes << index;
+}
+
+int CurveGeometry::size(void) const
+{
+    return this->_points.size();
+}
+
+bool CurveGeometry::isEmpty(void) const
+{
+    return this->_points.isEmpty();
+}
+
+bool CurveGeometry::isCoarse(void) const
+{
+    return this->_coarse;
+}
+
+QRectF CurveGeometry::bounds(void) const
+{
+    return this->_bounds;
+}
+
+const QPolygonF& CurveGeometry::points(void) const
+{
+    return this->_points;
+}
+
+const QVector<float>& CurveGeometry::indexes(void) const
+{
+    return this->_indexes;
+}
+
+bool CurveGeometry::indexesSorted(void) const
+{
+    return this->_indexesSorted;
+}
+
+bool CurveGeometry::xsSorted(void) const
+{
+    return this->_xsSorted;
+}
@@ -0,0 +1,61 @@
+#ifndef __CURVEGEOMETRY_HPP__
+#define __CURVEGEOMETRY_HPP__
+
+#include "../Common/TelemetrySeries.hpp"
+#include <QtGui>
+
+// Tranches de la version grossiere d'une courbe (un minimum et un maximum par tranche)
+#define CURVE_GEOMETRY_COARSE_BUCKETS 512
+
+/* Geometrie d'une courbe, sans aucun item graphique.
+ *
+ * Les points et les colonnes de recherche (index, tri) sont de simples
+ * tableaux : la geometrie complete peut etre construite dans un autre
+ * thread (QtConcurrent::run) puis publiee d'un seul coup dans la courbe
+ * (PlotCurve::setGeometry), la copie ne coutant qu'un compteur de
+ * references.
+ *
+ * coarse() construit en un passage une version reduite qui garde le
+ * minimum et le maximum de chaque tranche : la forme et les pics de la
+ * courbe restent visibles pendant son chargement. Elle ne sert qu'au
+ * dessin, ses colonnes de recherche sont vides.
+ *
+ *     curve->setGeometry(CurveGeometry::coarse(series));
+ *     QFuture<CurveGeometry> future =
+ *             QtConcurrent::run(&CurveGeometry::fromSeries, series);
+ */
+class CurveGeometry
+{
+    public:
+
+        CurveGeometry(void);
+
+        static CurveGeometry fromSeries(const TelemetrySeries& series);
+        static CurveGeometry fromPoints(const QList<QPointF>& points);
+        static CurveGeometry coarse(const TelemetrySeries& series,
+                                    int buckets = CURVE_GEOMETRY_COARSE_BUCKETS);
+
+        void reserve(int size);
+        void append(const QPointF& point, float index);
+
+        int size(void) const;
+        bool isEmpty(void) const;
+        bool isCoarse(void) const;
+        QRectF bounds(void) const;
+
+        const QPolygonF& points(void) const;
+        const QVector<float>& indexes(void) const;
+        bool indexesSorted(void) const;
+        bool xsSorted(void) const;
+
+    protected:
+
+        QPolygonF _points;
+        QVector<float> _indexes;
+        QRectF _bounds;
+        bool _coarse;
+        bool _indexesSorted;
+        bool _xsSorted;
+};
+
+#endif /* __CURVEGEOMETRY_HPP__ */
@@ -30,6 +30,9 @@ void HorizontalScale::cursorAt(QPoint pos)
 
 void HorizontalScale::paintEvent(QPaintEvent *)
 {
+    // Graduations recalculees seulement si l'etendue a change
+    this->adjust();
+
     QPainter painter(this);
     int len = width();
     float incX = float(len) / numTicks;
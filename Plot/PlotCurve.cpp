@@ -1,67 +1,120 @@
 #include "PlotCurve.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Recherche du premier point d'abscisse superieure (std::upper_bound)
+    struct XBefore
+    {
+        bool operator()(qreal x, const QPointF& point) const
+        {
+            return x < point.x();
+        }
+
+        bool operator()(const QPointF& point, qreal x) const
+        {
+            return point.x() < x;
+        }
+    };
+}
 
 PlotCurve::PlotCurve(QVariant id, QGraphicsItem *parent) :
-    QGraphicsItem(parent), last(NULL), internalId(id)
+    QGraphicsItem(parent), curveVisible(true), pointsVisible(true),
+    internalId(id)
 {
+    // exposedRect : seule la partie visible du trace est dessinee
+    this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
 }
 
 PlotCurve::PlotCurve(const QList<QPointF> &p, QVariant id,
                      QGraphicsItem *parent) :
-    QGraphicsItem(parent), last(NULL), internalId(id)
+    QGraphicsItem(parent), curveVisible(true), pointsVisible(true),
+    internalId(id)
 {
-    foreach (const QPointF& point, p)
-    {
-        CoordinateItem* item = new CoordinateItem(point.x(), point.y(), this);
-        item->setAcceptHoverEvents(true);
-        this->addToCurve(item);
-    }
+    this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    this->setGeometry(CurveGeometry::fromPoints(p));
+    this->populate(p.size());
 }
 
-PlotCurve::PlotCurve(const QList<IndexedPosition> &p, QVariant id,
+PlotCurve::PlotCurve(const TelemetrySeries &p, QVariant id,
                      QGraphicsItem *parent) :
-    QGraphicsItem(parent), last(NULL), internalId(id)
+    QGraphicsItem(parent), curveVisible(true), pointsVisible(true),
+    internalId(id)
 {
-    foreach (const IndexedPosition& ip, p)
-    {
-        CoordinateItem* item = new CoordinateItem(ip.x(), ip.y(), this);
-        item->setIndex(ip.index());
-        item->setAcceptHoverEvents(true);
-        this->addToCurve(item);
-    }
+    this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    this->setGeometry(CurveGeometry::fromSeries(p));
+    this->populate(p.size());
 }
 
 void PlotCurve::addToCurve(QGraphicsItem *item)
 {
-    /* S'il y a déjà un point qui compose le tracé, on ajoute une ligne de ce
-     * dernier point, jusqu'au coordonnées du item (qui est en réalité
-     * un CoordinateItem ) */
-    if (last != NULL)
-    {
-        QGraphicsLineItem* line = new QGraphicsLineItem(last->x() , last->y(), item->x(), item->y(), this);
-        line->setPen(pen);
-        curve << line; // Ajout du segment de ligne au tracé
-    }
-
     /* Ajout du point (CoordinateItem) à la liste des points qui composent
-     * le tracé + renseigné comme étant le dernier point ajouté */
+     * le tracé : le trait le rejoint au dernier point */
     CoordinateItem* citem = qgraphicsitem_cast<CoordinateItem*>(item);
-    if (citem != NULL)
+    if (citem == NULL || this->geometry.isCoarse())
+        return;
+
+    citem->setPen(this->pen);
+    citem->setAcceptHoverEvents(true);
+    citem->setVisible(this->pointsVisible);
+    points << citem;
+
+    this->prepareGeometryChange();
+    this->geometry.append(citem->pos(), citem->index().toFloat());
+}
+
+void PlotCurve::setGeometry(const CurveGeometry& geometry)
+{
+    // Les points deja crees appartiennent a l'ancien trace
+    qDeleteAll(this->points);
+    this->points.clear();
+
+    this->prepareGeometryChange();
+    this->geometry = geometry;
+    this->update();
+}
+
+const CurveGeometry& PlotCurve::curveGeometry(void) const
+{
+    return this->geometry;
+}
+
+int PlotCurve::populate(int count)
+{
+    // La version grossiere ne sert qu'au dessin du trait
+    if (this->geometry.isCoarse())
+        return 0;
+
+    const QPolygonF& positions = this->geometry.points();
+    const QVector<float>& indexes = this->geometry.indexes();
+
+    int first = this->points.count();
+    int last = qMin(first + qMax(0, count), positions.size());
+
+    for (int i(first); i < last; ++i)
     {
-        QPen p(pen.color().dark());
-        p.setWidth(5);
-        citem->setPen(p);
-        citem->setAcceptHoverEvents(true);
-        points << citem;
-        last = item;
+        CoordinateItem* item = new CoordinateItem(positions.at(i).x(),
+                                                  positions.at(i).y(), this);
+        item->setIndex(indexes.at(i));
+        item->setPen(this->pen);
+        item->setAcceptHoverEvents(true);
+        item->setVisible(this->pointsVisible);
+        this->points << item;
     }
+
+    return last - first;
+}
+
+bool PlotCurve::isPopulated(void) const
+{
+    return !this->geometry.isCoarse()
+            && this->points.count() >= this->geometry.size();
 }
 
 void PlotCurve::setCurveVisible(bool visible)
 {
     curveVisible = visible;
-
-    foreach (QGraphicsLineItem* item, curve)
-        item->setVisible(visible);
+    this->update();
 }
 
 void PlotCurve::setPointsVisible(bool visible)
@@ -76,12 +129,6 @@ void PlotCurve::setPen(const QPen& p)
 {
     pen = p;
 
-    foreach (QGraphicsItem* item, curve)
-    {
-        QGraphicsLineItem* lineItem =  (QGraphicsLineItem*) item;
-        lineItem->setPen(p);
-    }
-
     foreach (QGraphicsItem* item, points)
     {
         CoordinateItem* citem = qgraphicsitem_cast<CoordinateItem*> (item);
@@ -89,6 +136,8 @@ void PlotCurve::setPen(const QPen& p)
         if (citem != NULL)
             citem->setPen(pen);
     }
+
+    this->update();
 }
 
 QVariant PlotCurve::id(void) const
@@ -103,181 +152,162 @@ QPen PlotCurve::getPen(void) const
 
 QRectF PlotCurve::boundingRect() const
 {
-    return childrenBoundingRect();
-}
-
-void PlotCurve::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(painter)
-    Q_UNUSED(option)
-    Q_UNUSED(widget)
+    return this->geometry.bounds();
 }
 
-CoordinateItem* PlotCurve::nearestCoord(float time)
+void PlotCurve::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    bool found(false);
-    CoordinateItem* currentItem = NULL;
-
-    for (int i(0); !found && i < this->points.count(); ++i)
-    {
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
+    Q_UNUSED(widget)
 
-        if (currentItem == NULL)
-            continue;
+    const QPolygonF& polyline = this->geometry.points();
+    if (!this->curveVisible || polyline.size() < 2)
+        return;
 
-        /*
-        if (currentItem->index().toFloat() >= time)
-            found = true;
-        */
+    int first(0), last(polyline.size());
 
-        found = currentItem->index().toFloat() >= time;
+    // Abscisses triees : seuls les segments de la zone exposee sont dessines
+    if (this->geometry.xsSorted())
+    {
+        first = std::lower_bound(polyline.constBegin(), polyline.constEnd(),
+                                 option->exposedRect.left(), XBefore())
+                - polyline.constBegin();
+        last = std::upper_bound(polyline.constBegin(), polyline.constEnd(),
+                                option->exposedRect.right(), XBefore())
+                - polyline.constBegin();
+
+        first = qMax(0, first - 1);
+        last = qMin(polyline.size(), last + 1);
     }
 
-    return found ? currentItem : NULL;
+    if (last - first < 2)
+        return;
+
+    // Trait d'un pixel quelle que soit l'echelle du graphique
+    QPen linePen(this->pen);
+    linePen.setCosmetic(true);
+    painter->setPen(linePen);
+    painter->drawPolyline(polyline.constData() + first, last - first);
 }
 
-QList<CoordinateItem*> PlotCurve::nearestCoordinateitems(float timeValue) const
+CoordinateItem* PlotCurve::nearestCoord(float time)
 {
-    int seconde = qRound(timeValue);
-    QList<CoordinateItem*> coordinatesAtFixedTime;
-    CoordinateItem* currentItem = NULL;
+    int i = this->lowerIndex(time);
 
-    for(int i(0); i < this->points.count(); i++)
+    if (i < 0) // index non trie : parcours complet
     {
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
-
-        if (currentItem == NULL)
-            continue;
-
-        /* Vérifie si la valeur absolue de l'heure à laquelle la coordonnée
-         * du graphique correspond à la valeur absolue de l'heure à laquelle
-         * la coordonnée GPS sélectionnée dans la vue mapping à été prise */
-        if (qRound(currentItem->index().toFloat()) == seconde)
-            coordinatesAtFixedTime.append(currentItem);
+        const QVector<float>& indexes = this->geometry.indexes();
+        for (i = 0; i < indexes.size(); ++i)
+            if (indexes.at(i) >= time)
+                break;
     }
 
-    return coordinatesAtFixedTime;
+    return this->coordinateAt(i);
 }
 
-QList<CoordinateItem*> PlotCurve::onSector(float minTimeValue, float maxTimeValue) const
+QList<CoordinateItem*> PlotCurve::nearestCoordinateitems(float timeValue) const
 {
-    int lowerBound = qRound(minTimeValue);
-    int upperBound = qRound(maxTimeValue);
+    /* Les deux points qui encadrent timeValue (un seul s'il y a egalite ou
+     * si timeValue est hors de la courbe) */
     QList<CoordinateItem*> items;
-    CoordinateItem* currentItem = NULL;
-    int currentItemTime;
+    const QVector<float>& indexes = this->geometry.indexes();
+    int i = this->lowerIndex(timeValue);
 
-    for (int i(0); i < this->points.count(); i++)
+    if (i < 0) // index non trie : parcours complet
     {
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
+        for (i = 0; i < indexes.size(); ++i)
+            if (indexes.at(i) >= timeValue)
+                break;
+    }
 
-        if (currentItem == NULL)
-            continue;
+    if ((i == indexes.size() || indexes.at(i) > timeValue) && i > 0)
+        items << this->coordinateAt(i - 1);
 
-        currentItemTime = qRound(currentItem->index().toFloat());
-        if(currentItemTime >= lowerBound && currentItemTime <= upperBound)
-            items.append(currentItem);
-    }
+    if (i < indexes.size())
+        items << this->coordinateAt(i);
 
+    items.removeAll(NULL);
     return items;
 }
 
-AnimateSectorItem* PlotCurve::sectorOn(float timeValue) const
+QList<CoordinateItem*> PlotCurve::onSector(float minTimeValue, float maxTimeValue) const
 {
-    int seconde = qRound(timeValue);
-    CoordinateItem* currentItem = NULL;
-    int index(0);
-    AnimateSectorItem* sect = NULL;
+    QList<CoordinateItem*> items;
+    const QVector<float>& indexes = this->geometry.indexes();
+    int first = this->lowerIndex(minTimeValue);
 
-    for(int i(0); i < this->points.count(); i++)
+    if (first < 0) // index non trie : parcours complet
     {
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
-
-        if (currentItem == NULL)
-            continue;
-
-        /* Vérifie si la valeur absolue de l'heure à laquelle la coordonnée
-         * du graphique correspond à la valeur absolue de l'heure à laquelle
-         * la coordonnée GPS sélectionnée dans la vue mapping à été prise */
-        if (qRound(currentItem->index().toFloat()) == seconde)
-        {
-            IndexedPosition pos;
-            pos.setX(currentItem->x());
-            pos.setY(currentItem->y());
-            pos.setIndex(index++);
-
-            if(sect == NULL)
-                sect = new AnimateSectorItem;
-
-            sect->append(pos);
-        }
+        for (int i(0); i < indexes.size(); ++i)
+            if (indexes.at(i) >= minTimeValue && indexes.at(i) <= maxTimeValue)
+                items << this->coordinateAt(i);
     }
-
-    return sect;
-}
-
-AnimateSectorItem* PlotCurve::sectorOn(float minTimeValue, float maxTimeValue) const
-{
-    int lowerBound = qRound(minTimeValue);
-    int upperBound = qRound(maxTimeValue);
-    CoordinateItem* currentItem = NULL;
-    int currentItemTime;
-    int index(0);
-    AnimateSectorItem* sect = NULL;
-
-    for (int i(0); i < this->points.count(); i++)
+    else
     {
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
+        for (int i(first); i < indexes.size()
+                           && indexes.at(i) <= maxTimeValue; ++i)
+            items << this->coordinateAt(i);
+    }
 
-        if (currentItem == NULL)
-            continue;
+    items.removeAll(NULL);
 
-        currentItemTime = qRound(currentItem->index().toFloat());
-        if(currentItemTime >= lowerBound && currentItemTime <= upperBound)
-        {
-            IndexedPosition pos;
-            pos.setX(currentItem->x());
-            pos.setY(currentItem->y());
-            pos.setIndex(index++);
+    // Intervalle plus court que l'echantillonnage : points qui l'encadrent
+    if (items.isEmpty() && !indexes.isEmpty()
+            && minTimeValue >= indexes.first()
+            && minTimeValue <= indexes.last())
+        items = this->nearestCoordinateitems(minTimeValue);
 
-            if(sect == NULL)
-                sect = new AnimateSectorItem;
+    return items;
+}
 
-            sect->append(pos);
-        }
-    }
+const QVector<float>& PlotCurve::indexValues(void) const
+{
+    return this->geometry.indexes();
+}
 
-    return sect;
+const QVector<QPointF>& PlotCurve::pointPositions(void) const
+{
+    return this->geometry.points();
 }
 
 CoordinateItem* PlotCurve::nearestCoordinateitemsOfX(qreal x)
 {
-    /*
-    bool found(false);
-    CoordinateItem* nearestItem;
-    CoordinateItem* currentItem = NULL;
+    int i = this->upperX(x);
 
-    for (int i(0); i < this->points.count() && !found; i++)
+    if (i < 0) // abscisses non triees : parcours complet
     {
-        nearestItem = currentItem;
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
-
-        if (currentItem->x() > x)
-            found = true;
+        const QPolygonF& positions = this->geometry.points();
+        for (i = 0; i < positions.size(); ++i)
+            if (positions.at(i).x() > x)
+                break;
     }
 
-    return found ? nearestItem : NULL;
-    */
+    return this->coordinateAt(i);
+}
 
-    bool found(false);
-    CoordinateItem* currentItem = NULL;
+int PlotCurve::lowerIndex(float timeValue) const
+{
+    if (!this->geometry.indexesSorted())
+        return -1;
 
-    for (int i(0); i < this->points.count() && !found; i++)
-    {
-        currentItem = qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
+    const QVector<float>& indexes = this->geometry.indexes();
+    return qLowerBound(indexes.constBegin(), indexes.constEnd(), timeValue)
+            - indexes.constBegin();
+}
 
-        if (currentItem->x() > x)
-            found = true;
-    }
+int PlotCurve::upperX(qreal x) const
+{
+    if (!this->geometry.xsSorted())
+        return -1;
+
+    const QPolygonF& positions = this->geometry.points();
+    return std::upper_bound(positions.constBegin(), positions.constEnd(), x,
+                            XBefore()) - positions.constBegin();
+}
+
+CoordinateItem* PlotCurve::coordinateAt(int i) const
+{
+    if (i < 0 || i >= this->points.count())
+        return NULL;
 
-    return found ? currentItem : NULL;
+    return qgraphicsitem_cast<CoordinateItem*>(this->points.at(i));
 }
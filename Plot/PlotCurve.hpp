@@ -2,10 +2,24 @@
 #define __PLOTCURVE_HPP__
 
 #include "../Common/IndexedPosition.hpp"
+#include "../Common/TelemetrySeries.hpp"
 #include "../Common/CoordinateItem.hpp"
-#include "../Map/AnimateSectorItem.hpp"
+#include "CurveGeometry.hpp"
 #include <QtGui>
 
+/* Courbe d'un graphique.
+ *
+ * Le trace est dessine par la courbe elle-meme a partir de sa geometrie
+ * (CurveGeometry) ; seuls les points (CoordinateItem, selection et survol)
+ * sont des items. La geometrie peut etre remplacee d'un coup
+ * (setGeometry) et les points crees par paquets (populate) : PlotScene
+ * affiche ainsi une grande courbe sans bloquer l'interface.
+ *
+ *     PlotCurve* curve = new PlotCurve(id);
+ *     curve->setGeometry(CurveGeometry::fromSeries(series));
+ *     while (!curve->isPopulated())
+ *         curve->populate(1000);
+ */
 class PlotCurve : public QGraphicsItem
 {
     public:
@@ -13,11 +27,17 @@ class PlotCurve : public QGraphicsItem
         PlotCurve(QVariant id = QVariant(), QGraphicsItem* parent = 0);
         PlotCurve(const QList<QPointF>& p, QVariant id = QVariant(),
                   QGraphicsItem* parent = 0);
-        PlotCurve(const QList<IndexedPosition>& p, QVariant id = QVariant(),
+        PlotCurve(const TelemetrySeries& p, QVariant id = QVariant(),
                   QGraphicsItem* parent = 0);
 
         void addToCurve(QGraphicsItem *item); // Ajouter un CoordinateItem (point) au tracé
-        void setCurveVisible(bool visible); // Modifie le flag visible de toutes les lignes qui composent le tracé
+
+        // Remplace le trace ; les points deja crees sont retires
+        void setGeometry(const CurveGeometry& geometry);
+        const CurveGeometry& curveGeometry(void) const;
+        int populate(int count); // cree au plus count points, renvoie leur nombre
+        bool isPopulated(void) const;
+        void setCurveVisible(bool visible); // Affiche ou masque le trait du tracé
         void setPointsVisible(bool visible); // Modifie le flag visible de tous les points qui composent le tracé
         void setPen(const QPen& p); // Modifie le "pen" de toutes les les lignes et point du tracé
         QVariant id(void) const; // Retourne index (et non l'identifiant) associé au tracé --> tous les points ont le même index
@@ -29,8 +49,10 @@ class PlotCurve : public QGraphicsItem
         CoordinateItem* nearestCoord(float time);
         QList<CoordinateItem*> nearestCoordinateitems(float timeValue) const;
         QList<CoordinateItem*> onSector(float minTimeValue, float maxTimeValue) const;
-        AnimateSectorItem* sectorOn(float timeValue) const;
-        AnimateSectorItem* sectorOn(float minTimeValue, float maxTimeValue) const;
+
+        // Colonnes des points, dans l'ordre d'ajout
+        const QVector<float>& indexValues(void) const;
+        const QVector<QPointF>& pointPositions(void) const;
 
         // ----------- Ajout, utile pour savoir ou afficher un label -----------
         CoordinateItem* nearestCoordinateitemsOfX(qreal x);
@@ -41,13 +63,22 @@ class PlotCurve : public QGraphicsItem
 
     protected:
 
-        QList<QGraphicsLineItem*> curve; // toutes les lignes qui composent le tracé sur le graphique --> permet d'afficher seulement des lignes sur le graphique
+        /* Recherche par dichotomie dans les colonnes triees. Renvoient le
+         * nombre de points si rien n'est trouve, -1 si la colonne n'est pas
+         * triee */
+        int lowerIndex(float timeValue) const; // premier index >= timeValue
+        int upperX(qreal x) const;             // premier x > x
+        CoordinateItem* coordinateAt(int i) const;
+
         QList<QGraphicsItem*> points;    // tous les points qui composent le tracé sur le graphique --> permet d'aficher seulement les points sur le graphique --> il ajoute des CoordinateItem en réallité
-        QGraphicsItem* last; // dernier point, utilisé pour raccorder les lignes ensemble au fur et a mesure des ajouts de points qui composent le tracé --> est un CoordinateItem
         QPen pen;
         bool curveVisible;  // Définir si on doit afficher les lignes sur le graphique
         bool pointsVisible; // Définir si on doit afficher les points sur le graphique
         QVariant internalId; // index --> tous les points ont le même index
+
+        /* Trace et colonnes des index (temps) des points, dans l'ordre
+         * d'ajout : les recherches par temps n'ont pas à parcourir la scène */
+        CurveGeometry geometry;
 };
 
 #endif /* __PLOTCURVE_HPP__ */
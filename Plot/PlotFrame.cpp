@@ -264,6 +264,12 @@ void PlotFrame::on_restoreDefaultPlotSizeToolButton_clicked(void)
     this->plotView->restoreSceneRect();
 }
 
+void PlotFrame::updateScales(void)
+{
+    // Same rect: the view is not moved, the scales read it again
+    this->plotView->updateSceneRect(this->plotView->sceneRect());
+}
+
 void PlotFrame::adaptScales(const QRectF& newRect)
 {
     emit this->minVChanged(newRect.top());
@@ -27,6 +27,7 @@ class PlotFrame : public QFrame
 
         void addVerticalAxis(VerticalScale* scale);
         void addHorizontalAxis(HorizontalScale* scale);
+        void updateScales(void); // after an axis translation or scale change
 
     signals:
 
@@ -1,10 +1,18 @@
 #include "PlotScene.hpp"
 
+#if QT_VERSION >= 0x050000
+#include <QtConcurrent>
+#endif
+
 PlotScene::PlotScene(QWidget* widgetParent, QObject *parent) :
     QGraphicsScene(parent), selectionLocked(0), pointsVisible(true),
     curvesVisible(true), curveLabelsVisible(false), selectedGroup(NULL),
-    widgetParent(widgetParent)
+    highlight(NULL), widgetParent(widgetParent)
 {
+    // Points of the loading curves are created between two input events
+    this->populateTimer.setInterval(0);
+    connect(&this->populateTimer, SIGNAL(timeout()),
+            this, SLOT(populateCurves()));
 }
 
 void PlotScene::addCurve(PlotCurve *curve)
@@ -19,6 +27,10 @@ void PlotScene::addCurve(PlotCurve *curve)
     this->curves.append(curve);
     this->addItem(curve);
 
+    // A coarse curve is registered once its whole geometry is published
+    if (!curve->curveGeometry().isCoarse())
+        this->registerCurve(curve);
+
     // Apply the visibility options
     curve->setPointsVisible(this->pointsVisible);
     curve->setCurveVisible(this->curvesVisible);
@@ -33,6 +45,8 @@ void PlotScene::addCurve(PlotCurve *curve)
 PlotCurve* PlotScene::addCurve(const QList<QPointF>& points,
                                const QVariant& curveId)
 {
+    TRACE_SCOPE("scene", "PlotScene::addCurve");
+
     // Create curve with points list
     PlotCurve* curve = new PlotCurve(points, curveId);
 
@@ -42,15 +56,33 @@ PlotCurve* PlotScene::addCurve(const QList<QPointF>& points,
     return curve;
 }
 
-PlotCurve* PlotScene::addCurve(const QList<IndexedPosition>& points,
+PlotCurve* PlotScene::addCurve(const TelemetrySeries& points,
                                const QVariant& curveId)
 {
-    // Create curve with points list
-    PlotCurve* curve = new PlotCurve(points, curveId);
+    TRACE_SCOPE("scene", "PlotScene::addCurve");
 
-    // Add the curve to the scene
+    // Small curve : built at once
+    if (points.size() <= PLOT_SCENE_POINTS_PER_FRAME)
+    {
+        PlotCurve* curve = new PlotCurve(points, curveId);
+        this->addCurve(curve);
+
+        return curve;
+    }
+
+    /* Large curve : its coarse version is displayed at once, the whole
+     * geometry is built in another thread then published in one swap */
+    PlotCurve* curve = new PlotCurve(curveId);
+    curve->setGeometry(CurveGeometry::coarse(points));
     this->addCurve(curve);
 
+    QFutureWatcher<CurveGeometry>* watcher =
+            new QFutureWatcher<CurveGeometry>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(publishGeometry()));
+
+    this->loadingCurves.insert(watcher, curve);
+    watcher->setFuture(QtConcurrent::run(&CurveGeometry::fromSeries, points));
+
     return curve;
 }
 
@@ -63,9 +95,13 @@ bool PlotScene::removeCurves(const QVariant& idTrack)
 
         if(targetCurve->id() == idTrack)
         {
+            this->cancelLoading(targetCurve);
             this->curves.removeAt(i);
             this->removeItem(targetCurve);
             delete targetCurve;
+
+            if (this->highlight != NULL)
+                this->highlight->removeCurve(idTrack);
             return true;
         }
     }
@@ -131,13 +167,18 @@ void PlotScene::clearPlotSelection(void)
         delete this->selectedGroup;
         this->selectedGroup = NULL;
     }
+
+    if (this->highlight != NULL)
+        this->highlight->clearHighlights();
 }
 
 void PlotScene::clearCurves(void)
 {
+    this->cancelLoading();
     this->clearPlotSelection();
     this->curves.clear();       // Clear the list of curves
     this->clear();              // Clear the scene
+    this->highlight = NULL;     // Deleted with the other items
 
     foreach (QLabel* curveLabel, this->curveLabels)
         delete curveLabel;
@@ -147,124 +188,88 @@ void PlotScene::clearCurves(void)
 
 void PlotScene::highlightPoint(float timeValue, const QVariant &trackId)
 {
-    PlotCurve* targetPlotCurve = NULL;
-
-    // Find the curve associate to trackId of the point selected on the mapping
-    for(int i(0); targetPlotCurve == NULL && i < this->curves.count(); i++)
-        if (this->curves.at(i)->id() == trackId)
-            targetPlotCurve = this->curves[i];
+    if (this->highlight != NULL)
+        this->highlight->highlightPoint(trackId, timeValue);
+}
 
-    if (targetPlotCurve == NULL)
-    {
-        qDebug() << "No PlotCurve associate to the trackId found";
-        return;
-    }
+void PlotScene::highlightPoints(float timeValue, const QVariant& trackId)
+{
+    // Points a moins d'une demi-seconde de l'instant selectionne
+    if (this->highlight != NULL)
+        this->highlight->highlightRange(trackId, timeValue - 0.5,
+                                        timeValue + 0.5);
+}
 
-    CoordinateItem* nearestCoord = targetPlotCurve->nearestCoord(timeValue);
-    if (nearestCoord == NULL)
-        return;
+void PlotScene::highlightSector(float t1, float t2, const QVariant& trackId)
+{
+    if (this->highlight != NULL)
+        this->highlight->highlightRange(trackId, t1, t2);
+}
 
-    TickItem* tick = new TickItem(true);
-    tick->setPos(nearestCoord->pos());
+void PlotScene::highlightOnlySector(float t1, float t2, QVariant trackId)
+{
+    this->clearPlotSelection();
+    this->highlightSector(t1, t2, trackId);
+}
 
-    /* Create the group that will contain all the GraphicsItem corresponding
-     * to the selected zone or point */
-    if (this->selectedGroup == NULL)
-    {
-        this->selectedGroup = new QGraphicsItemGroup;
-        this->addItem(this->selectedGroup);
-    }
+void PlotScene::setReplayTime(float time)
+{
+    // Only the cursors are repainted, the curves are left untouched
+    if (this->highlight != NULL)
+        this->highlight->setCursorTime(time);
+}
 
-    this->selectedGroup->addToGroup(tick);
-    tick->launchAnimation();
+void PlotScene::clearReplay(void)
+{
+    if (this->highlight != NULL)
+        this->highlight->hideCursors();
 }
 
-void PlotScene::highlightPoints(float timeValue, const QVariant& trackId)
+float PlotScene::replayDuration(void) const
 {
-    PlotCurve* targetPlotCurve = NULL;
+    return this->highlight != NULL ? this->highlight->duration() : 0;
+}
 
-    // Find the curve associate to trackId of the point selected on the mapping
-    for(int i(0); targetPlotCurve == NULL && i < this->curves.count(); i++)
-        if (this->curves.at(i)->id() == trackId)
-            targetPlotCurve = this->curves[i];
+bool PlotScene::isLoading(void) const
+{
+    return !this->loadingCurves.isEmpty() || !this->populatingCurves.isEmpty();
+}
 
-    if (targetPlotCurve == NULL)
-    {
-        qDebug() << "No PlotCurve associate to the trackId found";
-        return;
-    }
+void PlotScene::publishGeometry(void)
+{
+    QObject* watcher = this->sender();
+    PlotCurve* curve = this->loadingCurves.take(watcher);
 
-    /* Get the sector that contains all the points
-     * corresponding to the timeValue */
-    AnimateSectorItem* sect = targetPlotCurve->sectorOn(timeValue);
-    if (sect == NULL)
-    {
-        qDebug() << "impossible de déterminer le secteur correspondant "
-                 << "à la sélection de la vue mapping";
+    if (watcher == NULL || curve == NULL)
         return;
-    }
-
-    // The sector will have the same color that the curve
-    sect->setBrush(targetPlotCurve->getPen().brush());
 
-    /* Create the group that will contain all the GraphicsItem corresponding
-     * to the selected zone or point */
-    if (this->selectedGroup == NULL)
-    {
-        this->selectedGroup = new QGraphicsItemGroup;
-        this->addItem(this->selectedGroup);
-    }
+    watcher->deleteLater();
 
-    this->selectedGroup->addToGroup(sect);
-    sect->launchAnimation();
+    // One swap : the coarse version is replaced by the whole curve
+    curve->setGeometry(
+                static_cast< QFutureWatcher<CurveGeometry>* >(watcher)->result());
+    this->registerCurve(curve);
 }
 
-void PlotScene::highlightSector(float t1, float t2, const QVariant& trackId)
+void PlotScene::populateCurves(void)
 {
-    qDebug() << "sector délimité sur mapping. Bornes : " << t1 << t2;
+    TRACE_SCOPE("scene", "PlotScene::populateCurves");
 
-    PlotCurve* targetPlotCurve = NULL;
-
-    // Find the curve associate to trackId of the point selected on the mapping
-    for(int i(0); targetPlotCurve == NULL && i < this->curves.count(); i++)
-        if (this->curves.at(i)->id() == trackId)
-            targetPlotCurve = this->curves[i];
-
-    if (targetPlotCurve == NULL)
-    {
-        qDebug() << "No PlotCurve associate to the trackId found";
-        return;
-    }
+    // A bounded number of points per event : the input is never blocked long
+    int budget = PLOT_SCENE_POINTS_PER_FRAME;
 
-    /* Get the sector that contains all the points
-     * corresponding to the time interval t1 to t2 */
-    AnimateSectorItem* sect = targetPlotCurve->sectorOn(t1, t2);
-    if (sect == NULL)
+    while (budget > 0 && !this->populatingCurves.isEmpty())
     {
-        qDebug() << "impossible de déterminer le secteur correspondant "
-                 << "à la sélection de la vue mapping";
-        return;
-    }
-
-    // The sector will have the same color that the curve
-    sect->setBrush(targetPlotCurve->getPen().brush());
+        PlotCurve* curve = this->populatingCurves.first();
+        int created = curve->populate(budget);
+        budget -= created;
 
-    /* Create the group that will contain all the GraphicsItem corresponding
-     * to the selected zone or point */
-    if (this->selectedGroup == NULL)
-    {
-        this->selectedGroup = new QGraphicsItemGroup;
-        this->addItem(this->selectedGroup);
+        if (created == 0 || curve->isPopulated())
+            this->populatingCurves.removeFirst();
     }
 
-    this->selectedGroup->addToGroup(sect);
-    sect->launchAnimation();
-}
-
-void PlotScene::highlightOnlySector(float t1, float t2, QVariant trackId)
-{
-    this->clearPlotSelection();
-    this->highlightSector(t1, t2, trackId);
+    if (this->populatingCurves.isEmpty())
+        this->populateTimer.stop();
 }
 
 void PlotScene::displayLabels(const QPointF& mousePos, const QPointF& scenePos)
@@ -390,3 +395,55 @@ void PlotScene::slotDeTest(const QPointF &scenePos)
                                      curve->id());
     }
 }
+
+void PlotScene::registerCurve(PlotCurve* curve)
+{
+    // The curve can be highlighted without creating any item
+    this->highlightItem()->addCurve(curve->id(), curve->indexValues(),
+                                    curve->pointPositions(),
+                                    curve->getPen().color());
+
+    // Its points are created a few at a time
+    if (!curve->isPopulated())
+    {
+        this->populatingCurves.append(curve);
+        this->populateTimer.start();
+    }
+}
+
+void PlotScene::cancelLoading(PlotCurve* curve)
+{
+    // The geometry still being built is dropped when its thread ends
+    QMutableHashIterator<QObject*, PlotCurve*> it(this->loadingCurves);
+
+    while (it.hasNext())
+    {
+        it.next();
+
+        if (curve == NULL || it.value() == curve)
+        {
+            it.key()->disconnect(this);
+            it.key()->deleteLater();
+            it.remove();
+        }
+    }
+
+    if (curve == NULL)
+        this->populatingCurves.clear();
+    else
+        this->populatingCurves.removeAll(curve);
+
+    if (this->populatingCurves.isEmpty())
+        this->populateTimer.stop();
+}
+
+HighlightItem* PlotScene::highlightItem(void)
+{
+    if (this->highlight == NULL)
+    {
+        this->highlight = new HighlightItem;
+        this->addItem(this->highlight);
+    }
+
+    return this->highlight;
+}
@@ -3,9 +3,13 @@
 
 #include "PlotCurve.hpp"
 #include "../Common/ColorPicker.hpp"
-#include "../Map/TickItem.hpp"
+#include "../Common/HighlightItem.hpp"
+#include "../Utils/Trace.hpp"
 #include <QtGui>
 
+// Points (CoordinateItem) created per event while a large curve is loading
+#define PLOT_SCENE_POINTS_PER_FRAME 1000
+
 class PlotScene : public QGraphicsScene
 {
     Q_OBJECT
@@ -17,7 +21,7 @@ class PlotScene : public QGraphicsScene
         void addCurve(PlotCurve* curve);
         PlotCurve* addCurve(const QList<QPointF>& points,
                             const QVariant& curveId = QVariant());
-        PlotCurve* addCurve(const QList<IndexedPosition>& points,
+        PlotCurve* addCurve(const TelemetrySeries& points,
                             const QVariant& curveId = QVariant());
         bool removeCurves(const QVariant& idTrack);
 
@@ -27,6 +31,9 @@ class PlotScene : public QGraphicsScene
         bool pointsAreVisible(void) const;
         bool curveLabelsAreVisible(void) const;
 
+        float replayDuration(void) const; // duree de la courbe la plus longue
+        bool isLoading(void) const; // some curves are not complete yet
+
     signals:
 
         void pointSelected(float absciss, const QVariant& idTrack);
@@ -44,6 +51,8 @@ class PlotScene : public QGraphicsScene
         void highlightPoints(float timeValue, const QVariant& trackId);
         void highlightSector(float t1, float t2, const QVariant& trackId);
         void highlightOnlySector(float t1, float t2, QVariant trackId);
+        void setReplayTime(float time);
+        void clearReplay(void);
         void displayLabels(const QPointF& mousePos, const QPointF& scenePos);
         void handleSelection(void);
         void lockSelectionAbility(void);
@@ -51,8 +60,17 @@ class PlotScene : public QGraphicsScene
 
         void slotDeTest(const QPointF& scenePos);
 
+    protected slots:
+
+        void publishGeometry(void);
+        void populateCurves(void);
+
     protected:
 
+        HighlightItem* highlightItem(void);
+        void registerCurve(PlotCurve* curve);
+        void cancelLoading(PlotCurve* curve = NULL); // NULL : every curve
+
         int  selectionLocked;
         bool pointsVisible;
         bool curvesVisible;
@@ -61,6 +79,12 @@ class PlotScene : public QGraphicsScene
         QList<PlotCurve*> curves;
         QList<QLabel*> curveLabels;
         QGraphicsItemGroup* selectedGroup;
+        HighlightItem* highlight; // mises en evidence de toutes les courbes
+
+        // Progressive loading of the large curves
+        QHash<QObject*, PlotCurve*> loadingCurves; // geometry watcher -> curve
+        QList<PlotCurve*> populatingCurves;
+        QTimer populateTimer;
 
         QWidget* widgetParent;
 };
@@ -1,13 +1,13 @@
 #include "PlotView.hpp"
 
 PlotView::PlotView(QWidget* parent) :
-    QGraphicsView(parent), posLabel(NULL), _numScheduledScalings(0)
+    QGraphicsView(parent), posLabel(NULL), zoomTimeLine(NULL), zoomFactor(1)
 {
     this->init();
 }
 
 PlotView::PlotView(QGraphicsScene* scene, QWidget* parent) :
-    QGraphicsView(parent), posLabel(NULL), _numScheduledScalings(0)
+    QGraphicsView(parent), posLabel(NULL), zoomTimeLine(NULL), zoomFactor(1)
 {
     this->init();
     this->setScene(scene);
@@ -24,6 +24,26 @@ void PlotView::updateSceneRect(const QRectF& rect)
     emit rectChange(globalRect());
 }
 
+void PlotView::setHorizontalRange(qreal left, qreal right)
+{
+    if (right <= left)
+        return;
+
+    // The vertical extent currently displayed is kept
+    QRectF visible = this->globalRect();
+    if (visible.height() <= 0)
+        visible = this->sceneRect();
+
+    /* Range already displayed: no refit, no repaint. The bounds are often
+     * 0, where qFuzzyCompare never reports equal */
+    if (qAbs(visible.left() - left) < PLOT_VIEW_RANGE_EPSILON &&
+        qAbs(visible.right() - right) < PLOT_VIEW_RANGE_EPSILON)
+        return;
+
+    this->updateSceneRect(QRectF(left, visible.top(),
+                                 right - left, visible.height()));
+}
+
 void PlotView::selectionChanged(void)
 {
     if (!delimiting)
@@ -67,25 +87,21 @@ void PlotView::restoreSceneRect(void)
 
 void PlotView::scalingTime(qreal x)
 {
-    Q_UNUSED(x);
+    /* Only the view transform changes during the animation: no new scene
+     * rect, no rectChange (scales and linked views wait for the end) */
+    qreal factor = qPow(this->zoomFactor, x);
 
-    qreal factor = 1.0 + qreal(this->_numScheduledScalings) / 300.0;
-    scale(factor, factor);
-
-    QRectF newScene = this->viewport()->childrenRect();
-    setSceneRect(newScene);
-    emit rectChange(globalRect());
+    QTransform transform(this->zoomStart);
+    transform.scale(factor, factor);
+    this->setTransform(transform);
 }
 
 void PlotView::animFinished(void)
 {
-    if (_numScheduledScalings > 0)
-        _numScheduledScalings--;
-    else
-        _numScheduledScalings++;
+    this->zoomFactor = 1;
 
-    // Of course, we need to take care of dynamically created QTimeLines
-    sender()->~QObject();
+    // The visible area becomes the scene rect, scales are updated once
+    this->updateSceneRect(this->globalRect());
 }
 
 void PlotView::drawForeground(QPainter *painter, const QRectF &rect)
@@ -224,20 +240,9 @@ void PlotView::wheelEvent(QWheelEvent* event)
     {
         int numDegrees = event->delta() / 8;
         int numSteps = numDegrees / 15;  // see QWheelEvent documentation
-        this->_numScheduledScalings += numSteps;
-
-        // if user moved the wheel in another direction,
-        // we reset previously scheduled scalings
-        if (this->_numScheduledScalings * numSteps < 0)
-                this->_numScheduledScalings = numSteps;
-
-        // Will invoke scalingTime function every 20ms during his 350ms lifespan
-        QTimeLine* anim = new QTimeLine(350, this);
-        anim->setUpdateInterval(20);
 
-        connect(anim, SIGNAL(valueChanged(qreal)), SLOT(scalingTime(qreal)));
-        connect(anim, SIGNAL(finished()), SLOT(animFinished()));
-        anim->start();
+        if (numSteps != 0)
+            this->scheduleZoom(numSteps);
     }
 }
 
@@ -266,6 +271,39 @@ void PlotView::zoom(qreal factor, const QPointF& centerPoint)
     centerOn(centerPoint);
 }
 
+void PlotView::scheduleZoom(int numSteps)
+{
+    qreal factor = qPow(PLOT_VIEW_ZOOM_STEP, numSteps);
+
+    if (this->zoomTimeLine->state() == QTimeLine::Running)
+    {
+        this->zoomTimeLine->stop();
+
+        // Same direction: the remaining part of the zoom is kept,
+        // otherwise the previously scheduled zoom is dropped
+        if ((this->zoomFactor > 1) == (factor > 1))
+            factor *= qPow(this->zoomFactor,
+                           1 - this->zoomTimeLine->currentValue());
+    }
+
+    /* The scene rect is set once per wheel step, not at every frame: large
+     * enough to zoom out around the center of the view */
+    QRectF visible = this->globalRect();
+    QPointF center = visible.center();
+
+    visible.setSize(visible.size() * qMax(qreal(1), 1 / factor));
+    visible.moveCenter(center);
+    this->setSceneRect(visible);
+    this->centerOn(center);
+
+    this->zoomStart = this->transform();
+    this->zoomFactor = factor;
+
+    // Will invoke scalingTime at every frame during the animation
+    this->zoomTimeLine->setCurrentTime(0);
+    this->zoomTimeLine->start();
+}
+
 void PlotView::init(void)
 {
     this->delimiting = false;
@@ -289,6 +327,15 @@ void PlotView::init(void)
     setDragMode(QGraphicsView::RubberBandDrag);
     this->oldDragMode = this->dragMode();
 
+    // One time line for every wheel zoom, owned by the view
+    this->zoomTimeLine = new QTimeLine(PLOT_VIEW_ZOOM_DURATION, this);
+    this->zoomTimeLine->setUpdateInterval(PLOT_VIEW_ZOOM_INTERVAL);
+    this->zoomTimeLine->setCurveShape(QTimeLine::EaseOutCurve);
+    connect(this->zoomTimeLine, SIGNAL(valueChanged(qreal)),
+            this, SLOT(scalingTime(qreal)));
+    connect(this->zoomTimeLine, SIGNAL(finished()),
+            this, SLOT(animFinished()));
+
     posLabel = new QLabel("(0, 0)", this);
     posLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
     posLabel->setStyleSheet("background-color : qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 rgb(100, 100, 100, 180), stop: 1 rgb(0, 0, 0, 180)); margin : 4px; color: white; border-radius: 2px");
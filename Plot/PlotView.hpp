@@ -3,6 +3,13 @@
 
 #include <QtGui>
 
+// Wheel zoom animation: duration (ms), frame interval (ms), factor per notch
+#define PLOT_VIEW_ZOOM_DURATION 350
+#define PLOT_VIEW_ZOOM_INTERVAL 16
+#define PLOT_VIEW_ZOOM_STEP     1.15
+// Range bounds closer than this (abscissa unit: s or m) are the same
+#define PLOT_VIEW_RANGE_EPSILON 1e-4
+
 class PlotView : public QGraphicsView
 {
     Q_OBJECT
@@ -25,6 +32,7 @@ class PlotView : public QGraphicsView
     public slots:
 
        void updateSceneRect(const QRectF &rect);
+       void setHorizontalRange(qreal left, qreal right);
        void selectionChanged(void);
        void zoomOut(void);
        void setVerticalLineVisible(bool visible);
@@ -48,6 +56,7 @@ class PlotView : public QGraphicsView
        virtual void keyReleaseEvent(QKeyEvent* event);
 
        void zoom(qreal factor, const QPointF& centerPoint);
+       void scheduleZoom(int numSteps);
 
        void init(void);
        QRectF globalRect(void) const;
@@ -59,7 +68,11 @@ class PlotView : public QGraphicsView
        QStack<QRectF> sceneStack;
        QLabel* posLabel;
 
-       int _numScheduledScalings;
+       /* Animated zoom: one time line interpolates the view transform from
+        * zoomStart to zoomStart scaled by zoomFactor */
+       QTimeLine* zoomTimeLine;
+       QTransform zoomStart;
+       qreal zoomFactor;
        DragMode oldDragMode;
 };
 
@@ -3,7 +3,7 @@
 Scale::Scale(QWidget *parent) :
     QWidget(parent), mmin(0), mmax(100), initResolution(10),
     numTicks(2), precision(2), indexHorizontal(true), minToDisplay(0),
-    translation(0), scaleFactor(1)
+    translation(0), scaleFactor(1), ticksValid(false)
 {
     /*
      * customContextMenuRequested
@@ -48,14 +48,25 @@ void Scale::scale(float fact)
 
 void Scale::setMin(float min)
 {
-    this->mmin = (min + this->translation) * this->scaleFactor;
-    this->adjust();
+    float value = (min + this->translation) * this->scaleFactor;
+
+    // Graduations inchangees : rien a recalculer ni a redessiner
+    if (value == this->mmin)
+        return;
+
+    this->mmin = value;
+    this->invalidate();
 }
 
 void Scale::setMax(float max)
 {
-    this->mmax = (max + this->translation) * this->scaleFactor;
-    this->adjust();
+    float value = (max + this->translation) * this->scaleFactor;
+
+    if (value == this->mmax)
+        return;
+
+    this->mmax = value;
+    this->invalidate();
 }
 
 void Scale::setResolution(float resolution)
@@ -64,7 +75,7 @@ void Scale::setResolution(float resolution)
         return;
 
     this->initResolution = resolution;
-    this->adjust();
+    this->invalidate();
 }
 
 void Scale::setPrecision(int precision)
@@ -100,8 +111,17 @@ void Scale::showContextMenu(QPoint pos)
     this->update();
 }
 
+void Scale::invalidate(void)
+{
+    this->ticksValid = false;
+    this->update();
+}
+
 void Scale::adjust(void)
 {
+    if (this->ticksValid)
+        return;
+
     int nNum = qRound((mmax - mmin) / initResolution);
     /*Maybe work on a ratio between place and resolution to exploit in a better way space to display optimal number of ticks */
 
@@ -130,7 +150,7 @@ void Scale::adjust(void)
     minToDisplay = tmp * resolution;
     numTicks = nNum;
 
-    this->update();
+    this->ticksValid = true;
 }
 
 void Scale::displayAutoScaledText(QPainter* painter, const QRectF& zone,
@@ -40,7 +40,8 @@ class Scale : public QWidget
 
         virtual void paintEvent(QPaintEvent *) = 0;
 
-        void adjust(void);
+        void adjust(void);     // recalcule les graduations si l'etendue a change
+        void invalidate(void); // graduations recalculees au prochain dessin
         void displayAutoScaledText(QPainter*, const QRectF&, int flags, QString txt);
 
         float mmin;
@@ -56,6 +57,7 @@ class Scale : public QWidget
         Placement mPlacement;
         float translation;
         float scaleFactor;
+        bool ticksValid;
 };
 
 #endif /* __SCALE_HPP__ */
@@ -24,6 +24,9 @@ void VerticalScale::cursorAt(QPoint pos)
 
 void VerticalScale::paintEvent(QPaintEvent *)
 {
+    // Graduations recalculees seulement si l'etendue a change
+    this->adjust();
+
     QPainter painter(this);
     int len = height();
     int w = width();
@@ -0,0 +1,159 @@
+#include "SectorTimesDialog.hpp"
+#include "ui_SectorTimesDialog.h"
+#include <float.h>
+
+SectorTimesDialog::SectorTimesDialog(const SectorStatistics& statistics,
+                                     QWidget *parent) :
+    QDialog(parent), ui(new Ui::SectorTimesDialog)
+{
+    // GUI Configuration
+    ui->setupUi(this);
+
+    // Building Models
+    this->createTableModel(statistics.timing());
+    this->createStatisticsModel(statistics);
+
+    QString bestLap = qIsNaN(statistics.bestLap()) ?
+                tr("-") : QString::number(statistics.bestLap(), 'f', 3);
+    QString theoretical = qIsNaN(statistics.theoreticalBestLap()) ?
+                tr("-") : QString::number(statistics.theoreticalBestLap(), 'f', 3);
+
+    this->ui->bestLapLabel->setText(
+                tr("Meilleur tour : %1 s    Tour théorique (meilleurs secteurs) : %2 s")
+                .arg(bestLap, theoretical));
+
+    this->setWindowTitle(tr("Temps par secteur - ") + statistics.competition());
+}
+
+SectorTimesDialog::~SectorTimesDialog(void)
+{
+    delete this->ui;
+}
+
+void SectorTimesDialog::createTableModel(const SectorTiming& timing)
+{
+    int sectorCount = timing.sectorCount();
+
+    QStringList headers;
+    headers << tr("Course") << tr("Tour");
+    for (int s(0); s < sectorCount; ++s)
+        headers << tr("Secteur %1 (s)").arg(s + 1);
+    headers << tr("Total (s)");
+
+    this->sectorTimesModel = new QStandardItemModel(0, headers.count(), this);
+    this->sectorTimesModel->setHorizontalHeaderLabels(headers);
+
+    // Meilleur temps de chaque secteur et meilleur tour complet
+    QVector<qreal> bestSectors = timing.bestSectors();
+    qreal bestTotal = qQNaN();
+
+    foreach (const LapSectorTimes& lap, timing.laps())
+        if (!qIsNaN(lap.total()) && (qIsNaN(bestTotal) || lap.total() < bestTotal))
+            bestTotal = lap.total();
+
+    foreach (const LapSectorTimes& lap, timing.laps())
+    {
+        QList<QStandardItem*> row;
+
+        QStandardItem* raceItem = new QStandardItem(QString::number(lap.raceNum));
+        raceItem->setData(lap.raceNum, Qt::UserRole);
+        QStandardItem* lapItem = new QStandardItem(QString::number(lap.lap));
+        lapItem->setData(lap.lap, Qt::UserRole);
+        row << raceItem << lapItem;
+
+        for (int s(0); s < sectorCount; ++s)
+            row << this->timeItem(lap.sectors.value(s, qQNaN()),
+                                  bestSectors.at(s));
+
+        row << this->timeItem(lap.total(), bestTotal);
+
+        this->sectorTimesModel->appendRow(row);
+    }
+
+    // Tri numerique sur les valeurs, pas sur le texte affiche
+    QSortFilterProxyModel* sortModel = new QSortFilterProxyModel(this);
+    sortModel->setSourceModel(this->sectorTimesModel);
+    sortModel->setSortRole(Qt::UserRole);
+
+    this->ui->sectorTimesTableView->setModel(sortModel);
+    this->ui->sectorTimesTableView->verticalHeader()->setVisible(false);
+    this->ui->sectorTimesTableView->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
+    this->ui->sectorTimesTableView->sortByColumn(0, Qt::AscendingOrder);
+}
+
+void SectorTimesDialog::createStatisticsModel(const SectorStatistics& statistics)
+{
+    QStringList headers;
+    headers << tr("Secteur") << tr("Mesure") << tr("Tours") << tr("Moyenne")
+            << tr("Écart type") << tr("Min") << tr("P10") << tr("Médiane")
+            << tr("P90") << tr("Max");
+
+    this->statisticsModel = new QStandardItemModel(0, headers.count(), this);
+    this->statisticsModel->setHorizontalHeaderLabels(headers);
+
+    QStringList metrics;
+    metrics << tr("Temps (s)") << tr("Vitesse min (km/h)")
+            << tr("Vitesse max (km/h)") << tr("Énergie de traction (J/kg)")
+            << tr("Énergie de freinage (J/kg)");
+
+    // Une ligne par secteur et par mesure, puis le tour complet
+    for (int s(0); s <= statistics.sectorCount(); ++s)
+    {
+        QString sector = (s < statistics.sectorCount()) ?
+                    tr("Secteur %1").arg(s + 1) : tr("Tour");
+
+        for (int m(0); m < SectorStatistics::MetricCount; ++m)
+        {
+            Distribution d = statistics.distribution(
+                        s, (SectorStatistics::Metric) m);
+
+            QList<QStandardItem*> row;
+            row << new QStandardItem(sector) << new QStandardItem(metrics.at(m))
+                << new QStandardItem(QString::number(d.count));
+
+            QList<qreal> values;
+            values << d.mean << d.stdDev << d.minimum << d.p10 << d.median
+                   << d.p90 << d.maximum;
+
+            foreach (qreal value, values)
+            {
+                QStandardItem* item = new QStandardItem(
+                            qIsNaN(value) ? QString() : QString::number(value, 'f', 2));
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+                row << item;
+            }
+
+            this->statisticsModel->appendRow(row);
+        }
+    }
+
+    this->ui->statisticsTableView->setModel(this->statisticsModel);
+    this->ui->statisticsTableView->verticalHeader()->setVisible(false);
+    this->ui->statisticsTableView->horizontalHeader()->setResizeMode(QHeaderView::ResizeToContents);
+}
+
+QStandardItem* SectorTimesDialog::timeItem(qreal seconds, qreal best) const
+{
+    QStandardItem* item = new QStandardItem;
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+    // Secteur non chronometre : affiche vide et trie en dernier
+    if (qIsNaN(seconds))
+    {
+        item->setData(DBL_MAX, Qt::UserRole);
+        return item;
+    }
+
+    item->setText(QString::number(seconds, 'f', 3));
+    item->setData(seconds, Qt::UserRole);
+
+    if (seconds == best)
+    {
+        QFont font = item->font();
+        font.setBold(true);
+        item->setFont(font);
+        item->setBackground(QColor(170, 230, 170));
+    }
+
+    return item;
+}
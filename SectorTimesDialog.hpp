@@ -0,0 +1,37 @@
+#ifndef __SECTORTIMESDIALOG_HPP__
+#define __SECTORTIMESDIALOG_HPP__
+
+#include "DBModule/SectorStatistics.hpp"
+#include <QtGui>
+
+namespace Ui {
+class SectorTimesDialog;
+}
+
+class SectorTimesDialog : public QDialog
+{
+    Q_OBJECT
+
+    public:
+
+        explicit SectorTimesDialog(const SectorStatistics& statistics,
+                                   QWidget *parent = 0);
+        ~SectorTimesDialog(void);
+
+    private:
+
+        void createTableModel(const SectorTiming& timing);
+        void createStatisticsModel(const SectorStatistics& statistics);
+        QStandardItem* timeItem(qreal seconds, qreal best) const;
+
+    protected:
+
+        // GUI
+        Ui::SectorTimesDialog *ui;
+
+        // Model
+        QStandardItemModel* sectorTimesModel;
+        QStandardItemModel* statisticsModel;
+};
+
+#endif /* __SECTORTIMESDIALOG_HPP__ */
@@ -1,4 +1,5 @@
 #include "DataBaseManager.hpp"
+#include "../DBModule/ChannelStore.hpp"
 
 bool DataBaseManager::restorePreviousDataBase(void)
 {
@@ -100,6 +101,130 @@ bool DataBaseManager::openDataBase(const QString& dataBaseFilePath)
     db.exec("PRAGMA journal_mode = MEMORY");
     db.exec("PRAGMA synchronous  = OFF");
 
+    return DataBaseManager::upgradeDataBase(db);
+}
+
+bool DataBaseManager::upgradeDataBase(QSqlDatabase& db)
+{
+    /* Tables ajoutees apres la premiere version du schema : creees a
+     * l'ouverture si besoin, pour les nouveaux projets comme pour les anciens
+     *
+     * CHANNEL     : registre des canaux (unite, frequence, encodage)
+     * LAP_CHANNEL : une ligne par canal et par tour (log MegaSquirt,
+     *               accelerometre, ...), timestamps (ms depuis le debut du
+     *               tour, int32) et valeurs en BLOB little-endian, voir
+     *               DBModule/ChannelStore.hpp */
+    QStringList statements;
+    statements << "create table if not exists CHANNEL ( name VARCHAR(40) PRIMARY KEY, unit VARCHAR(20), rate REAL DEFAULT 0, encoding VARCHAR(10) DEFAULT 'f32le')"
+               << "create table if not exists LAP_CHANNEL ( name VARCHAR(40), unit VARCHAR(20), sample_count INTEGER, timestamps BLOB, samples BLOB, ref_lap_num INTEGER, ref_lap_race INTEGER, FOREIGN KEY (ref_lap_num, ref_lap_race) REFERENCES LAP(num, ref_race) ON DELETE CASCADE, PRIMARY KEY (ref_lap_race, ref_lap_num, name))"
+               // Canaux importes avant l'existence du registre
+               << "insert or ignore into CHANNEL (name, unit) select name, max(unit) from LAP_CHANNEL group by name";
+
+    foreach (const QString& statement, statements)
+    {
+        db.exec(statement);
+
+        if (db.lastError().isValid())
+        {
+            qWarning() << db.lastError().text();
+            return false;
+        }
+    }
+
+    return DataBaseManager::migrateAccelerations(db);
+}
+
+bool DataBaseManager::migrateAccelerations(QSqlDatabase& db)
+{
+    /* Anciennes bases : les accelerations etaient dans la table ACCELERATION
+     * (timestamp en ms depuis le debut du tour). Elles sont recopiees dans
+     * les canaux g_long et g_lat, comme a l'import, puis la table est
+     * supprimee. Une migration interrompue reprend a l'ouverture suivante. */
+    if (!db.tables().contains("ACCELERATION", Qt::CaseInsensitive))
+        return true;
+
+    TRACE_SCOPE("sql", "DataBaseManager::migrateAccelerations");
+
+    // Tours deja reimportes : leurs canaux sont plus recents que la table
+    QSet<QPair<int, int> > migrated;
+    QSqlQuery channelQuery("select ref_lap_race, ref_lap_num from LAP_CHANNEL where name = 'g_long'", db);
+
+    while (channelQuery.next())
+        migrated.insert(qMakePair(channelQuery.value(0).toInt(),
+                                  channelQuery.value(1).toInt()));
+
+    QSqlQuery accQuery(db);
+    accQuery.setForwardOnly(true);
+
+    if (!accQuery.exec("select ref_lap_race, ref_lap_num, timestamp, g_long, g_lat from ACCELERATION "
+                       "order by ref_lap_race, ref_lap_num, timestamp"))
+    {
+        qWarning() << accQuery.lastQuery() << accQuery.lastError().text();
+        return false;
+    }
+
+    QList<ChannelInfo> infos;
+    infos << ChannelInfo("g_long", "g") << ChannelInfo("g_lat", "g");
+
+    // Un ChannelStore par course : chaque tour est ecrit en une transaction
+    ChannelStore* store = NULL;
+    int currentRace(-1);
+    bool succeeded(true);
+
+    while (accQuery.next())
+    {
+        int race = accQuery.value(0).toInt();
+        int lap = accQuery.value(1).toInt();
+
+        if (migrated.contains(qMakePair(race, lap)))
+            continue;
+
+        if (store == NULL || race != currentRace)
+        {
+            if (store != NULL && !store->finish())
+            {
+                succeeded = false;
+                break;
+            }
+
+            delete store;
+            store = new ChannelStore(race, infos);
+            currentRace = race;
+        }
+
+        if (!store->setLap(lap))
+        {
+            succeeded = false;
+            break;
+        }
+
+        qint32 msecs = accQuery.value(2).toInt();
+        store->channel(0).append(msecs, accQuery.value(3).toFloat());
+        store->channel(1).append(msecs, accQuery.value(4).toFloat());
+    }
+
+    if (store != NULL)
+    {
+        if (succeeded && !store->finish())
+            succeeded = false;
+
+        if (!succeeded)
+            qWarning() << store->errorString();
+
+        delete store;
+    }
+
+    if (!succeeded)
+        return false;
+
+    db.exec("drop table ACCELERATION");
+
+    if (db.lastError().isValid())
+    {
+        qWarning() << db.lastError().text();
+        return false;
+    }
+
     return true;
 }
 
@@ -119,7 +244,7 @@ bool DataBaseManager::installDataBase(QString const& dataBaseFilePath)
     db.exec("create table RACE ( id INTEGER PRIMARY KEY AUTOINCREMENT, num INTEGER, date DATETIME, ref_compet VARCHAR(80), FOREIGN KEY (ref_compet) REFERENCES COMPETITION(name) ON DELETE CASCADE)");
     db.exec("create table LAP ( num INTEGER, start_time TIME, end_time TIME, distance FLOAT, ref_race INTEGER, FOREIGN KEY (ref_race) REFERENCES RACE(id) ON DELETE CASCADE, PRIMARY KEY (num, ref_race))");
     db.exec("create table SPEED ( id INTEGER PRIMARY KEY AUTOINCREMENT, timestamp TIME, value FLOAT, ref_lap_num INTEGER, ref_lap_race  INTEGER, FOREIGN KEY (ref_lap_num, ref_lap_race) REFERENCES LAP(num, ref_race) ON DELETE CASCADE)");
-    db.exec("create table ACCELERATION ( id INTEGER PRIMARY KEY AUTOINCREMENT, timestamp TIME, g_long FLOAT, g_lat FLOAT, ref_lap_num INTEGER, ref_lap_race  INTEGER, FOREIGN KEY (ref_lap_num, ref_lap_race) REFERENCES LAP(num, ref_race) ON DELETE CASCADE)");
+    // Les autres capteurs (accelerations, MegaSquirt) vont dans LAP_CHANNEL
     db.exec("create table POSITION ( id INTEGER PRIMARY KEY AUTOINCREMENT, timestamp TIME, latitude FLOAT, longitude FLOAT, altitude FLOAT, eval_speed FLOAT, ref_lap_num INTEGER, ref_lap_race  INTEGER, FOREIGN KEY (ref_lap_num, ref_lap_race) REFERENCES LAP(num, ref_race) ON DELETE CASCADE)");
 
     return db.driver()->commitTransaction();
@@ -25,6 +25,8 @@ class DataBaseManager
 
         static bool openDataBase(QString const& dataBaseFilePath);
         static bool installDataBase(QString const& dataBaseFilePath);
+        static bool upgradeDataBase(QSqlDatabase& db);
+        static bool migrateAccelerations(QSqlDatabase& db);
 };
 
 #endif /* __DATABASEMANAGER_HPP__ */
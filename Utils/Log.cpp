@@ -0,0 +1,92 @@
+#include "Log.hpp"
+
+QMutex LogCategory::registryMutex;
+QList<LogCategory*> LogCategory::registry;
+QString LogCategory::filterRules;
+
+LOG_CATEGORY(logGps, "gps")
+LOG_CATEGORY(logImport, "import")
+LOG_CATEGORY(logLapDetector, "lapdetector")
+
+LogCategory::LogCategory(const char* name) :
+    _name(name), _debug(false), _warning(true), _critical(true)
+{
+    QMutexLocker locker(&LogCategory::registryMutex);
+
+    LogCategory::registry.append(this);
+    this->applyRules(LogCategory::filterRules);
+}
+
+LogCategory::~LogCategory(void)
+{
+    QMutexLocker locker(&LogCategory::registryMutex);
+
+    LogCategory::registry.removeOne(this);
+}
+
+const char* LogCategory::name(void) const
+{
+    return this->_name;
+}
+
+void LogCategory::setEnabled(QtMsgType type, bool enabled)
+{
+    switch (type)
+    {
+        case QtDebugMsg:
+            this->_debug = enabled;
+            break;
+        case QtWarningMsg:
+            this->_warning = enabled;
+            break;
+        case QtCriticalMsg:
+            this->_critical = enabled;
+            break;
+        default:
+            break;
+    }
+}
+
+void LogCategory::setFilterRules(const QString& rules)
+{
+    QMutexLocker locker(&LogCategory::registryMutex);
+
+    // Conservees pour les categories creees plus tard
+    LogCategory::filterRules = rules;
+
+    foreach (LogCategory* category, LogCategory::registry)
+        category->applyRules(rules);
+}
+
+void LogCategory::applyRules(const QString& rules)
+{
+    QStringList lines = rules.split(QRegExp("[;\\n]"), QString::SkipEmptyParts);
+
+    // Les regles sont appliquees dans l'ordre : la derniere l'emporte
+    foreach (const QString& line, lines)
+    {
+        QString key = line.section('=', 0, 0).trimmed();
+        QString value = line.section('=', 1, 1).trimmed().toLower();
+
+        QString category = key.section('.', 0, 0);
+        QString level = key.section('.', 1, 1);
+
+        if (category != "*" && category != QLatin1String(this->_name))
+            continue;
+
+        if (value != "true" && value != "false")
+        {
+            qWarning() << "Regle de journalisation invalide :" << line;
+            continue;
+        }
+
+        bool enabled = (value == "true");
+
+        if (level.isEmpty() || level == "*" || level == "debug")
+            this->setEnabled(QtDebugMsg, enabled);
+        if (level.isEmpty() || level == "*" || level == "warning")
+            this->setEnabled(QtWarningMsg, enabled);
+        if (level.isEmpty() || level == "*" || level == "critical")
+            this->setEnabled(QtCriticalMsg, enabled);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef __LOG_HPP__
+#define __LOG_HPP__
+
+#include <QtCore>
+
+/* Journalisation par categorie (sous-systeme).
+ *
+ *     LOG_DEBUG(logGps) << "rmc status :" << status;
+ *
+ * Les messages de debug sont desactives par defaut et s'activent a
+ * l'execution, categorie par categorie, via LogCategory::setFilterRules()
+ * (variable d'environnement ECOMANAGER_LOG, ex. "gps.debug=true;import.*=true").
+ *
+ * ECO_LOG_LEVEL fixe le niveau minimal compile (0 : debug, 1 : warning,
+ * 2 : critical). En release (QT_NO_DEBUG) les LOG_DEBUG sont elimines par le
+ * compilateur : ni formatage ni test a l'execution dans les boucles critiques.
+ */
+
+#ifndef ECO_LOG_LEVEL
+    #ifdef QT_NO_DEBUG
+        #define ECO_LOG_LEVEL 1
+    #else
+        #define ECO_LOG_LEVEL 0
+    #endif
+#endif
+
+class LogCategory
+{
+    public:
+
+        explicit LogCategory(const char* name);
+        ~LogCategory(void);
+
+        const char* name(void) const;
+
+        bool isDebugEnabled(void) const { return this->_debug; }
+        bool isWarningEnabled(void) const { return this->_warning; }
+        bool isCriticalEnabled(void) const { return this->_critical; }
+        void setEnabled(QtMsgType type, bool enabled);
+
+        /* Regles "categorie.niveau=true|false" separees par ';' ou des
+         * retours a la ligne. "*" designe toutes les categories ou niveaux */
+        static void setFilterRules(const QString& rules);
+
+    private:
+
+        Q_DISABLE_COPY(LogCategory)
+
+        void applyRules(const QString& rules);
+
+        static QMutex registryMutex;
+        static QList<LogCategory*> registry;
+        static QString filterRules;
+
+        const char* _name;
+        bool _debug;
+        bool _warning;
+        bool _critical;
+};
+
+#define LOG_DECLARE_CATEGORY(function) LogCategory& function(void);
+#define LOG_CATEGORY(function, name) \
+    LogCategory& function(void) \
+    { \
+        static LogCategory category(name); \
+        return category; \
+    }
+
+#define LOG_DEBUG(category) \
+    if (ECO_LOG_LEVEL > 0 || !category().isDebugEnabled()) {} \
+    else (qDebug().nospace() << category().name() << ":").space()
+
+#define LOG_WARNING(category) \
+    if (ECO_LOG_LEVEL > 1 || !category().isWarningEnabled()) {} \
+    else (qWarning().nospace() << category().name() << ":").space()
+
+#define LOG_CRITICAL(category) \
+    if (!category().isCriticalEnabled()) {} \
+    else (qCritical().nospace() << category().name() << ":").space()
+
+// Categories de l'application
+LOG_DECLARE_CATEGORY(logGps)
+LOG_DECLARE_CATEGORY(logImport)
+LOG_DECLARE_CATEGORY(logLapDetector)
+
+#endif /* __LOG_HPP__ */
@@ -2,7 +2,8 @@
 
 QCSVParser::QCSVParser(const QString &filename, const QChar &separator,
                        QString::SplitBehavior behavior) :
-    _fileName(filename), _separator(separator), _behavior(behavior)
+    _fileName(filename), _separator(separator), _behavior(behavior),
+    _columnIndex(-1)
 {
     // Parse the file
     this->parse(filename, separator, behavior);
@@ -10,7 +11,8 @@ QCSVParser::QCSVParser(const QString &filename, const QChar &separator,
 
 QCSVParser::QCSVParser(QFile &file, const QChar &separator,
                        QString::SplitBehavior behavior) :
-    _fileName(file.fileName()), _separator(separator), _behavior(behavior)
+    _fileName(file.fileName()), _separator(separator), _behavior(behavior),
+    _columnIndex(-1)
 {
     // Parse the file
     if (file.exists())
@@ -51,6 +53,7 @@ void QCSVParser::parse(QFile &file, const QChar &separator,
     this->_separator = separator;
     this->_behavior  = behavior;
     this->_content.clear();
+    this->invalidateCache();
 
     // Read file line by line
     QString line;
@@ -72,7 +75,7 @@ void QCSVParser::save(void) const
 
     // Write all the line
     QTextStream out(&file);
-    foreach (QCSVRow row, this->_content)
+    foreach (const QCSVRow& row, this->_content)
         this->writeRow(out, row);
 
     file.close();
@@ -103,19 +106,27 @@ QCSVRow& QCSVParser::row(int index)
     if (index >= this->rowCount())
         throw QException(QObject::tr("Indice trop grand"));
 
+    // La ligne peut etre modifiee au travers de la reference
+    this->invalidateCache();
+
     return this->_content[index];
 }
 
-QCSVColumn& QCSVParser::column(int index)
+const QCSVColumn& QCSVParser::column(int index)
 {
     if (index >= this->columnCount())
         throw QException(QObject::tr("Indice trop grand"));
 
+    if (index == this->_columnIndex)
+        return this->_column;
+
     this->_column.clear();
+    this->_column.reserve(this->rowCount());
 
     for (int i(1); i < this->rowCount(); ++i) // skeep the header
-        this->_column.push_back(this->_content[i][index]);
+        this->_column.push_back(this->_content.at(i).value(index));
 
+    this->_columnIndex = index;
     return this->_column;
 
     /*
@@ -143,11 +154,13 @@ void QCSVParser::addRow(const QCSVRow& row)
 
     // Add row the the csv content
     this->_content.push_back(row);
+    this->invalidateCache();
 }
 
 void QCSVParser::eraseRow(int rowindex)
 {
     this->_content.remove(rowindex);
+    this->invalidateCache();
 
     //this->save();
 }
@@ -160,7 +173,7 @@ void QCSVParser::reset(void)
 
     // Clear the DB
     this->_content.clear();
-    this->_column.clear();
+    this->invalidateCache();
 }
 
 QString QCSVParser::fileName(void) const
@@ -188,24 +201,41 @@ QString QCSVParser::columnName(int column) const
 
 int QCSVParser::columnIndice(const QString& columnName) const
 {
-    QCSVRow header = this->header();
-    for (int i(0); i < header.count(); ++i)
-        if (header.at(i) == columnName)
-            return i;
+    if (this->_headerIndex.isEmpty())
+    {
+        QCSVRow header = this->header();
+
+        // En cas de doublon, la premiere colonne l'emporte
+        for (int i(header.count() - 1); i >= 0; --i)
+            this->_headerIndex.insert(header.at(i), i);
+    }
 
-    throw QException(QObject::tr("Column not found"));
+    QHash<QString, int>::const_iterator it =
+            this->_headerIndex.constFind(columnName);
+
+    if (it == this->_headerIndex.constEnd())
+        throw QException(QObject::tr("Column not found"));
+
+    return it.value();
 }
 
-QCSVColumn& QCSVParser::operator [](QString const& columName)
+const QCSVColumn& QCSVParser::operator [](QString const& columName)
 {
     return this->column(this->columnIndice(columName));
 }
 
-QCSVColumn& QCSVParser::operator [](int column)
+const QCSVColumn& QCSVParser::operator [](int column)
 {
     return this->column(column);
 }
 
+void QCSVParser::invalidateCache(void)
+{
+    this->_column.clear();
+    this->_columnIndex = -1;
+    this->_headerIndex.clear();
+}
+
 void QCSVParser::writeRow(QTextStream& out, const QCSVRow& row) const
 {
     for (int i(0); i < row.count() - 1; ++i)
@@ -17,6 +17,8 @@ typedef QVector<QString> QCSVRow;
 typedef QVector<QString> QCSVColumn;
 typedef QVector<QCSVRow> QCSVDataBase;
 
+/* Lecture/ecriture d'un petit fichier csv editable en memoire. Pour lire de
+ * gros fichiers d'acquisition, voir QCSVTable (QCSVTable.hpp) */
 class QCSVParser
 {
     public:
@@ -42,7 +44,7 @@ class QCSVParser
         QCSVRow     header(void) const;
         QStringList headersList(void) const;
         QCSVRow&    row(int index);
-        QCSVColumn& column(int index);
+        const QCSVColumn& column(int index);
         void        addRow(QCSVRow const& row);
         void        eraseRow(int rowindex);
         void        reset(void);
@@ -56,19 +58,27 @@ class QCSVParser
         int columnIndice(const QString& columnName) const;
 
         // Operators overload
-        QCSVColumn& operator[](QString const& columnName);
-        QCSVColumn& operator[](int column);
+        const QCSVColumn& operator[](QString const& columnName);
+        const QCSVColumn& operator[](int column);
 
     protected:
 
         void writeRow(QTextStream& out, QCSVRow const& row) const;
+        void invalidateCache(void);
 
         QString _fileName;
         QChar   _separator;
         QString::SplitBehavior _behavior;
 
         QCSVDataBase _content;
+
+        /* column() renvoie une reference constante sur un cache : la
+         * derniere colonne extraite et l'index des en-tetes sont conserves
+         * jusqu'a la prochaine modification du contenu. Les cellules se
+         * modifient par row() */
         QCSVColumn   _column;
+        int          _columnIndex;
+        mutable QHash<QString, int> _headerIndex;
 };
 
 #endif /* __QCSVPARSER_HPP__ */
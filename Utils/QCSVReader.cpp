@@ -0,0 +1,113 @@
+#include "QCSVReader.hpp"
+
+QCSVReader::QCSVReader(QIODevice* device, char separator, bool hasHeader,
+                       int batchSize) :
+    _device(device), _separator(separator), _hasHeader(hasHeader),
+    _headerRead(false), _batchSize(qMax(1, batchSize)), _rowsRead(0),
+    _layout(separator), _scanPos(0), _scannedRecords(0), _inQuotes(false)
+{
+    if (this->_device == NULL)
+        throw QException(QObject::tr("Aucun fichier csv a lire"));
+
+    if (!this->_device->isOpen() && !this->_device->open(QIODevice::ReadOnly))
+        throw QException(QObject::tr("Impossible d'ouvrir le fichier ") +
+                         this->_device->errorString());
+}
+
+bool QCSVReader::readNext(QCSVTable& batch)
+{
+    if (!this->readHeader())
+        return false;
+
+    QByteArray chunk;
+    if (!this->nextChunk(this->_batchSize, chunk))
+        return false;
+
+    batch.parseRows(chunk, this->_layout);
+    this->_rowsRead += batch.rowCount();
+
+    return true;
+}
+
+bool QCSVReader::atEnd(void) const
+{
+    return this->_pending.isEmpty() && this->_device->atEnd();
+}
+
+QList<QByteArray> QCSVReader::header(void)
+{
+    this->readHeader();
+    return this->_layout.header();
+}
+
+int QCSVReader::batchSize(void) const
+{
+    return this->_batchSize;
+}
+
+qint64 QCSVReader::rowsRead(void) const
+{
+    return this->_rowsRead;
+}
+
+bool QCSVReader::readHeader(void)
+{
+    if (this->_headerRead || !this->_hasHeader)
+        return true;
+
+    this->_headerRead = true;
+
+    QByteArray line;
+    if (!this->nextChunk(1, line))
+        return false;
+
+    this->_layout.parse(line, true);
+    return true;
+}
+
+/* Extrait de _pending les "records" prochains enregistrements complets, en
+ * lisant le peripherique par blocs si necessaire. L'etat du decoupage est
+ * conserve entre deux lectures pour ne jamais reparcourir les donnees. */
+bool QCSVReader::nextChunk(int records, QByteArray& chunk)
+{
+    for (;;)
+    {
+        const char* data = this->_pending.constData();
+        int size = this->_pending.size();
+
+        while (this->_scanPos < size && this->_scannedRecords < records)
+        {
+            char c = data[this->_scanPos++];
+
+            if (c == '"')
+                this->_inQuotes = !this->_inQuotes;
+            else if (c == '\n' && !this->_inQuotes)
+                this->_scannedRecords++;
+        }
+
+        bool complete = (this->_scannedRecords == records);
+
+        if (!complete && !this->_device->atEnd())
+        {
+            QByteArray block = this->_device->read(CSV_READER_BLOCK_SIZE);
+
+            if (!block.isEmpty())
+            {
+                this->_pending.append(block);
+                continue;
+            }
+        }
+
+        // Bloc complet, ou fin du fichier : on rend ce qui a ete lu
+        if (this->_scanPos == 0)
+            return false;
+
+        chunk = this->_pending.left(this->_scanPos);
+        this->_pending.remove(0, this->_scanPos);
+        this->_scanPos = 0;
+        this->_scannedRecords = 0;
+        this->_inQuotes = false;
+
+        return true;
+    }
+}
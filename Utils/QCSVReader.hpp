@@ -0,0 +1,95 @@
+#ifndef __QCSVREADER_HPP__
+#define __QCSVREADER_HPP__
+
+#include "QCSVTable.hpp"
+
+#define CSV_READER_BATCH_ROWS   (64 * 1024)
+#define CSV_READER_BLOCK_SIZE   (1024 * 1024)
+
+/* Lecture par blocs d'un fichier csv de taille quelconque.
+ *
+ * Chaque appel a readNext() remplit une QCSVTable avec au plus batchSize
+ * lignes ; seules ces lignes et un bloc de lecture sont gardes en memoire.
+ * Les champs entre guillemets peuvent contenir des retours a la ligne.
+ *
+ *     QCSVReader reader(&file);
+ *     QCSVTable batch;
+ *     while (reader.readNext(batch))
+ *         ... batch.toDoubleColumn(...) ...
+ *
+ * ou, avec un foncteur qui renvoie false pour interrompre la lecture (il
+ * est copie : les resultats passent par un pointeur) :
+ *
+ *     struct RowCounter
+ *     {
+ *         explicit RowCounter(qint64* rows) : rows(rows) {}
+ *
+ *         bool operator()(const QCSVTable& batch) const
+ *         {
+ *             *this->rows += batch.rowCount();
+ *             return true;
+ *         }
+ *
+ *         qint64* rows;
+ *     };
+ *
+ *     qint64 rows(0);
+ *     reader.forEachBatch(RowCounter(&rows));
+ */
+class QCSVReader
+{
+    public:
+
+        explicit QCSVReader(QIODevice* device,
+                            char separator = DEFAULT_SEPARATOR,
+                            bool hasHeader = true,
+                            int batchSize = CSV_READER_BATCH_ROWS);
+
+        bool readNext(QCSVTable& batch);
+        bool atEnd(void) const;
+
+        template <typename Callback>
+        qint64 forEachBatch(Callback callback);
+
+        // Getters
+        QList<QByteArray> header(void);
+        int batchSize(void) const;
+        qint64 rowsRead(void) const;
+
+    protected:
+
+        bool readHeader(void);
+        bool nextChunk(int records, QByteArray& chunk);
+
+        QIODevice* _device;
+        char       _separator;
+        bool       _hasHeader;
+        bool       _headerRead;
+        int        _batchSize;
+        qint64     _rowsRead;
+
+        QCSVTable  _layout;  // en-tete seul, partage par tous les blocs
+        QByteArray _pending; // donnees lues mais pas encore decoupees
+        int        _scanPos;
+        int        _scannedRecords;
+        bool       _inQuotes;
+};
+
+template <typename Callback>
+qint64 QCSVReader::forEachBatch(Callback callback)
+{
+    QCSVTable batch(this->_separator);
+    qint64 batches(0);
+
+    while (this->readNext(batch))
+    {
+        batches++;
+
+        if (!callback(static_cast<const QCSVTable&>(batch)))
+            break;
+    }
+
+    return batches;
+}
+
+#endif /* __QCSVREADER_HPP__ */
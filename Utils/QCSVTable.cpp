@@ -0,0 +1,455 @@
+#include "QCSVTable.hpp"
+
+namespace
+{
+    const double POWERS_OF_TEN[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+        1e22
+    };
+
+    const quint64 MAX_EXACT_MANTISSA = Q_UINT64_C(1) << 53;
+
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    // Longueur d'un champ dans le tampon (voir QCSVTable::_lengths)
+    inline int fieldLength(int stored)
+    {
+        return stored >= 0 ? stored : -stored - 1;
+    }
+}
+
+QCSVTable::QCSVTable(char separator) :
+    _separator(separator), _rowCount(0)
+{
+}
+
+void QCSVTable::load(const QString& filename, bool hasHeader)
+{
+    QFile file(filename);
+    this->load(file, hasHeader);
+}
+
+void QCSVTable::load(QIODevice& device, bool hasHeader)
+{
+    if (!device.isOpen() && !device.open(QIODevice::ReadOnly))
+        throw QException(QObject::tr("Impossible d'ouvrir le fichier ") +
+                         device.errorString());
+
+    this->parse(device.readAll(), hasHeader);
+}
+
+void QCSVTable::parse(const QByteArray& data, bool hasHeader)
+{
+    this->clear();
+    this->_buffer = data;
+    this->tokenize(hasHeader);
+}
+
+void QCSVTable::parseRows(const QByteArray& data, const QCSVTable& layout)
+{
+    this->clear();
+    this->_separator = layout._separator;
+    this->setHeader(layout._header);
+    this->_buffer = data;
+    this->tokenize(false);
+}
+
+void QCSVTable::clear(void)
+{
+    this->_buffer.clear();
+    this->_rowCount = 0;
+    this->_header.clear();
+    this->_headerIndex.clear();
+    this->_starts.clear();
+    this->_lengths.clear();
+}
+
+void QCSVTable::tokenize(bool hasHeader)
+{
+    const char* base = this->_buffer.constData();
+    const char* end  = base + this->_buffer.size();
+    const char* p    = base;
+    const char  sep  = this->_separator;
+
+    // Estimation du nombre de lignes pour eviter les reallocations
+    int estimatedRows = this->_buffer.count('\n') + 1;
+    for (int i(0); i < this->_starts.size(); ++i)
+    {
+        this->_starts[i].reserve(estimatedRows);
+        this->_lengths[i].reserve(estimatedRows);
+    }
+
+    QList<QByteArray> header;
+    bool readingHeader = hasHeader;
+
+    while (p < end)
+    {
+        // Lignes vides ignorees
+        if (*p == '\n' || *p == '\r')
+        {
+            ++p;
+            continue;
+        }
+
+        int column(0);
+        bool endOfRecord(false);
+
+        while (!endOfRecord)
+        {
+            int start, length;
+            bool escaped(false);
+
+            if (p < end && *p == '"')
+            {
+                start = ++p - base;
+
+                while (p < end)
+                {
+                    if (*p == '"')
+                    {
+                        if (p + 1 < end && p[1] == '"')
+                        {
+                            escaped = true;
+                            p += 2;
+                            continue;
+                        }
+                        break;
+                    }
+                    ++p;
+                }
+
+                length = (p - base) - start;
+
+                // Guillemet fermant puis tout ce qui precede le separateur
+                while (p < end && *p != sep && *p != '\n' && *p != '\r')
+                    ++p;
+            }
+            else
+            {
+                const char* fieldStart = p;
+                while (p < end && *p != sep && *p != '\n' && *p != '\r')
+                    ++p;
+
+                start = fieldStart - base;
+                length = p - fieldStart;
+            }
+
+            if (readingHeader)
+            {
+                QByteArray name(base + start, length);
+                if (escaped)
+                    name.replace("\"\"", "\"");
+
+                header << name.trimmed();
+            }
+            else
+                this->appendField(column, start, length, escaped);
+
+            column++;
+
+            if (p < end && *p == sep)
+                ++p;
+            else
+                endOfRecord = true;
+        }
+
+        if (p < end && *p == '\r')
+            ++p;
+        if (p < end && *p == '\n')
+            ++p;
+
+        if (readingHeader)
+        {
+            this->setHeader(header);
+            readingHeader = false;
+
+            for (int i(0); i < this->_starts.size(); ++i)
+            {
+                this->_starts[i].reserve(estimatedRows);
+                this->_lengths[i].reserve(estimatedRows);
+            }
+            continue;
+        }
+
+        // Champs manquants en fin de ligne
+        for (int i(column); i < this->_starts.size(); ++i)
+            this->appendField(i, 0, 0, false);
+
+        this->_rowCount++;
+    }
+}
+
+void QCSVTable::appendField(int column, int start, int length, bool escaped)
+{
+    if (column >= this->_starts.size())
+    {
+        // Colonne supplementaire : ignoree si l'en-tete la fixe
+        if (!this->_header.isEmpty())
+            return;
+
+        this->_starts.append(QVector<int>(this->_rowCount, 0));
+        this->_lengths.append(QVector<int>(this->_rowCount, 0));
+    }
+
+    this->_starts[column].append(start);
+    this->_lengths[column].append(escaped ? -length - 1 : length);
+}
+
+void QCSVTable::setHeader(const QList<QByteArray>& header)
+{
+    this->_header = header;
+    this->_headerIndex.clear();
+    this->_starts.resize(header.size());
+    this->_lengths.resize(header.size());
+
+    for (int i(header.size() - 1); i >= 0; --i)
+        this->_headerIndex.insert(header.at(i), i);
+}
+
+void QCSVTable::checkIndex(int row, int column) const
+{
+    if (row < 0 || row >= this->_rowCount ||
+        column < 0 || column >= this->_starts.size())
+        throw QException(QObject::tr("Indice trop grand"));
+}
+
+char QCSVTable::separator(void) const
+{
+    return this->_separator;
+}
+
+int QCSVTable::rowCount(void) const
+{
+    return this->_rowCount;
+}
+
+int QCSVTable::columnCount(void) const
+{
+    return this->_starts.size();
+}
+
+QList<QByteArray> QCSVTable::header(void) const
+{
+    return this->_header;
+}
+
+QString QCSVTable::columnName(int column) const
+{
+    if (column < 0 || column >= this->_header.size())
+        throw QException(QObject::tr("Indice trop grand"));
+
+    return QString::fromUtf8(this->_header.at(column));
+}
+
+int QCSVTable::columnIndice(const QString& columnName) const
+{
+    QHash<QByteArray, int>::const_iterator it =
+            this->_headerIndex.constFind(columnName.toUtf8());
+
+    if (it == this->_headerIndex.constEnd())
+        throw QException(QObject::tr("Column not found"));
+
+    return it.value();
+}
+
+QByteArray QCSVTable::field(int row, int column) const
+{
+    this->checkIndex(row, column);
+
+    int start  = this->_starts.at(column).at(row);
+    int length = this->_lengths.at(column).at(row);
+
+    if (length >= 0)
+        return QByteArray::fromRawData(this->_buffer.constData() + start,
+                                       length);
+
+    // Seuls les champs contenant "" sont recopies
+    QByteArray unescaped(this->_buffer.constData() + start, fieldLength(length));
+    unescaped.replace("\"\"", "\"");
+
+    return unescaped;
+}
+
+QString QCSVTable::text(int row, int column) const
+{
+    return QString::fromUtf8(this->field(row, column));
+}
+
+double QCSVTable::toDouble(int row, int column, bool* ok) const
+{
+    this->checkIndex(row, column);
+
+    const char* begin = this->_buffer.constData() + this->_starts.at(column).at(row);
+    int length = fieldLength(this->_lengths.at(column).at(row));
+
+    return QCSVTable::parseDouble(begin, begin + length, ok);
+}
+
+qint64 QCSVTable::toLongLong(int row, int column, bool* ok) const
+{
+    this->checkIndex(row, column);
+
+    const char* begin = this->_buffer.constData() + this->_starts.at(column).at(row);
+    int length = fieldLength(this->_lengths.at(column).at(row));
+
+    return QCSVTable::parseLongLong(begin, begin + length, ok);
+}
+
+QVector<double> QCSVTable::toDoubleColumn(int column, bool* ok) const
+{
+    if (column < 0 || column >= this->_starts.size())
+        throw QException(QObject::tr("Indice trop grand"));
+
+    QVector<double> values(this->_rowCount);
+    const char* base = this->_buffer.constData();
+    const int* starts = this->_starts.at(column).constData();
+    const int* lengths = this->_lengths.at(column).constData();
+    bool allOk(true), fieldOk;
+
+    for (int i(0); i < this->_rowCount; ++i)
+    {
+        const char* begin = base + starts[i];
+        values[i] = QCSVTable::parseDouble(begin, begin + fieldLength(lengths[i]),
+                                           &fieldOk);
+        allOk &= fieldOk;
+    }
+
+    if (ok != NULL)
+        *ok = allOk;
+
+    return values;
+}
+
+QVector<qint64> QCSVTable::toLongLongColumn(int column, bool* ok) const
+{
+    if (column < 0 || column >= this->_starts.size())
+        throw QException(QObject::tr("Indice trop grand"));
+
+    QVector<qint64> values(this->_rowCount);
+    const char* base = this->_buffer.constData();
+    const int* starts = this->_starts.at(column).constData();
+    const int* lengths = this->_lengths.at(column).constData();
+    bool allOk(true), fieldOk;
+
+    for (int i(0); i < this->_rowCount; ++i)
+    {
+        const char* begin = base + starts[i];
+        values[i] = QCSVTable::parseLongLong(begin, begin + fieldLength(lengths[i]),
+                                             &fieldOk);
+        allOk &= fieldOk;
+    }
+
+    if (ok != NULL)
+        *ok = allOk;
+
+    return values;
+}
+
+double QCSVTable::parseDouble(const char* begin, const char* end, bool* ok)
+{
+    const char* p = begin;
+
+    while (p < end && isSpace(*p))
+        ++p;
+    while (end > p && isSpace(end[-1]))
+        --end;
+
+    bool negative(false);
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    quint64 mantissa(0);
+    int exponent(0);
+    int digits(0);
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits)
+    {
+        if (mantissa < Q_UINT64_C(1000000000000000000))
+            mantissa = mantissa * 10 + (*p - '0');
+        else
+            exponent++;
+    }
+
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits)
+        {
+            if (mantissa < Q_UINT64_C(1000000000000000000))
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+        }
+    }
+
+    if (digits > 0 && p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool negativeExp(false);
+
+        if (q < end && (*q == '-' || *q == '+'))
+            negativeExp = (*q++ == '-');
+
+        if (q < end && *q >= '0' && *q <= '9')
+        {
+            int value(0);
+            for (; q < end && *q >= '0' && *q <= '9'; ++q)
+                value = qMin(value * 10 + (*q - '0'), 100000);
+
+            exponent += negativeExp ? -value : value;
+            p = q;
+        }
+    }
+
+    if (digits > 0 && p == end && mantissa <= MAX_EXACT_MANTISSA &&
+        exponent >= -22 && exponent <= 22)
+    {
+        // Cas exact : un seul arrondi (mantisse et puissance representables)
+        double value = double(mantissa);
+        value = exponent < 0 ? value / POWERS_OF_TEN[-exponent]
+                             : value * POWERS_OF_TEN[exponent];
+
+        if (ok != NULL)
+            *ok = true;
+
+        return negative ? -value : value;
+    }
+
+    // Cas rares (nan, inf, tres grande precision) : conversion Qt, sans locale
+    return QByteArray(begin, end - begin).trimmed().toDouble(ok);
+}
+
+qint64 QCSVTable::parseLongLong(const char* begin, const char* end, bool* ok)
+{
+    const char* p = begin;
+
+    while (p < end && isSpace(*p))
+        ++p;
+    while (end > p && isSpace(end[-1]))
+        --end;
+
+    bool negative(false);
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    quint64 value(0);
+    const char* digitsStart = p;
+
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+        value = value * 10 + (*p - '0');
+
+    int digits = p - digitsStart;
+    bool valid = digits > 0 && digits <= 18 && p == end;
+
+    if (!valid)
+        return QByteArray(begin, end - begin).trimmed().toLongLong(ok);
+
+    if (ok != NULL)
+        *ok = true;
+
+    return negative ? -qint64(value) : qint64(value);
+}
@@ -0,0 +1,76 @@
+#ifndef __QCSVTABLE_HPP__
+#define __QCSVTABLE_HPP__
+
+#include "QCSVParser.hpp"
+
+/* Mode de lecture rapide des fichiers csv (gros logs d'acquisition).
+ *
+ * Le fichier est charge dans un unique tampon ; seules les positions des
+ * champs sont memorisees, colonne par colonne. Aucun QString n'est cree a
+ * la lecture : field() renvoie une vue sur le tampon et les colonnes
+ * numeriques sont converties directement en QVector<double>/<qint64>.
+ *
+ * Les champs entre guillemets ("a;b", "dit ""bonjour""") sont supportes.
+ * Les vues renvoyees par field() restent valides tant que la table n'est
+ * ni modifiee ni detruite.
+ */
+class QCSVTable
+{
+    public:
+
+        explicit QCSVTable(char separator = DEFAULT_SEPARATOR);
+
+        void load(const QString& filename, bool hasHeader = true);
+        void load(QIODevice& device, bool hasHeader = true);
+        void parse(const QByteArray& data, bool hasHeader = true);
+
+        /* Lecture de lignes sans en-tete, en reprenant les colonnes d'une
+         * table precedente (lecture par blocs) */
+        void parseRows(const QByteArray& data, const QCSVTable& layout);
+        void clear(void);
+
+        // Getters
+        char separator(void) const;
+        int rowCount(void) const;
+        int columnCount(void) const;
+        QList<QByteArray> header(void) const;
+        QString columnName(int column) const;
+        int columnIndice(const QString& columnName) const;
+
+        // Acces aux champs
+        QByteArray field(int row, int column) const;
+        QString text(int row, int column) const;
+        double toDouble(int row, int column, bool* ok = NULL) const;
+        qint64 toLongLong(int row, int column, bool* ok = NULL) const;
+
+        // Extraction typee d'une colonne complete
+        QVector<double> toDoubleColumn(int column, bool* ok = NULL) const;
+        QVector<qint64> toLongLongColumn(int column, bool* ok = NULL) const;
+
+        static double parseDouble(const char* begin, const char* end,
+                                  bool* ok = NULL);
+        static qint64 parseLongLong(const char* begin, const char* end,
+                                    bool* ok = NULL);
+
+    protected:
+
+        void tokenize(bool hasHeader);
+        void appendField(int column, int start, int length, bool escaped);
+        void setHeader(const QList<QByteArray>& header);
+        void checkIndex(int row, int column) const;
+
+        char       _separator;
+        QByteArray _buffer;
+        int        _rowCount;
+
+        QList<QByteArray>     _header;
+        QHash<QByteArray, int> _headerIndex;
+
+        /* Stockage par colonnes : debut et longueur de chaque champ dans le
+         * tampon. Une longueur negative (-longueur - 1) signale un champ qui
+         * contient des guillemets doubles a reduire. */
+        QVector< QVector<int> > _starts;
+        QVector< QVector<int> > _lengths;
+};
+
+#endif /* __QCSVTABLE_HPP__ */
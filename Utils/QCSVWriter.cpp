@@ -0,0 +1,191 @@
+#include "QCSVWriter.hpp"
+
+QCSVWriter::QCSVWriter(QIODevice* device, const QChar& separator) :
+    _device(device), _separator(QString(separator).toUtf8()),
+    _rowStarted(false), _error(false), _rowCount(0)
+{
+    this->_buffer.reserve(CSV_WRITER_BUFFER_SIZE + 1024);
+
+    if (this->_device == NULL || !this->_device->isWritable())
+        throw QException(QObject::tr("Le fichier csv n'est pas ouvert en écriture"));
+}
+
+QCSVWriter::~QCSVWriter(void)
+{
+    this->flush();
+}
+
+QCSVWriter& QCSVWriter::writeField(const QString& field)
+{
+    this->beginField();
+    this->appendEscaped(field.toUtf8());
+
+    return *this;
+}
+
+QCSVWriter& QCSVWriter::writeField(const char* field)
+{
+    this->beginField();
+    this->appendEscaped(QByteArray(field));
+
+    return *this;
+}
+
+QCSVWriter& QCSVWriter::writeField(int value)
+{
+    return this->writeField(qint64(value));
+}
+
+QCSVWriter& QCSVWriter::writeField(qint64 value)
+{
+    this->beginField();
+    QCSVWriter::appendNumber(this->_buffer, value);
+
+    return *this;
+}
+
+QCSVWriter& QCSVWriter::writeField(double value, int precision)
+{
+    this->beginField();
+    QCSVWriter::appendNumber(this->_buffer, value, precision);
+
+    return *this;
+}
+
+void QCSVWriter::writeRow(const QCSVRow& row)
+{
+    foreach (const QString& field, row)
+        this->writeField(field);
+
+    this->endRow();
+}
+
+void QCSVWriter::endRow(void)
+{
+    this->_buffer.append('\n');
+    this->_rowStarted = false;
+    this->_rowCount++;
+
+    if (this->_buffer.size() >= CSV_WRITER_BUFFER_SIZE)
+        this->flush();
+}
+
+bool QCSVWriter::flush(void)
+{
+    if (this->_buffer.isEmpty())
+        return !this->_error;
+
+    if (this->_device->write(this->_buffer) != this->_buffer.size())
+        this->_error = true;
+
+    // clear() libererait la capacite reservee
+    this->_buffer.resize(0);
+
+    return !this->_error;
+}
+
+bool QCSVWriter::hasError(void) const
+{
+    return this->_error;
+}
+
+qint64 QCSVWriter::rowCount(void) const
+{
+    return this->_rowCount;
+}
+
+void QCSVWriter::beginField(void)
+{
+    if (this->_rowStarted)
+        this->_buffer.append(this->_separator);
+
+    this->_rowStarted = true;
+}
+
+void QCSVWriter::appendEscaped(const QByteArray& utf8)
+{
+    bool quote = utf8.contains(this->_separator) || utf8.contains('"') ||
+                 utf8.contains('\n') || utf8.contains('\r');
+
+    if (!quote)
+    {
+        this->_buffer.append(utf8);
+        return;
+    }
+
+    QByteArray escaped(utf8);
+    escaped.replace('"', "\"\"");
+
+    this->_buffer.append('"');
+    this->_buffer.append(escaped);
+    this->_buffer.append('"');
+}
+
+void QCSVWriter::appendNumber(QByteArray& out, qint64 value)
+{
+    char digits[24];
+    int pos(sizeof(digits));
+    quint64 magnitude = value < 0 ? quint64(-(value + 1)) + 1 : quint64(value);
+
+    do
+    {
+        digits[--pos] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    while (magnitude != 0);
+
+    if (value < 0)
+        digits[--pos] = '-';
+
+    out.append(digits + pos, int(sizeof(digits)) - pos);
+}
+
+void QCSVWriter::appendNumber(QByteArray& out, double value, int precision)
+{
+    static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+                                     1e7, 1e8, 1e9 };
+
+    precision = qBound(0, precision, 9);
+    double scaled = value * powers[precision];
+
+    /* Hors de la plage exacte d'un entier 64 bits (ou nan/inf) : on passe
+     * par Qt, egalement independant de la locale */
+    if (!(qAbs(scaled) < 9e15))
+    {
+        out.append(QByteArray::number(value, 'g', 15));
+        return;
+    }
+
+    qint64 fixed = qRound64(scaled);
+
+    if (fixed < 0)
+    {
+        out.append('-');
+        fixed = -fixed;
+    }
+
+    qint64 divisor = qint64(powers[precision]);
+    QCSVWriter::appendNumber(out, fixed / divisor);
+
+    if (precision == 0)
+        return;
+
+    // Partie decimale sans les zeros non significatifs
+    qint64 fraction = fixed % divisor;
+    if (fraction == 0)
+        return;
+
+    char digits[10];
+    for (int i(precision - 1); i >= 0; --i)
+    {
+        digits[i] = char('0' + fraction % 10);
+        fraction /= 10;
+    }
+
+    int length(precision);
+    while (digits[length - 1] == '0')
+        length--;
+
+    out.append('.');
+    out.append(digits, length);
+}
@@ -0,0 +1,53 @@
+#ifndef __QCSVWRITER_HPP__
+#define __QCSVWRITER_HPP__
+
+#include "QCSVParser.hpp"
+
+#define CSV_WRITER_BUFFER_SIZE  (64 * 1024)
+#define CSV_DEFAULT_PRECISION   3
+
+/* Ecriture d'un fichier csv ligne par ligne.
+ *
+ * Contrairement a QCSVParser, rien n'est conserve en memoire : les champs
+ * sont formates dans un tampon qui est vide dans le QIODevice des qu'il
+ * depasse CSV_WRITER_BUFFER_SIZE. Les nombres sont ecrits avec un point
+ * decimal, independamment de la locale du systeme.
+ */
+class QCSVWriter
+{
+    public:
+
+        explicit QCSVWriter(QIODevice* device,
+                            const QChar& separator = DEFAULT_SEPARATOR);
+        ~QCSVWriter(void);
+
+        QCSVWriter& writeField(const QString& field);
+        QCSVWriter& writeField(const char* field);
+        QCSVWriter& writeField(int value);
+        QCSVWriter& writeField(qint64 value);
+        QCSVWriter& writeField(double value,
+                               int precision = CSV_DEFAULT_PRECISION);
+        void writeRow(const QCSVRow& row);
+        void endRow(void);
+
+        bool flush(void);
+        bool hasError(void) const;
+        qint64 rowCount(void) const;
+
+        static void appendNumber(QByteArray& out, qint64 value);
+        static void appendNumber(QByteArray& out, double value, int precision);
+
+    protected:
+
+        void beginField(void);
+        void appendEscaped(const QByteArray& utf8);
+
+        QIODevice* _device;
+        QByteArray _separator;
+        QByteArray _buffer;
+        bool       _rowStarted;
+        bool       _error;
+        qint64     _rowCount;
+};
+
+#endif /* __QCSVWRITER_HPP__ */
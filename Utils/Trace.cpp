@@ -0,0 +1,270 @@
+#include "Trace.hpp"
+
+/* Tampon circulaire a ecrivain unique : seul le thread proprietaire ecrit,
+ * le compteur est publie apres l'ecriture de l'evenement. */
+class TraceBuffer
+{
+    public:
+
+        explicit TraceBuffer(int threadId) :
+            threadId(threadId), retired(false), written(0)
+        {
+        }
+
+        void push(const TraceEvent& event)
+        {
+            int index = this->written.fetchAndAddRelaxed(0);
+            this->events[index & (TRACE_BUFFER_CAPACITY - 1)] = event;
+            this->written.fetchAndStoreRelease(index + 1);
+        }
+
+        int threadId;
+        bool retired; // thread termine, protege par Trace::registryMutex
+        QAtomicInt written;
+        TraceEvent events[TRACE_BUFFER_CAPACITY];
+};
+
+QAtomicInt    Trace::enabled(0);
+QMutex        Trace::registryMutex;
+QList<TraceBuffer*> Trace::buffers;
+QAtomicInt    Trace::generation(0);
+int           Trace::threadCount(0);
+QElapsedTimer Trace::clock;
+
+/* QThreadStorage detruit sa valeur a la fin du thread : le tampon, lui,
+ * appartient au registre pour rester disponible au moment du dump. Un
+ * tampon d'une generation anterieure a deja ete libere par release(). */
+struct TraceBufferHandle
+{
+    TraceBufferHandle(void) :
+        buffer(NULL), generation(-1)
+    {
+    }
+
+    ~TraceBufferHandle(void)
+    {
+        if (this->buffer != NULL)
+            Trace::retire(this->buffer, this->generation);
+    }
+
+    TraceBuffer* buffer;
+    int generation;
+};
+
+// Declare apres le registre : detruit avant lui a la fin du programme
+static QThreadStorage<TraceBufferHandle*> threadBuffers;
+
+void Trace::setEnabled(bool enabled)
+{
+    if (enabled && !Trace::clock.isValid())
+        Trace::clock.start();
+
+    Trace::enabled.fetchAndStoreOrdered(enabled ? 1 : 0);
+}
+
+bool Trace::isEnabled(void)
+{
+    return Trace::enabled.fetchAndAddRelaxed(0) != 0;
+}
+
+qint64 Trace::now(void)
+{
+    return Trace::clock.isValid() ? Trace::clock.nsecsElapsed() / 1000 : 0;
+}
+
+void Trace::record(const char* category, const char* name,
+                   qint64 start, qint64 duration)
+{
+    if (!Trace::isEnabled())
+        return;
+
+    TraceEvent event;
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+
+    Trace::currentBuffer()->push(event);
+}
+
+TraceBuffer* Trace::currentBuffer(void)
+{
+    int current = Trace::generation.fetchAndAddRelaxed(0);
+
+    if (threadBuffers.hasLocalData())
+    {
+        TraceBufferHandle* handle = threadBuffers.localData();
+
+        if (handle->generation == current)
+            return handle->buffer;
+    }
+
+    // Premier evenement du thread (ou apres release) : seul passage sous verrou
+    QMutexLocker locker(&Trace::registryMutex);
+
+    if (!threadBuffers.hasLocalData())
+        threadBuffers.setLocalData(new TraceBufferHandle);
+
+    TraceBufferHandle* handle = threadBuffers.localData();
+    handle->buffer = new TraceBuffer(++Trace::threadCount);
+    handle->generation = Trace::generation.fetchAndAddRelaxed(0);
+    Trace::buffers.append(handle->buffer);
+
+    return handle->buffer;
+}
+
+void Trace::retire(TraceBuffer* buffer, int generation)
+{
+    QMutexLocker locker(&Trace::registryMutex);
+
+    // Deja libere par release()
+    if (generation != Trace::generation.fetchAndAddRelaxed(0))
+        return;
+
+    // Thread sans evenement : rien a garder
+    if (buffer->written.fetchAndAddAcquire(0) == 0)
+    {
+        Trace::buffers.removeOne(buffer);
+        delete buffer;
+        return;
+    }
+
+    buffer->retired = true;
+
+    int retired(0);
+    foreach (TraceBuffer* b, Trace::buffers)
+        if (b->retired)
+            ++retired;
+
+    // Les plus anciens tampons de threads termines sont liberes
+    for (int i(0); i < Trace::buffers.size() && retired > TRACE_MAX_RETIRED_BUFFERS; )
+    {
+        if (Trace::buffers.at(i)->retired)
+        {
+            delete Trace::buffers.takeAt(i);
+            --retired;
+        }
+        else
+            ++i;
+    }
+}
+
+bool Trace::dump(const QString& filepath)
+{
+    QFile file(filepath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Impossible d'ecrire la trace dans" << filepath;
+        return false;
+    }
+
+    return Trace::dump(&file);
+}
+
+bool Trace::dump(QIODevice* device)
+{
+    if (device == NULL || !device->isWritable())
+        return false;
+
+    QMutexLocker locker(&Trace::registryMutex);
+    qint64 pid = QCoreApplication::applicationPid();
+    bool first(true);
+
+    device->write("{\"traceEvents\":[\n");
+
+    foreach (TraceBuffer* buffer, Trace::buffers)
+    {
+        int written = buffer->written.fetchAndAddAcquire(0);
+        int begin = qMax(0, written - TRACE_BUFFER_CAPACITY);
+
+        // Nom du thread pour le visualiseur
+        device->write(first ? "" : ",\n");
+        device->write(QString("{\"name\":\"thread_name\",\"ph\":\"M\","
+                              "\"pid\":%1,\"tid\":%2,"
+                              "\"args\":{\"name\":\"thread %2\"}}")
+                      .arg(pid).arg(buffer->threadId).toLatin1());
+        first = false;
+
+        for (int i(begin); i < written; ++i)
+            Trace::writeEvent(device,
+                              buffer->events[i & (TRACE_BUFFER_CAPACITY - 1)],
+                              buffer->threadId, first);
+    }
+
+    device->write("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return true;
+}
+
+void Trace::writeEvent(QIODevice* device, const TraceEvent& event,
+                       int threadId, bool& first)
+{
+    QByteArray line;
+    line.reserve(160);
+
+    if (!first)
+        line += ",\n";
+
+    line += "{\"name\":\"" + escape(event.name)
+            + "\",\"cat\":\"" + escape(event.category)
+            + "\",\"ph\":\"X\",\"ts\":" + QByteArray::number(event.start)
+            + ",\"dur\":" + QByteArray::number(event.duration)
+            + ",\"pid\":" + QByteArray::number(QCoreApplication::applicationPid())
+            + ",\"tid\":" + QByteArray::number(threadId) + "}";
+
+    device->write(line);
+    first = false;
+}
+
+QByteArray Trace::escape(const char* str)
+{
+    QByteArray escaped(str);
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+
+    return escaped;
+}
+
+void Trace::clear(void)
+{
+    QMutexLocker locker(&Trace::registryMutex);
+
+    for (int i(Trace::buffers.size() - 1); i >= 0; --i)
+    {
+        TraceBuffer* buffer = Trace::buffers.at(i);
+
+        if (buffer->retired)
+        {
+            Trace::buffers.removeAt(i);
+            delete buffer;
+        }
+        else
+            buffer->written.fetchAndStoreRelease(0);
+    }
+}
+
+void Trace::release(void)
+{
+    Trace::setEnabled(false);
+
+    QMutexLocker locker(&Trace::registryMutex);
+
+    // Les threads encore actifs reprendront un nouveau tampon si besoin
+    Trace::generation.fetchAndAddOrdered(1);
+    qDeleteAll(Trace::buffers);
+    Trace::buffers.clear();
+}
+
+TraceScope::TraceScope(const char* category, const char* name) :
+    _category(category), _name(name),
+    _start(Trace::isEnabled() ? Trace::now() : -1)
+{
+}
+
+TraceScope::~TraceScope(void)
+{
+    if (this->_start >= 0)
+        Trace::record(this->_category, this->_name, this->_start,
+                      Trace::now() - this->_start);
+}
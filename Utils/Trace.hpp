@@ -0,0 +1,101 @@
+#ifndef __TRACE_HPP__
+#define __TRACE_HPP__
+
+#include <QtCore>
+
+/* Instrumentation des chemins critiques.
+ *
+ * TRACE_SCOPE("categorie", "nom") mesure la duree du bloc englobant. Chaque
+ * thread enregistre ses evenements dans son propre tampon circulaire, sans
+ * verrou ni allocation ; les plus anciens sont ecrases lorsqu'il est plein.
+ * Trace::dump() produit un fichier JSON au format trace_event de Chrome
+ * (chrome://tracing, Perfetto).
+ *
+ * La collecte est desactivee par defaut (Trace::setEnabled) et peut etre
+ * retiree a la compilation : DEFINES += ECO_NO_TRACE
+ *
+ * Le tampon d'un thread termine reste disponible pour le dump ; au-dela de
+ * TRACE_MAX_RETIRED_BUFFERS, les plus anciens sont liberes. clear() libere
+ * les tampons des threads termines, release() tous les tampons (fin du
+ * programme, apres le dump).
+ *
+ * Les noms et categories doivent etre des chaines litterales : seul le
+ * pointeur est conserve.
+ */
+
+#define TRACE_BUFFER_CAPACITY   (1 << 16) // evenements par thread
+#define TRACE_MAX_RETIRED_BUFFERS 8       // tampons gardes apres leur thread
+
+struct TraceEvent
+{
+    const char* category;
+    const char* name;
+    qint64      start;    // microsecondes depuis Trace::setEnabled(true)
+    qint64      duration; // microsecondes
+};
+
+class TraceBuffer;
+struct TraceBufferHandle;
+
+class Trace
+{
+    public:
+
+        static void setEnabled(bool enabled);
+        static bool isEnabled(void);
+
+        static qint64 now(void);
+        static void record(const char* category, const char* name,
+                           qint64 start, qint64 duration);
+
+        // A appeler lorsque les threads instrumentes sont au repos
+        static bool dump(const QString& filepath);
+        static bool dump(QIODevice* device);
+        static void clear(void);
+        static void release(void);
+
+    private:
+
+        friend struct TraceBufferHandle;
+
+        static TraceBuffer* currentBuffer(void);
+        static void retire(TraceBuffer* buffer, int generation);
+        static void writeEvent(QIODevice* device, const TraceEvent& event,
+                               int threadId, bool& first);
+        static QByteArray escape(const char* str);
+
+        static QAtomicInt   enabled;
+        static QMutex       registryMutex;
+        static QList<TraceBuffer*> buffers;
+        static QAtomicInt   generation; // incremente par release()
+        static int          threadCount;
+        static QElapsedTimer clock;
+};
+
+class TraceScope
+{
+    public:
+
+        TraceScope(const char* category, const char* name);
+        ~TraceScope(void);
+
+    private:
+
+        Q_DISABLE_COPY(TraceScope)
+
+        const char* _category;
+        const char* _name;
+        qint64      _start;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifdef ECO_NO_TRACE
+    #define TRACE_SCOPE(category, name) ((void) 0)
+#else
+    #define TRACE_SCOPE(category, name) \
+        TraceScope TRACE_CONCAT(_traceScope, __LINE__)(category, name)
+#endif
+
+#endif /* __TRACE_HPP__ */
@@ -0,0 +1,1064 @@
+#include "HotPathBenchmark.hpp"
+#include "../Common/LapResampler.hpp"
+#include "../DBModule/ImportModule.hpp"
+#include "../DBModule/ChannelRegistry.hpp"
+#include "../DBModule/LapDetector.hpp"
+#include "../DBModule/Race.hpp"
+#include "../DBModule/SectorEditSession.hpp"
+#include "../DBModule/SectorStatistics.hpp"
+#include "../Map/DensityRaster.hpp"
+#include "../Map/MapScene.hpp"
+#include "../Map/SectorItem.hpp"
+#include "../Map/TrackGeometry.hpp"
+#include "../Plot/PlotCurve.hpp"
+#include "../Plot/PlotScene.hpp"
+#include "../Utils/QCSVReader.hpp"
+#include "../Utils/QCSVTable.hpp"
+#include "../Utils/DataBaseManager.hpp"
+
+#define WHEEL_PERIMETER 1.5
+
+namespace
+{
+    // Releve la taille de chaque bloc lu par QCSVReader::forEachBatch
+    struct BatchSizes
+    {
+        explicit BatchSizes(QList<int>* sizes) :
+            sizes(sizes)
+        {
+        }
+
+        bool operator()(const QCSVTable& batch) const
+        {
+            this->sizes->append(batch.rowCount());
+            return true;
+        }
+
+        QList<int>* sizes;
+    };
+}
+
+void HotPathBenchmark::initTestCase(void)
+{
+    // Ne pas toucher a la configuration de l'application installee
+    QCoreApplication::setOrganizationName("EcoMotion");
+    QCoreApplication::setApplicationName("EcoManager2013Benchmarks");
+
+    this->workingDir = QDir::temp();
+    QString dirName = QString("EcoManagerBenchmarks-%1")
+                      .arg(QCoreApplication::applicationPid());
+    QVERIFY(this->workingDir.mkpath(dirName));
+    QVERIFY(this->workingDir.cd(dirName));
+
+    QFile::remove(this->workingDir.filePath("benchmarks.db"));
+    QVERIFY(DataBaseManager::createDataBase(this->workingDir, "benchmarks.db"));
+
+    this->competition = "Benchmark";
+
+    ImportModule importModule;
+    QVERIFY(importModule.createCompetition(this->competition, WHEEL_PERIMETER,
+                                           "Synthetic circuit"));
+}
+
+void HotPathBenchmark::cleanupTestCase(void)
+{
+    QSqlDatabase::database().close();
+
+    foreach (const QString& entry,
+             this->workingDir.entryList(QDir::Files | QDir::NoDotAndDotDot))
+        this->workingDir.remove(entry);
+
+    foreach (const QString& entry,
+             this->workingDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        QDir raceDir(this->workingDir.filePath(entry));
+        foreach (const QString& file, raceDir.entryList(QDir::Files))
+            raceDir.remove(file);
+        this->workingDir.rmdir(entry);
+    }
+
+    QDir::temp().rmdir(this->workingDir.dirName());
+}
+
+void HotPathBenchmark::addLapCountColumn(void)
+{
+    QTest::addColumn<int>("lapCount");
+
+    QTest::newRow("1 lap")   << 1;
+    QTest::newRow("10 laps") << 10;
+    QTest::newRow("50 laps") << 50;
+}
+
+QVector<GeoCoordinate> HotPathBenchmark::validCoordinates(
+        TelemetryGenerator& generator) const
+{
+    QVector<GeoCoordinate> coords;
+
+    foreach (const QString& frame, generator.gpsFrames())
+    {
+        GeoCoordinate coord(frame);
+
+        if (coord.goodtype() && coord.valid())
+            coords << coord;
+    }
+
+    return coords;
+}
+
+TelemetrySeries HotPathBenchmark::projectedTrack(
+        TelemetryGenerator& generator) const
+{
+    // Trace tel qu'il est affiche sur la carte (MainWindow::displayDataLap)
+    QVector<GeoCoordinate> coords = this->validCoordinates(generator);
+    TelemetrySeriesBuilder builder(coords.size());
+    QTime origin = coords.isEmpty() ? QTime() : coords.first().time();
+
+    foreach (const GeoCoordinate& coord, coords)
+    {
+        qreal time = origin.msecsTo(coord.time()) / 1000.0;
+        builder.append(time, coord.projection(), time);
+    }
+
+    return builder.take();
+}
+
+TelemetrySeries HotPathBenchmark::timeSpeedSeries(
+        TelemetryGenerator& generator) const
+{
+    // Vitesse en fonction du temps, comme dans MainWindow::displayDataLap
+    QList<qint64> ticks = generator.wheelTicks();
+    TelemetrySeriesBuilder builder(ticks.size());
+
+    for (int i(1); i < ticks.size(); ++i)
+    {
+        qreal time = (ticks.at(i) - ticks.first()) / 1e9;
+        qreal speed = WHEEL_PERIMETER * 3.6e9 / (ticks.at(i) - ticks.at(i - 1));
+        builder.append(time, time, speed);
+    }
+
+    return builder.take();
+}
+
+/* -------------------------------------------------------------------------- *
+ *                               Parsing NMEA                                 *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::geoCoordinateParsing_data(void)
+{
+    QTest::addColumn<QStringList>("frames");
+
+    TelemetryGenerator generator;
+    generator.setLapCount(10);
+    generator.setPositionNoise(1.5);
+    generator.setDropoutRate(0.01);
+    generator.setDropoutLength(5);
+
+    QStringList all = generator.gpsFrames();
+
+    QTest::newRow("GGA") << all.filter(QRegExp("^\\$GPGGA"));
+    QTest::newRow("RMC") << all.filter(QRegExp("^\\$GPRMC"));
+    QTest::newRow("mixed") << all;
+}
+
+void HotPathBenchmark::geoCoordinateParsing(void)
+{
+    QFETCH(QStringList, frames);
+    QVERIFY(!frames.isEmpty());
+
+    int valid(0);
+
+    QBENCHMARK
+    {
+        valid = 0;
+
+        foreach (const QString& frame, frames)
+        {
+            GeoCoordinate coord(frame);
+
+            if (coord.goodtype() && coord.valid())
+                valid++;
+        }
+    }
+
+    QVERIFY(valid > 0);
+}
+
+/* -------------------------------------------------------------------------- *
+ *                               Parsing CSV                                  *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::csvTableParsing_data(void)
+{
+    QTest::addColumn<int>("rowCount");
+
+    QTest::newRow("10k rows")  << 10000;
+    QTest::newRow("100k rows") << 100000;
+    QTest::newRow("1M rows")   << 1000000;
+}
+
+void HotPathBenchmark::csvTableParsing(void)
+{
+    QFETCH(int, rowCount);
+
+    /* Journal d'acquisition : temps, regime, largeur d'impulsion entre
+     * guillemets et commentaire contenant des guillemets doubles */
+    QByteArray data("time;rpm;\"pulse \"\"width\"\"\";note\n");
+    data.reserve(rowCount * 40);
+
+    for (int i(0); i < rowCount; ++i)
+    {
+        data += QByteArray::number(i * 0.01, 'f', 2);
+        data += ';';
+        data += QByteArray::number(800 + i % 5000);
+        data += ";\"";
+        data += QByteArray::number(1 + (i % 100) / 10.0, 'f', 1);
+        data += "\";\"tour \"\"";
+        data += QByteArray::number(i / 1000);
+        data += "\"\"\"\n";
+    }
+
+    QCSVTable table;
+    QVector<double> times, widths;
+    QVector<qint64> rpms;
+    bool timesOk(false), rpmsOk(false), widthsOk(false);
+
+    QBENCHMARK
+    {
+        table.parse(data);
+        times = table.toDoubleColumn(0, &timesOk);
+        rpms = table.toLongLongColumn(1, &rpmsOk);
+        widths = table.toDoubleColumn(2, &widthsOk);
+    }
+
+    QVERIFY(timesOk && rpmsOk && widthsOk);
+    QCOMPARE(table.rowCount(), rowCount);
+    QCOMPARE(table.columnName(2), QString("pulse \"width\""));
+
+    int last = rowCount - 1;
+    QCOMPARE(times.at(last), QByteArray::number(last * 0.01, 'f', 2).toDouble());
+    QCOMPARE(rpms.at(last), qint64(800 + last % 5000));
+    QCOMPARE(widths.at(11), 2.1);
+    QCOMPARE(table.toDouble(11, 2), 2.1);
+    QCOMPARE(table.field(last, 3),
+             "tour \"" + QByteArray::number(last / 1000) + "\"");
+}
+
+void HotPathBenchmark::csvReaderBatches_data(void)
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::addColumn<int>("batchSize");
+
+    // Le dernier bloc est toujours incomplet
+    QTest::newRow("10k rows, 1k batch")    << 10500   << 1000;
+    QTest::newRow("100k rows, 16k batch")  << 100100  << 16 * 1024;
+    QTest::newRow("1M rows, 64k batch")    << 1000001 << CSV_READER_BATCH_ROWS;
+}
+
+void HotPathBenchmark::csvReaderBatches(void)
+{
+    QFETCH(int, rowCount);
+    QFETCH(int, batchSize);
+
+    /* Un commentaire sur deux lignes tous les 100 enregistrements : un
+     * retour a la ligne entre guillemets ne doit pas couper l'enregistrement */
+    QByteArray data("time;rpm;note\n");
+    data.reserve(rowCount * 20);
+
+    for (int i(0); i < rowCount; ++i)
+    {
+        data += QByteArray::number(i * 0.01, 'f', 2);
+        data += ';';
+        data += QByteArray::number(800 + i % 5000);
+        data += (i % 100 == 0) ? ";\"tour\nsuivant\"\n" : ";\n";
+    }
+
+    QList<int> sizes;
+    qint64 batches(0), rowsRead(0);
+
+    QBENCHMARK
+    {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+        QCSVReader reader(&buffer, ';', true, batchSize);
+
+        sizes.clear();
+        batches = reader.forEachBatch(BatchSizes(&sizes));
+        rowsRead = reader.rowsRead();
+
+        QVERIFY(reader.atEnd());
+    }
+
+    int fullBatches = rowCount / batchSize;
+
+    QCOMPARE(batches, qint64(fullBatches + 1));
+    QCOMPARE(sizes.size(), fullBatches + 1);
+    QCOMPARE(rowsRead, qint64(rowCount));
+
+    for (int i(0); i < fullBatches; ++i)
+        QCOMPARE(sizes.at(i), batchSize);
+
+    QCOMPARE(sizes.last(), rowCount % batchSize);
+}
+
+/* -------------------------------------------------------------------------- *
+ *                          Import en base de donnees                         *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::importModuleBatchInsert_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::importModuleBatchInsert(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+    generator.setPositionNoise(1);
+    generator.setTickJitter(0.0005);
+
+    QString dirName = QString("race-%1").arg(lapCount);
+    QVERIFY(this->workingDir.mkpath(dirName));
+    QDir raceDir(this->workingDir.filePath(dirName));
+    QVERIFY(generator.writeRace(raceDir));
+
+    ImportModule importModule;
+    importModule.setInteractive(false);
+
+    QBENCHMARK
+    {
+        Race race(this->competition);
+        importModule.addRace(race, raceDir);
+    }
+
+    QVERIFY2(importModule.importSuceed(),
+             qPrintable(importModule.getErrorString()));
+}
+
+void HotPathBenchmark::megaSquirtImport_data(void)
+{
+    QTest::addColumn<int>("lapCount");
+
+    // Log moteur a 50 Hz, 100 colonnes : 6000 lignes par tour
+    QTest::newRow("1 lap")   << 1;
+    QTest::newRow("10 laps") << 10;
+}
+
+void HotPathBenchmark::megaSquirtImport(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+    generator.setPositionNoise(1);
+
+    QString dirName = QString("megasquirt-%1").arg(lapCount);
+    QVERIFY(this->workingDir.mkpath(dirName));
+    QDir raceDir(this->workingDir.filePath(dirName));
+    QVERIFY(generator.writeRace(raceDir));
+    QVERIFY(generator.writeEngineLog(raceDir));
+
+    ImportModule importModule;
+    importModule.setInteractive(false);
+
+    QBENCHMARK
+    {
+        Race race(this->competition);
+        importModule.addRace(race, raceDir);
+    }
+
+    QVERIFY2(importModule.importSuceed(),
+             qPrintable(importModule.getErrorString()));
+    QVERIFY(ChannelRegistry::channelNames().contains("RPM"));
+}
+
+/* -------------------------------------------------------------------------- *
+ *                             Detection des tours                            *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::lapDetector_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::lapDetector(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1.5);
+
+    QVector<GeoCoordinate> coords = this->validCoordinates(generator);
+    QList< QPair<QTime, QTime> > laps;
+
+    QBENCHMARK
+    {
+        LapDetector detector(&coords);
+        laps = detector.laps();
+    }
+
+    Q_UNUSED(laps);
+}
+
+/* -------------------------------------------------------------------------- *
+ *                        Recherche du tour d'un instant                      *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::raceNumLap_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::raceNumLap(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+
+    Race race(this->competition);
+    QPair<QTime, QTime> lap;
+    foreach (lap, generator.laps())
+        race.addLap(lap.first, lap.second);
+
+    QList<QTime> times;
+    foreach (const GeoCoordinate& coord, this->validCoordinates(generator))
+        times << coord.time();
+
+    int found(0);
+
+    QBENCHMARK
+    {
+        found = 0;
+
+        foreach (const QTime& time, times)
+            if (race.numLap(time) != -1)
+                found++;
+    }
+
+    QCOMPARE(found, times.size());
+}
+
+/* -------------------------------------------------------------------------- *
+ *                          Construction des courbes                          *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::plotCurveConstruction_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::plotCurveConstruction(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+
+    TelemetrySeries points = this->timeSpeedSeries(generator);
+
+    QBENCHMARK
+    {
+        PlotCurve curve(points);
+        Q_UNUSED(curve);
+    }
+}
+
+void HotPathBenchmark::plotSceneProgressiveCurve_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::plotSceneProgressiveCurve(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+
+    TelemetrySeries points = this->timeSpeedSeries(generator);
+    PlotScene scene(NULL);
+
+    QBENCHMARK
+    {
+        // Temps pendant lequel l'interface est bloquee par l'ajout
+        scene.clearCurves();
+        scene.addCurve(points, QVariant(lapCount));
+    }
+
+    // La geometrie et les points arrivent ensuite, entre deux evenements
+    QTime timer;
+    timer.start();
+
+    while (scene.isLoading() && timer.elapsed() < 30000)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+
+    QVERIFY2(!scene.isLoading(), "chargement de la courbe non termine");
+    QVERIFY(scene.replayDuration() > 0);
+}
+
+/* -------------------------------------------------------------------------- *
+ *                           Peuplement de la carte                           *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::mapSceneAddTrack_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::mapSceneAddTrack(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1);
+
+    TelemetrySeries positions = this->projectedTrack(generator);
+
+    QMap<QString, QVariant> trackIdentifier;
+    trackIdentifier["race"] = 1;
+    trackIdentifier["lap"] = lapCount;
+
+    QBENCHMARK
+    {
+        MapScene scene(50 * 1000);
+        scene.addTrack(positions, trackIdentifier);
+    }
+}
+
+void HotPathBenchmark::mapSceneHeatTrack_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::mapSceneHeatTrack(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+
+    TelemetrySeries positions = this->projectedTrack(generator);
+
+    // Vitesse en fonction du temps, un point par tour de roue
+    QList<qint64> ticks = generator.wheelTicks();
+    TelemetrySeriesBuilder speed(ticks.size());
+
+    for (int i(1); i < ticks.size(); ++i)
+    {
+        qreal time = (ticks.at(i) - ticks.first()) / 1e9;
+        speed.append(time, time,
+                     WHEEL_PERIMETER * 3.6e9 / (ticks.at(i) - ticks.at(i - 1)));
+    }
+
+    QMap<QString, QVariant> trackIdentifier;
+    trackIdentifier["race"] = 1;
+    trackIdentifier["lap"] = lapCount;
+
+    MapScene scene(50 * 1000);
+    scene.addTrack(positions, trackIdentifier);
+    scene.setTrackSpeeds(trackIdentifier, speed.take());
+    scene.setHeatMapEnabled(true);
+
+    // Rendu complet de la scene, comme un rafraichissement de la vue
+    QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK
+    {
+        image.fill(0);
+        QPainter painter(&image);
+        scene.render(&painter);
+    }
+}
+
+void HotPathBenchmark::highlightScrubbing_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::highlightScrubbing(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1);
+
+    TelemetrySeries positions = this->projectedTrack(generator);
+
+    QMap<QString, QVariant> trackIdentifier;
+    trackIdentifier["race"] = 1;
+    trackIdentifier["lap"] = lapCount;
+
+    MapScene scene(50 * 1000);
+    scene.addTrack(positions, trackIdentifier);
+
+    int itemCount = scene.items().count();
+    qreal duration = positions.time(positions.size() - 1);
+
+    QBENCHMARK
+    {
+        // Parcours des lignes du tableau : un point et un intervalle par ligne
+        for (int row(0); row < 200; ++row)
+        {
+            qreal time = duration * row / 200;
+
+            scene.clearSceneSelection();
+            scene.highlightPoint(time, trackIdentifier);
+            scene.highlightSector(time, time + 5, trackIdentifier);
+        }
+    }
+
+    // Aucun item cree par les mises en evidence
+    QCOMPARE(scene.items().count(), itemCount);
+}
+
+void HotPathBenchmark::replayFrames_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::replayFrames(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(1);
+    generator.setPositionNoise(1);
+
+    TelemetrySeries positions = this->projectedTrack(generator);
+
+    // Tours relus ensemble : un trace par tour
+    MapScene scene(50 * 1000);
+    for (int lap(0); lap < lapCount; ++lap)
+    {
+        QMap<QString, QVariant> trackIdentifier;
+        trackIdentifier["race"] = 1;
+        trackIdentifier["lap"] = lap;
+
+        scene.addTrack(positions, trackIdentifier);
+    }
+
+    // La vue donne l'echelle des zones redessinees autour des curseurs
+    QGraphicsView view(&scene);
+    view.resize(800, 600);
+    view.fitInView(scene.itemsBoundingRect(), Qt::KeepAspectRatio);
+
+    int itemCount = scene.items().count();
+    float duration = scene.replayDuration();
+    QVERIFY(duration > 0);
+
+    QBENCHMARK
+    {
+        // Une seconde de relecture a 60 images/s, vitesse x 8
+        for (int frame(0); frame < 60; ++frame)
+            scene.setReplayTime(duration * frame / 60 / 8);
+    }
+
+    // Les curseurs ne creent aucun item
+    QCOMPARE(scene.items().count(), itemCount);
+}
+
+void HotPathBenchmark::trackSimplification_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::trackSimplification(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1);
+
+    // Coordonnees de la scene de MapFrame
+    TelemetrySeries positions = this->projectedTrack(generator);
+    QVector<QPointF> points(positions.size());
+    for (int i(0); i < positions.size(); ++i)
+        points[i] = QPointF(positions.x(i) * 50 * 1000, positions.y(i) * -50 * 1000);
+
+    int overview(0);
+
+    QBENCHMARK
+    {
+        TrackGeometry geometry(points);
+
+        for (int level(TRACK_GEOMETRY_MIN_LEVEL); level <= TRACK_GEOMETRY_MAX_LEVEL; ++level)
+            geometry.path(level);
+
+        overview = geometry.path(TRACK_GEOMETRY_MIN_LEVEL).elementCount();
+    }
+
+    // Vue d'ensemble : au moins dix fois moins de sommets
+    QVERIFY(overview > 1);
+    QVERIFY(overview * 10 < points.size());
+}
+
+void HotPathBenchmark::densityRaster_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::densityRaster(void)
+{
+    QFETCH(int, lapCount);
+
+    // Le meme tour repete : seul le nombre de points compte ici
+    TelemetryGenerator generator;
+    generator.setLapCount(1);
+    generator.setPositionNoise(1.5);
+
+    // Vitesse a l'instant de chaque point, comme LapSeries::competitionLaps
+    TelemetrySeries positions = this->projectedTrack(generator);
+    TelemetrySeries speed = this->timeSpeedSeries(generator);
+    QVector<qreal> pointSpeeds = LapResampler::interpolate(
+                speed.times(), speed.ys(), positions.times());
+
+    TelemetrySeriesBuilder builder(positions.size());
+    QVector<float> speedColumn(positions.size());
+
+    for (int i(0); i < positions.size(); ++i)
+    {
+        builder.append(positions.time(i), positions.point(i), positions.index(i));
+        speedColumn[i] = pointSpeeds.at(i);
+    }
+
+    builder.setSpeeds(speedColumn);
+
+    QVector<TelemetrySeries> laps(lapCount, builder.take());
+    QRectF bounds = DensityRaster::boundsOf(laps);
+    qreal cellSize = GeoCoordinate::getDegreeEquivalence(DENSITY_RASTER_CELL_SIZE);
+
+    QImage image;
+
+    QBENCHMARK
+    {
+        DensityRaster raster(bounds, cellSize);
+        raster.add(laps);
+        image = raster.toImage();
+    }
+
+    QVERIFY(!image.isNull());
+}
+
+void HotPathBenchmark::sectorShape_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::sectorShape(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1);
+
+    // Coordonnees de la scene de MapFrame
+    TelemetrySeries positions = this->projectedTrack(generator);
+    QList<IndexedPosition> points;
+    for (int i(0); i < positions.size(); ++i)
+        points << IndexedPosition(positions.x(i) * 50 * 1000,
+                                  positions.y(i) * -50 * 1000, i);
+
+    // Coupe perpendiculaire au trace au milieu du segment [i, i + 1]
+    int cutIndex = points.size() / 2;
+    QLineF segment(points.at(cutIndex), points.at(cutIndex + 1));
+    QLineF cut = segment.normalVector();
+    cut.translate(segment.pointAt(0.5) - segment.p1());
+    cut = QLineF(cut.pointAt(-1), cut.pointAt(1));
+
+    int pieceCount(0);
+
+    QBENCHMARK
+    {
+        // Creation, coupe puis fusion, comme l'edition des secteurs
+        SectorItem sector;
+        sector.append(points);
+
+        QPair<SectorItem*, SectorItem*> pieces = sector.split(cut);
+        QVERIFY(pieces.first != NULL && pieces.second != NULL);
+
+        pieces.first->merge(*pieces.second);
+        pieceCount = pieces.first->points().count();
+
+        delete pieces.first;
+        delete pieces.second;
+    }
+
+    // Le point de coupe est garde une fois
+    QCOMPARE(pieceCount, points.size() + 1);
+}
+
+/* -------------------------------------------------------------------------- *
+ *                       Alignement des tours (distance)                      *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::lapResampling_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::lapResampling(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+
+    /* Vitesse en fonction de la distance, un point par tour de roue. Le
+     * second tour est le meme, 2% plus lent */
+    QList<qint64> ticks = generator.wheelTicks();
+    TelemetrySeriesBuilder fast(ticks.size());
+    TelemetrySeriesBuilder slow(ticks.size());
+
+    for (int i(1); i < ticks.size(); ++i)
+    {
+        qreal time = (ticks.at(i) - ticks.first()) / 1e9;
+        qreal speed = WHEEL_PERIMETER * 3.6e9 / (ticks.at(i) - ticks.at(i - 1));
+        fast.append(time, i * WHEEL_PERIMETER, speed, time);
+        slow.append(time * 1.02, i * WHEEL_PERIMETER, speed / 1.02, time * 1.02);
+    }
+
+    LapResampler resampler;
+    resampler.addLap(fast.take());
+    resampler.addLap(slow.take());
+
+    QVector<qreal> delta;
+
+    QBENCHMARK
+    {
+        resampler.resample(1.0);
+        delta = resampler.difference(1, 0, LapResampler::TimeChannel);
+    }
+
+    QVERIFY(!delta.isEmpty());
+    QVERIFY(delta.last() > 0);
+}
+
+/* -------------------------------------------------------------------------- *
+ *                           Temps par secteur                                *
+ * -------------------------------------------------------------------------- */
+
+void HotPathBenchmark::sectorCrossings_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::sectorCrossings(void)
+{
+    QFETCH(int, lapCount);
+
+    // Portes placees comme SectorTiming::loadGates sur un tour sans bruit
+    TelemetryGenerator referenceGenerator;
+    referenceGenerator.setLapCount(1);
+    referenceGenerator.setPositionNoise(0);
+    TelemetrySeries reference = this->projectedTrack(referenceGenerator);
+    QVERIFY(reference.size() > 8);
+
+    QVector<SectorGate> gates;
+    int last = reference.size() - 1;
+    QList<int> boundaries;
+    boundaries << 1 << last / 4 << last / 2 << (3 * last) / 4 << last - 1;
+
+    foreach (int i, boundaries)
+        gates << SectorGate(reference.point(i),
+                            reference.point(i + 1) - reference.point(i - 1),
+                            SECTOR_GATE_HALF_WIDTH);
+
+    // Un tour par serie, temps relatif au debut du tour (comme en base)
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setPositionNoise(1.5);
+
+    QVector<GeoCoordinate> coords = this->validCoordinates(generator);
+    QVector<TelemetrySeries> laps;
+    QTime origin = coords.first().time();
+    int c(0);
+
+    typedef QPair<QTime, QTime> LapBounds;
+    foreach (const LapBounds& bounds, generator.laps())
+    {
+        int start = laps.size() * bounds.first.msecsTo(bounds.second);
+        int end = start + bounds.first.msecsTo(bounds.second);
+        TelemetrySeriesBuilder builder;
+
+        for (; c < coords.size() && origin.msecsTo(coords.at(c).time()) <= end; ++c)
+        {
+            qreal time = (origin.msecsTo(coords.at(c).time()) - start) / 1000.0;
+            builder.append(time, coords.at(c).projection(), time);
+        }
+
+        laps << builder.take();
+    }
+
+    QList< QVector<qreal> > crossings;
+
+    QBENCHMARK
+    {
+        crossings.clear();
+
+        foreach (const TelemetrySeries& lap, laps)
+            crossings << SectorTiming::crossings(lap, gates);
+    }
+
+    QCOMPARE(crossings.size(), lapCount);
+
+    // Les portes interieures sont franchies a chaque tour
+    foreach (const QVector<qreal>& times, crossings)
+        for (int g(1); g < times.size() - 1; ++g)
+            QVERIFY(!qIsNaN(times.at(g)) && (g == 1 || times.at(g) > times.at(g - 1)));
+}
+
+void HotPathBenchmark::sectorStatistics_data(void)
+{
+    this->addLapCountColumn();
+}
+
+void HotPathBenchmark::sectorStatistics(void)
+{
+    QFETCH(int, lapCount);
+
+    TelemetryGenerator generator;
+    generator.setLapCount(lapCount);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+
+    // Vitesse en fonction du temps, un point par tour de roue
+    QList<qint64> ticks = generator.wheelTicks();
+    TelemetrySeriesBuilder builder(ticks.size());
+
+    for (int i(1); i < ticks.size(); ++i)
+    {
+        qreal time = (ticks.at(i) - ticks.first()) / 1e9;
+        qreal speed = WHEEL_PERIMETER * 3.6e9 / (ticks.at(i) - ticks.at(i - 1));
+        builder.append(time, time, speed);
+    }
+
+    TelemetrySeries speed = builder.take();
+
+    // Quatre secteurs egaux par tour, toute la course vue comme un tour
+    QPair<QTime, QTime> firstLap = generator.laps().first();
+    qreal sectorDuration = firstLap.first.msecsTo(firstLap.second) / 4000.0;
+
+    QVector<qreal> crossings;
+    for (int g(0); g <= 4 * lapCount; ++g)
+        crossings << g * sectorDuration;
+
+    QVector<qreal> metrics;
+    Distribution times;
+
+    QBENCHMARK
+    {
+        metrics = SectorStatistics::lapMetrics(speed, crossings);
+
+        QVector<qreal> sectorTimes;
+        for (int s(0); s < 4 * lapCount; ++s)
+            sectorTimes << metrics.at(s * SectorStatistics::MetricCount
+                                      + SectorStatistics::SectorTime);
+
+        times = Distribution::of(sectorTimes);
+    }
+
+    QCOMPARE(times.count, 4 * lapCount);
+    QVERIFY(metrics.at(SectorStatistics::MaxSpeed)
+            >= metrics.at(SectorStatistics::MinSpeed));
+}
+
+void HotPathBenchmark::sectorEditSession_data(void)
+{
+    QTest::addColumn<int>("sectorCount");
+
+    QTest::newRow("10 sectors") << 10;
+    QTest::newRow("30 sectors") << 30;
+}
+
+void HotPathBenchmark::sectorEditSession(void)
+{
+    QFETCH(int, sectorCount);
+
+    // Competition a part : ses secteurs ne dependent d'aucun autre benchmark
+    QString competition = QString("SectorEdit-%1").arg(sectorCount);
+
+    ImportModule importModule;
+    importModule.setInteractive(false);
+    QVERIFY(importModule.createCompetition(competition, WHEEL_PERIMETER,
+                                           "Synthetic circuit"));
+
+    TelemetryGenerator generator;
+    generator.setLapCount(1);
+    generator.setWheelPerimeter(WHEEL_PERIMETER);
+
+    QString dirName = QString("sector-edit-%1").arg(sectorCount);
+    QVERIFY(this->workingDir.mkpath(dirName));
+    QDir raceDir(this->workingDir.filePath(dirName));
+    QVERIFY(generator.writeRace(raceDir));
+
+    Race race(competition);
+    importModule.addRace(race, raceDir);
+    QVERIFY2(importModule.importSuceed(),
+             qPrintable(importModule.getErrorString()));
+
+    // Limites des secteurs : positions du tour importe
+    QSqlQuery positionQuery;
+    positionQuery.prepare("select POSITION.id from POSITION, RACE "
+                          "where POSITION.ref_lap_race = RACE.id "
+                          "and RACE.ref_compet = ? order by POSITION.id limit ?");
+    positionQuery.addBindValue(competition);
+    positionQuery.addBindValue(sectorCount + 1);
+    QVERIFY(positionQuery.exec());
+
+    QList<int> positions;
+    while (positionQuery.next())
+        positions << positionQuery.value(0).toInt();
+
+    QCOMPARE(positions.size(), sectorCount + 1);
+
+    SectorEditSession session(competition);
+    QVERIFY(session.load());
+
+    bool replayed(false), committed(false);
+
+    QBENCHMARK
+    {
+        // Un seul secteur sur tout le tour, puis une coupe par secteur
+        while (session.count() > 0)
+            session.removeSector(0);
+
+        session.insertSector(0, positions.first(), positions.last());
+        session.endStep();
+
+        for (int s(1); s < sectorCount; ++s)
+        {
+            session.removeSector(s - 1);
+            session.insertSector(s - 1, positions.at(s - 1), positions.at(s));
+            session.insertSector(s, positions.at(s), positions.last());
+            session.endStep();
+        }
+
+        replayed = session.undo() && session.redo();
+        committed = session.commit();
+    }
+
+    QVERIFY(replayed);
+    QVERIFY(committed);
+
+    QSqlQuery countQuery;
+    countQuery.prepare("select count(*) from SECTOR where ref_compet = ?");
+    countQuery.addBindValue(competition);
+    QVERIFY(countQuery.exec() && countQuery.next());
+    QCOMPARE(countQuery.value(0).toInt(), sectorCount);
+}
+
+QTEST_MAIN(HotPathBenchmark)
@@ -0,0 +1,97 @@
+#ifndef __HOTPATHBENCHMARK_HPP__
+#define __HOTPATHBENCHMARK_HPP__
+
+#include "TelemetryGenerator.hpp"
+#include "../Common/TelemetrySeries.hpp"
+#include "../DBModule/GeoCoordinate.hpp"
+#include <QtGui>
+#include <QtTest>
+
+/* Micro-benchmarks des chemins critiques de l'application.
+ *
+ * Toutes les donnees proviennent du TelemetryGenerator : les mesures sont
+ * reproductibles et comparables d'une revision a l'autre.
+ *
+ * Usage : ./benchmarks [-iterations n] [-callgrind | -tickcounter] [fonction]
+ */
+class HotPathBenchmark : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+
+        void initTestCase(void);
+        void cleanupTestCase(void);
+
+        void geoCoordinateParsing_data(void);
+        void geoCoordinateParsing(void);
+
+        void csvTableParsing_data(void);
+        void csvTableParsing(void);
+
+        void csvReaderBatches_data(void);
+        void csvReaderBatches(void);
+
+        void importModuleBatchInsert_data(void);
+        void importModuleBatchInsert(void);
+
+        void megaSquirtImport_data(void);
+        void megaSquirtImport(void);
+
+        void lapDetector_data(void);
+        void lapDetector(void);
+
+        void raceNumLap_data(void);
+        void raceNumLap(void);
+
+        void plotCurveConstruction_data(void);
+        void plotCurveConstruction(void);
+
+        void plotSceneProgressiveCurve_data(void);
+        void plotSceneProgressiveCurve(void);
+
+        void mapSceneAddTrack_data(void);
+        void mapSceneAddTrack(void);
+
+        void mapSceneHeatTrack_data(void);
+        void mapSceneHeatTrack(void);
+
+        void highlightScrubbing_data(void);
+        void highlightScrubbing(void);
+
+        void replayFrames_data(void);
+        void replayFrames(void);
+
+        void trackSimplification_data(void);
+        void trackSimplification(void);
+
+        void densityRaster_data(void);
+        void densityRaster(void);
+
+        void sectorShape_data(void);
+        void sectorShape(void);
+
+        void lapResampling_data(void);
+        void lapResampling(void);
+
+        void sectorCrossings_data(void);
+        void sectorCrossings(void);
+
+        void sectorStatistics_data(void);
+        void sectorStatistics(void);
+
+        void sectorEditSession_data(void);
+        void sectorEditSession(void);
+
+    private:
+
+        void addLapCountColumn(void);
+        QVector<GeoCoordinate> validCoordinates(TelemetryGenerator& generator) const;
+        TelemetrySeries projectedTrack(TelemetryGenerator& generator) const;
+        TelemetrySeries timeSpeedSeries(TelemetryGenerator& generator) const;
+
+        QDir workingDir;
+        QString competition;
+};
+
+#endif /* __HOTPATHBENCHMARK_HPP__ */
@@ -0,0 +1,423 @@
+#include "TelemetryGenerator.hpp"
+#include <qmath.h>
+
+namespace
+{
+    const qreal METERS_PER_DEGREE = 111320.0;
+    const qreal MPS_TO_KNOTS      = 1.943844;
+    const qreal SPEED_VARIATION   = 0.3; // amplitude relative de la variation de vitesse sur un tour
+    const qreal INTEGRATION_STEP  = 0.002; // pas d'integration de la distance (s)
+}
+
+TelemetryGenerator::TelemetryGenerator(quint32 seed) :
+    _seed(seed == 0 ? 1 : seed), _state(_seed), _lapCount(5),
+    _lapDuration(120), _radius(250), _gpsRate(10), _wheelPerimeter(1.5),
+    _positionNoise(0), _tickJitter(0), _dropoutRate(0), _dropoutLength(1),
+    _originLatitude(50.4496), _originLongitude(4.4520),
+    _start(QDate(2013, 5, 16), QTime(10, 0), Qt::UTC), _engineRate(50),
+    _engineChannels(100)
+{
+}
+
+void TelemetryGenerator::setLapCount(int count)
+{
+    this->_lapCount = qMax(1, count);
+}
+
+void TelemetryGenerator::setLapDuration(qreal seconds)
+{
+    if (seconds > 0)
+        this->_lapDuration = seconds;
+}
+
+void TelemetryGenerator::setCircuitRadius(qreal meters)
+{
+    if (meters > 0)
+        this->_radius = meters;
+}
+
+void TelemetryGenerator::setGpsRate(qreal hertz)
+{
+    if (hertz > 0)
+        this->_gpsRate = hertz;
+}
+
+void TelemetryGenerator::setWheelPerimeter(qreal meters)
+{
+    if (meters > 0)
+        this->_wheelPerimeter = meters;
+}
+
+void TelemetryGenerator::setPositionNoise(qreal meters)
+{
+    this->_positionNoise = qMax(qreal(0), meters);
+}
+
+void TelemetryGenerator::setTickJitter(qreal seconds)
+{
+    this->_tickJitter = qMax(qreal(0), seconds);
+}
+
+void TelemetryGenerator::setDropoutRate(qreal probability)
+{
+    this->_dropoutRate = qBound(qreal(0), probability, qreal(1));
+}
+
+void TelemetryGenerator::setDropoutLength(int fixes)
+{
+    this->_dropoutLength = qMax(1, fixes);
+}
+
+void TelemetryGenerator::setOrigin(qreal latitude, qreal longitude)
+{
+    this->_originLatitude = latitude;
+    this->_originLongitude = longitude;
+}
+
+void TelemetryGenerator::setStartTime(const QDateTime& start)
+{
+    this->_start = start.toUTC();
+}
+
+void TelemetryGenerator::setEngineLogRate(qreal hertz)
+{
+    if (hertz > 0)
+        this->_engineRate = hertz;
+}
+
+void TelemetryGenerator::setEngineChannelCount(int count)
+{
+    // Time et les cinq canaux nommes sont toujours presents
+    this->_engineChannels = qMax(6, count);
+}
+
+int TelemetryGenerator::lapCount(void) const
+{
+    return this->_lapCount;
+}
+
+qreal TelemetryGenerator::wheelPerimeter(void) const
+{
+    return this->_wheelPerimeter;
+}
+
+QStringList TelemetryGenerator::gpsFrames(void)
+{
+    this->resetRandom();
+
+    QStringList frames;
+    int nbFixes = qFloor(this->duration() * this->_gpsRate) + 1;
+    qreal latScale = METERS_PER_DEGREE;
+    qreal lonScale = METERS_PER_DEGREE * qCos(this->_originLatitude * M_PI / 180);
+    int dropoutRemaining(0);
+    QPointF previous = this->positionAt(0);
+
+    for (int i(0); i < nbFixes; ++i)
+    {
+        qreal t = i / this->_gpsRate;
+        QPointF exact = this->positionAt(t);
+
+        // Vitesse et cap a partir de la position exacte precedente
+        QLineF move(previous, exact);
+        qreal speed = (i == 0) ? 0 : move.length() * this->_gpsRate;
+        qreal course = qFloor(90 - move.angle() + 360) % 360;
+        previous = exact;
+
+        QPointF noisy = exact;
+        if (this->_positionNoise > 0)
+            noisy += QPointF(this->gaussian(), this->gaussian()) * this->_positionNoise;
+
+        if (dropoutRemaining == 0 && this->uniform() < this->_dropoutRate)
+            dropoutRemaining = this->_dropoutLength;
+
+        bool valid = dropoutRemaining == 0;
+        if (dropoutRemaining > 0)
+            dropoutRemaining--;
+
+        qreal latitude  = this->_originLatitude  + noisy.y() / latScale;
+        qreal longitude = this->_originLongitude + noisy.x() / lonScale;
+        QString stamp = "," + QString::number(this->epochNanoseconds(t));
+
+        frames << this->ggaFrame(t, latitude, longitude, valid) + stamp;
+        frames << this->rmcFrame(t, latitude, longitude, speed, course, valid)
+                  + stamp;
+    }
+
+    return frames;
+}
+
+QList<qint64> TelemetryGenerator::wheelTicks(void)
+{
+    this->resetRandom();
+
+    QList<qint64> ticks;
+    qreal total = this->duration();
+    qreal travelled(0);
+    qreal nextTick(0);
+    qint64 lastStamp(-1);
+    QPointF previous = this->positionAt(0);
+
+    for (qreal t(INTEGRATION_STEP); t <= total; t += INTEGRATION_STEP)
+    {
+        QPointF current = this->positionAt(t);
+        qreal step = QLineF(previous, current).length();
+        previous = current;
+
+        // Interpolation lineaire de l'instant de chaque tour de roue
+        while (step > 0 && travelled + step >= nextTick)
+        {
+            qreal ratio = (nextTick - travelled) / step;
+            qreal tickTime = t - INTEGRATION_STEP * (1 - ratio);
+
+            if (this->_tickJitter > 0)
+                tickTime += this->gaussian() * this->_tickJitter;
+
+            qint64 stamp = qMax(this->epochNanoseconds(tickTime), lastStamp + 1000);
+            ticks << stamp;
+            lastStamp = stamp;
+            nextTick += this->_wheelPerimeter;
+        }
+
+        travelled += step;
+    }
+
+    return ticks;
+}
+
+QList< QPair<QTime, QTime> > TelemetryGenerator::laps(void) const
+{
+    QList< QPair<QTime, QTime> > result;
+
+    for (int i(0); i < this->_lapCount; ++i)
+    {
+        qint64 start = this->epochNanoseconds(i * this->_lapDuration);
+        qint64 end = this->epochNanoseconds((i + 1) * this->_lapDuration);
+
+        result << QPair<QTime, QTime>(
+                      QDateTime::fromMSecsSinceEpoch(start / 1000000).time(),
+                      QDateTime::fromMSecsSinceEpoch(end / 1000000).time());
+    }
+
+    return result;
+}
+
+bool TelemetryGenerator::writeRace(const QDir& dir, const QString& gpsFilename,
+                                   const QString& speedFilename)
+{
+    QFile gpsFile(dir.filePath(gpsFilename));
+    QFile speedFile(dir.filePath(speedFilename));
+
+    if (!gpsFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        !speedFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QTextStream gpsOut(&gpsFile);
+    foreach (const QString& frame, this->gpsFrames())
+        gpsOut << frame << '\n';
+
+    QTextStream speedOut(&speedFile);
+    foreach (qint64 tick, this->wheelTicks())
+        speedOut << tick << '\n';
+
+    return true;
+}
+
+bool TelemetryGenerator::writeEngineLog(const QDir& dir, const QString& filename)
+{
+    QFile logFile(dir.filePath(filename));
+
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    this->resetRandom();
+
+    // Le log demarre avec la course, en heure locale comme les tours
+    QDateTime capture = QDateTime::fromMSecsSinceEpoch(
+                this->_start.toMSecsSinceEpoch());
+
+    QByteArray out;
+    out += "\"MS2Extra comms342h2: TelemetryGenerator\"\n";
+    out += "\"Capture Date: "
+        + capture.toString("ddd MMM d hh:mm:ss yyyy").toLatin1() + "\"\n";
+
+    QList<QByteArray> names, units;
+    names << "Time" << "RPM" << "Batt V" << "PW" << "Gammae" << "Gair";
+    units << "s" << "RPM" << "V" << "ms" << "%" << "%";
+
+    for (int c(names.size()); c < this->_engineChannels; ++c)
+    {
+        names << "Ch" + QByteArray::number(c);
+        units << "";
+    }
+
+    for (int c(0); c < names.size(); ++c)
+        out += names.at(c) + (c + 1 < names.size() ? '\t' : '\n');
+    for (int c(0); c < units.size(); ++c)
+        out += units.at(c) + (c + 1 < units.size() ? '\t' : '\n');
+
+    int nbRows = qFloor(this->duration() * this->_engineRate) + 1;
+
+    for (int i(0); i < nbRows; ++i)
+    {
+        qreal t = i / this->_engineRate;
+        qreal load = 1 + SPEED_VARIATION * qCos(2 * M_PI * t / this->_lapDuration);
+
+        out += QByteArray::number(t, 'f', 3);
+        out += '\t' + QByteArray::number(1500 + 2500 * load + 20 * this->gaussian(), 'f', 0);
+        out += '\t' + QByteArray::number(12.6 + 0.05 * this->gaussian(), 'f', 2);
+        out += '\t' + QByteArray::number(2 + 1.5 * load, 'f', 3);
+        out += '\t' + QByteArray::number(100 + this->gaussian(), 'f', 1);
+        out += '\t' + QByteArray::number(95 + this->gaussian(), 'f', 1);
+
+        for (int c(6); c < this->_engineChannels; ++c)
+            out += '\t' + QByteArray::number(c * load, 'f', 2);
+
+        out += '\n';
+
+        // Un marqueur manuel au milieu du log, comme dans MegaLogViewer
+        if (i == nbRows / 2)
+            out += "MARK 000 - Manual - " + capture.toString("hh:mm:ss").toLatin1() + "\n";
+
+        if (out.size() > 1024 * 1024)
+        {
+            logFile.write(out);
+            out.clear();
+        }
+    }
+
+    return logFile.write(out) == out.size();
+}
+
+QPointF TelemetryGenerator::circuitPoint(qreal progress) const
+{
+    qreal theta = 2 * M_PI * (progress - qFloor(progress));
+    qreal r = this->_radius * (1 + 0.25 * qCos(3 * theta));
+
+    return QPointF(r * qCos(theta), 0.6 * r * qSin(theta));
+}
+
+QPointF TelemetryGenerator::positionAt(qreal seconds) const
+{
+    return this->circuitPoint(this->progressAt(seconds));
+}
+
+qreal TelemetryGenerator::progressAt(qreal seconds) const
+{
+    /* Progression monotone : la derivee (1 + a.cos) / T reste strictement
+     * positive tant que a < 1, ce qui donne une vitesse variable par tour */
+    qreal laps = seconds / this->_lapDuration;
+    return laps + SPEED_VARIATION / (2 * M_PI) * qSin(2 * M_PI * laps);
+}
+
+qreal TelemetryGenerator::duration(void) const
+{
+    return this->_lapCount * this->_lapDuration;
+}
+
+qint64 TelemetryGenerator::epochNanoseconds(qreal seconds) const
+{
+    qint64 origin = this->_start.toMSecsSinceEpoch();
+    return origin * 1000000 + qRound64(seconds * 1e9);
+}
+
+QString TelemetryGenerator::latitudeField(qreal latitude) const
+{
+    qreal value = qAbs(latitude);
+    int degrees = qFloor(value);
+    qreal minutes = (value - degrees) * 60;
+
+    if (minutes >= 59.99995)
+    {
+        degrees++;
+        minutes = 0;
+    }
+
+    return QString("%1").arg(degrees, 2, 10, QChar('0'))
+            + QString::number(minutes, 'f', 4).rightJustified(7, '0')
+            + (latitude < 0 ? ",S" : ",N");
+}
+
+QString TelemetryGenerator::longitudeField(qreal longitude) const
+{
+    qreal value = qAbs(longitude);
+    int degrees = qFloor(value);
+    qreal minutes = (value - degrees) * 60;
+
+    if (minutes >= 59.99995)
+    {
+        degrees++;
+        minutes = 0;
+    }
+
+    return QString("%1").arg(degrees, 3, 10, QChar('0'))
+            + QString::number(minutes, 'f', 4).rightJustified(7, '0')
+            + (longitude < 0 ? ",W" : ",E");
+}
+
+QString TelemetryGenerator::ggaFrame(qreal seconds, qreal latitude,
+                                     qreal longitude, bool valid) const
+{
+    QDateTime utc = this->_start.addMSecs(qRound64(seconds * 1000));
+    QString sentence = "GPGGA," + utc.toString("hhmmss.zzz").left(9) + ","
+            + this->latitudeField(latitude) + ","
+            + this->longitudeField(longitude) + ","
+            + (valid ? "1" : "0") + ",08,0.9,120.0,M,46.9,M,,";
+
+    return withChecksum(sentence);
+}
+
+QString TelemetryGenerator::rmcFrame(qreal seconds, qreal latitude,
+                                     qreal longitude, qreal speed,
+                                     qreal course, bool valid) const
+{
+    QDateTime utc = this->_start.addMSecs(qRound64(seconds * 1000));
+    QString sentence = "GPRMC," + utc.toString("hhmmss.zzz").left(9) + ","
+            + (valid ? "A" : "V") + ","
+            + this->latitudeField(latitude) + ","
+            + this->longitudeField(longitude) + ","
+            + QString::number(speed * MPS_TO_KNOTS, 'f', 2) + ","
+            + QString::number(course, 'f', 1) + ","
+            + utc.toString("ddMMyy") + ",,,A";
+
+    return withChecksum(sentence);
+}
+
+QString TelemetryGenerator::withChecksum(const QString& sentence)
+{
+    QByteArray raw = sentence.toLatin1();
+    quint8 checksum(0);
+
+    for (int i(0); i < raw.size(); ++i)
+        checksum ^= quint8(raw.at(i));
+
+    return "$" + sentence + "*"
+            + QString("%1").arg(checksum, 2, 16, QChar('0')).toUpper();
+}
+
+void TelemetryGenerator::resetRandom(void)
+{
+    this->_state = this->_seed;
+}
+
+quint32 TelemetryGenerator::nextRandom(void)
+{
+    // xorshift32 : independant de l'implementation de qrand()
+    this->_state ^= this->_state << 13;
+    this->_state ^= this->_state >> 17;
+    this->_state ^= this->_state << 5;
+    return this->_state;
+}
+
+qreal TelemetryGenerator::uniform(void)
+{
+    return (this->nextRandom() >> 8) / qreal(1 << 24);
+}
+
+qreal TelemetryGenerator::gaussian(void)
+{
+    // Box-Muller
+    qreal u1 = qMax(this->uniform(), qreal(1e-12));
+    qreal u2 = this->uniform();
+
+    return qSqrt(-2 * qLn(u1)) * qCos(2 * M_PI * u2);
+}
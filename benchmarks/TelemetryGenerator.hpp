@@ -0,0 +1,93 @@
+#ifndef __TELEMETRYGENERATOR_HPP__
+#define __TELEMETRYGENERATOR_HPP__
+
+#include <QtCore>
+
+/* Generateur deterministe de donnees de course synthetiques.
+ *
+ * Le vehicule parcourt N tours d'un circuit parametrique (trefle deforme)
+ * avec une vitesse variable le long du tour. Le generateur produit :
+ *  - les trames NMEA GGA/RMC telles qu'ecrites par le module GPS, suivies
+ *    du timestamp d'acquisition en nanosecondes depuis l'epoque ;
+ *  - le log des tops roue (un timestamp en nanosecondes par tour de roue) ;
+ *  - un log moteur MegaSquirt (.msl, MegaLogViewer) a frequence elevee.
+ *
+ * Pour une meme graine et une meme configuration, la sortie est identique
+ * d'une execution et d'une plateforme a l'autre.
+ */
+class TelemetryGenerator
+{
+    public:
+
+        explicit TelemetryGenerator(quint32 seed = 2013);
+
+        // Setters
+        void setLapCount(int count);
+        void setLapDuration(qreal seconds);
+        void setCircuitRadius(qreal meters);
+        void setGpsRate(qreal hertz);
+        void setWheelPerimeter(qreal meters);
+        void setPositionNoise(qreal meters);
+        void setTickJitter(qreal seconds);
+        void setDropoutRate(qreal probability);
+        void setDropoutLength(int fixes);
+        void setOrigin(qreal latitude, qreal longitude);
+        void setStartTime(const QDateTime& start);
+        void setEngineLogRate(qreal hertz);
+        void setEngineChannelCount(int count);
+
+        // Getters
+        int lapCount(void) const;
+        qreal wheelPerimeter(void) const;
+
+        // Generation
+        QStringList gpsFrames(void);
+        QList<qint64> wheelTicks(void);
+        QList< QPair<QTime, QTime> > laps(void) const;
+
+        bool writeRace(const QDir& dir, const QString& gpsFilename = "gps",
+                       const QString& speedFilename = "speed");
+        bool writeEngineLog(const QDir& dir,
+                            const QString& filename = "megasquirt.msl");
+
+    protected:
+
+        QPointF circuitPoint(qreal progress) const;
+        QPointF positionAt(qreal seconds) const;
+        qreal progressAt(qreal seconds) const;
+        qreal duration(void) const;
+        qint64 epochNanoseconds(qreal seconds) const;
+
+        QString latitudeField(qreal latitude) const;
+        QString longitudeField(qreal longitude) const;
+        QString ggaFrame(qreal seconds, qreal latitude, qreal longitude,
+                         bool valid) const;
+        QString rmcFrame(qreal seconds, qreal latitude, qreal longitude,
+                         qreal speed, qreal course, bool valid) const;
+        static QString withChecksum(const QString& sentence);
+
+        void resetRandom(void);
+        quint32 nextRandom(void);
+        qreal uniform(void);
+        qreal gaussian(void);
+
+        quint32 _seed;
+        quint32 _state;
+
+        int   _lapCount;
+        qreal _lapDuration;
+        qreal _radius;
+        qreal _gpsRate;
+        qreal _wheelPerimeter;
+        qreal _positionNoise;
+        qreal _tickJitter;
+        qreal _dropoutRate;
+        int   _dropoutLength;
+        qreal _originLatitude;
+        qreal _originLongitude;
+        QDateTime _start;
+        qreal _engineRate;
+        int   _engineChannels;
+};
+
+#endif /* __TELEMETRYGENERATOR_HPP__ */
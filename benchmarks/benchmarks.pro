@@ -0,0 +1,108 @@
+#-------------------------------------------------
+#
+# Benchmarks des chemins critiques d'EcoManager2013
+#
+#-------------------------------------------------
+
+QT       += core gui sql testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
+
+TARGET = benchmarks
+TEMPLATE = app
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += HotPathBenchmark.cpp \
+    TelemetryGenerator.cpp \
+    ../Common/IndexedPosition.cpp \
+    ../Common/TelemetrySeries.cpp \
+    ../Common/LapResampler.cpp \
+    ../Common/CoordinateItem.cpp \
+    ../Common/HighlightItem.cpp \
+    ../Common/ColorPicker.cpp \
+    ../Map/MapView.cpp \
+    ../Map/SectorItem.cpp \
+    ../Map/SectorGeometry.cpp \
+    ../Map/AnimateSectorItem.cpp \
+    ../Map/TrackItem.cpp \
+    ../Map/HeatTrackItem.cpp \
+    ../Map/DensityRaster.cpp \
+    ../Map/TrackGeometry.cpp \
+    ../Map/TrackPathItem.cpp \
+    ../Map/TickItem.cpp \
+    ../Map/PathBuilder.cpp \
+    ../Map/MapScene.cpp \
+    ../DBModule/GeoCoordinate.cpp \
+    ../DBModule/DataPoint.cpp \
+    ../DBModule/Zone.cpp \
+    ../DBModule/Race.cpp \
+    ../DBModule/LapDetector.cpp \
+    ../DBModule/LapChannel.cpp \
+    ../DBModule/ChannelRegistry.cpp \
+    ../DBModule/ChannelStore.cpp \
+    ../DBModule/LapSeries.cpp \
+    ../DBModule/SectorTiming.cpp \
+    ../DBModule/SectorStatistics.cpp \
+    ../DBModule/SectorEditSession.cpp \
+    ../DBModule/ImportModule.cpp \
+    ../ExtensibleEllipseItem.cpp \
+    ../RaceViewer.cpp \
+    ../Plot/CurveGeometry.cpp \
+    ../Plot/PlotCurve.cpp \
+    ../Plot/PlotScene.cpp \
+    ../Utils/QException.cpp \
+    ../Utils/DataBaseManager.cpp \
+    ../Utils/QCSVTable.cpp \
+    ../Utils/QCSVReader.cpp \
+    ../Utils/Trace.cpp \
+    ../Utils/Log.cpp
+
+HEADERS  += HotPathBenchmark.hpp \
+    TelemetryGenerator.hpp \
+    ../Common/IndexedPosition.hpp \
+    ../Common/TelemetrySeries.hpp \
+    ../Common/LapResampler.hpp \
+    ../Common/CoordinateItem.hpp \
+    ../Common/HighlightItem.hpp \
+    ../Common/ColorPicker.hpp \
+    ../Map/MapView.hpp \
+    ../Map/SectorItem.hpp \
+    ../Map/SectorGeometry.hpp \
+    ../Map/AnimateSectorItem.hpp \
+    ../Map/TrackItem.hpp \
+    ../Map/HeatTrackItem.hpp \
+    ../Map/DensityRaster.hpp \
+    ../Map/TrackGeometry.hpp \
+    ../Map/TrackPathItem.hpp \
+    ../Map/TickItem.hpp \
+    ../Map/PathBuilder.hpp \
+    ../Map/MapScene.hpp \
+    ../DBModule/GeoCoordinate.hpp \
+    ../DBModule/DataPoint.hpp \
+    ../DBModule/Zone.hpp \
+    ../DBModule/Race.hpp \
+    ../DBModule/LapDetector.hpp \
+    ../DBModule/LapChannel.hpp \
+    ../DBModule/ChannelRegistry.hpp \
+    ../DBModule/ChannelStore.hpp \
+    ../DBModule/LapSeries.hpp \
+    ../DBModule/SectorTiming.hpp \
+    ../DBModule/SectorStatistics.hpp \
+    ../DBModule/SectorEditSession.hpp \
+    ../DBModule/ImportModule.hpp \
+    ../ExtensibleEllipseItem.hpp \
+    ../RaceViewer.hpp \
+    ../Plot/CurveGeometry.hpp \
+    ../Plot/PlotCurve.hpp \
+    ../Plot/PlotScene.hpp \
+    ../Utils/QException.hpp \
+    ../Utils/DataBaseManager.hpp \
+    ../Utils/QCSVParser.hpp \
+    ../Utils/QCSVTable.hpp \
+    ../Utils/QCSVReader.hpp \
+    ../Utils/Trace.hpp \
+    ../Utils/Log.hpp
@@ -1,4 +1,6 @@
 #include "MainWindow.hpp"
+#include "Utils/Log.hpp"
+#include "Utils/Trace.hpp"
 #include <QApplication>
 
 int main(int argc, char *argv[])
@@ -11,8 +13,22 @@ int main(int argc, char *argv[])
     translator.load(QString("qt_") + locale, QLibraryInfo::location(QLibraryInfo::TranslationsPath));
     app.installTranslator(&translator);
 
+    // ECOMANAGER_LOG="gps.debug=true;import.debug=true" : messages de debug
+    LogCategory::setFilterRules(QProcessEnvironment::systemEnvironment().value("ECOMANAGER_LOG"));
+
+    // ECOMANAGER_TRACE=fichier.json : trace Chrome ecrite a la fermeture
+    QString tracePath = QProcessEnvironment::systemEnvironment().value("ECOMANAGER_TRACE");
+    Trace::setEnabled(!tracePath.isEmpty());
+
     MainWindow w;
     w.show();
     
-    return app.exec();
+    int rc = app.exec();
+
+    if (Trace::isEnabled())
+        Trace::dump(tracePath);
+
+    Trace::release();
+
+    return rc;
 }